@@ -14,6 +14,9 @@
 
 namespace CubbyFlow
 {
+	//! Arrays with at least this many elements are initialized in parallel.
+	constexpr size_t ARRAY_PARALLEL_INIT_MIN_SIZE = 1 << 16;
+
 	//!
 	//! \brief Generic N-dimensional array class interface.
 	//!
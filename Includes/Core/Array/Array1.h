@@ -11,6 +11,7 @@
 #define CUBBYFLOW_ARRAY1_H
 
 #include <Core/Array/Array.h>
+#include <Core/Array/ArrayAllocator.h>
 #include <Core/Array/ArrayAccessor1.h>
 
 #include <vector>
@@ -30,7 +31,7 @@ namespace CubbyFlow
 	class Array<T, 1> final
 	{
 	public:
-		using ContainerType = std::vector<T>;
+		using ContainerType = std::vector<T, ArrayAllocator<T>>;
 		using Iterator = typename ContainerType::iterator;
 		using ConstIterator = typename ContainerType::const_iterator;
 
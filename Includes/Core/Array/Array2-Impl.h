@@ -10,6 +10,9 @@
 #ifndef CUBBYFLOW_ARRAY2_IMPL_H
 #define CUBBYFLOW_ARRAY2_IMPL_H
 
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
 #include <algorithm>
 #include <cassert>
 
@@ -64,8 +67,14 @@ namespace CubbyFlow
 	void Array<T, 2>::Set(const Array& other)
 	{
 		m_data.resize(other.m_data.size());
-		std::copy(other.m_data.begin(), other.m_data.end(), m_data.begin());
 		m_size = other.m_size;
+
+		// Copy rows with the partition of ParallelForEachIndex
+		const size_t rowSize = m_size.x;
+		ParallelFor(ZERO_SIZE, m_size.y, [&](size_t j)
+		{
+			std::copy(other.m_data.begin() + j * rowSize, other.m_data.begin() + (j + 1) * rowSize, m_data.begin() + j * rowSize);
+		}, m_data.size() >= ARRAY_PARALLEL_INIT_MIN_SIZE ? ExecutionPolicy::Parallel : ExecutionPolicy::Serial);
 	}
 
 	template <typename T>
@@ -103,18 +112,21 @@ namespace CubbyFlow
 	void Array<T, 2>::Resize(const Size2& size, const T& initVal)
 	{
 		Array grid;
-		grid.m_data.resize(size.x * size.y, initVal);
+		grid.m_data.resize(size.x * size.y);
 		grid.m_size = size;
 		
 		size_t iMin = std::min(size.x, m_size.x);
 		size_t jMin = std::min(size.y, m_size.y);
-		for (size_t j = 0; j < jMin; ++j)
+
+		// Initialize rows with the partition of ParallelForEachIndex, so the
+		// pages are first touched by the threads that will process them.
+		ParallelFor(ZERO_SIZE, size.y, [&](size_t j)
 		{
-			for (size_t i = 0; i < iMin; ++i)
+			for (size_t i = 0; i < size.x; ++i)
 			{
-				grid(i, j) = At(i, j);
+				grid(i, j) = (i < iMin && j < jMin) ? At(i, j) : initVal;
 			}
-		}
+		}, grid.m_data.size() >= ARRAY_PARALLEL_INIT_MIN_SIZE ? ExecutionPolicy::Parallel : ExecutionPolicy::Serial);
 
 		Swap(grid);
 	}
@@ -11,6 +11,7 @@
 #define CUBBYFLOW_ARRAY2_H
 
 #include <Core/Array/Array.h>
+#include <Core/Array/ArrayAllocator.h>
 #include <Core/Array/ArrayAccessor2.h>
 #include <Core/Size/Size2.h>
 
@@ -43,7 +44,7 @@ namespace CubbyFlow
 	class Array<T, 2> final
 	{
 	public:
-		using ContainerType = std::vector<T>;
+		using ContainerType = std::vector<T, ArrayAllocator<T>>;
 		using Iterator = typename ContainerType::iterator;
 		using ConstIterator = typename ContainerType::const_iterator;
 
@@ -372,7 +373,7 @@ namespace CubbyFlow
 
 	private:
 		Size2 m_size;
-		std::vector<T> m_data;
+		ContainerType m_data;
 	};
 
 	//! Type alias for 2-D array.
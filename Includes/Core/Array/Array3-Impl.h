@@ -10,6 +10,9 @@
 #ifndef CUBBYFLOW_ARRAY3_IMPL_H
 #define CUBBYFLOW_ARRAY3_IMPL_H
 
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
 #include <algorithm>
 #include <cassert>
 
@@ -64,8 +67,14 @@ namespace CubbyFlow
 	void Array<T, 3>::Set(const Array& other)
 	{
 		m_data.resize(other.m_data.size());
-		std::copy(other.m_data.begin(), other.m_data.end(), m_data.begin());
 		m_size = other.m_size;
+
+		// Copy k-slabs with the partition of ParallelForEachIndex
+		const size_t slabSize = m_size.x * m_size.y;
+		ParallelFor(ZERO_SIZE, m_size.z, [&](size_t k)
+		{
+			std::copy(other.m_data.begin() + k * slabSize, other.m_data.begin() + (k + 1) * slabSize, m_data.begin() + k * slabSize);
+		}, m_data.size() >= ARRAY_PARALLEL_INIT_MIN_SIZE ? ExecutionPolicy::Parallel : ExecutionPolicy::Serial);
 	}
 
 	template <typename T>
@@ -110,23 +119,25 @@ namespace CubbyFlow
 	void Array<T, 3>::Resize(const Size3& size, const T& initVal)
 	{
 		Array grid;
-		grid.m_data.resize(size.x * size.y * size.z, initVal);
+		grid.m_data.resize(size.x * size.y * size.z);
 		grid.m_size = size;
 
 		size_t iMin = std::min(size.x, m_size.x);
 		size_t jMin = std::min(size.y, m_size.y);
 		size_t kMin = std::min(size.z, m_size.z);
 
-		for (size_t k = 0; k < kMin; ++k)
+		// Initialize k-slabs with the partition of ParallelForEachIndex, so
+		// the pages are first touched by the threads that will process them.
+		ParallelFor(ZERO_SIZE, size.z, [&](size_t k)
 		{
-			for (size_t j = 0; j < jMin; ++j)
+			for (size_t j = 0; j < size.y; ++j)
 			{
-				for (size_t i = 0; i < iMin; ++i)
+				for (size_t i = 0; i < size.x; ++i)
 				{
-					grid(i, j, k) = At(i, j, k);
+					grid(i, j, k) = (i < iMin && j < jMin && k < kMin) ? At(i, j, k) : initVal;
 				}
 			}
-		}
+		}, grid.m_data.size() >= ARRAY_PARALLEL_INIT_MIN_SIZE ? ExecutionPolicy::Parallel : ExecutionPolicy::Serial);
 
 		Swap(grid);
 	}
@@ -11,6 +11,7 @@
 #define CUBBYFLOW_ARRAY3_H
 
 #include <Core/Array/Array.h>
+#include <Core/Array/ArrayAllocator.h>
 #include <Core/Array/ArrayAccessor3.h>
 #include <Core/Size/Size3.h>
 
@@ -46,7 +47,7 @@ namespace CubbyFlow
 	class Array<T, 3> final
 	{
 	public:
-		using ContainerType = std::vector<T>;
+		using ContainerType = std::vector<T, ArrayAllocator<T>>;
 		using Iterator = typename ContainerType::iterator;
 		using ConstIterator = typename ContainerType::const_iterator;
 
@@ -413,7 +414,7 @@ namespace CubbyFlow
 
 	private:
 		Size3 m_size;
-		std::vector<T> m_data;
+		ContainerType m_data;
 	};
 
 	//! Type alias for 3-D array.
@@ -0,0 +1,159 @@
+/*************************************************************************
+> File Name: ArrayAllocator.h
+> Project Name: CubbyFlow
+> Purpose: Aligned, pooled allocator for the array storage.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_ARRAY_ALLOCATOR_H
+#define CUBBYFLOW_ARRAY_ALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace CubbyFlow
+{
+	//! Alignment of the array storage in bytes.
+	constexpr size_t ARRAY_ALIGNMENT = 64;
+
+	//! Blocks of at least this many bytes are recycled by the memory pool.
+	constexpr size_t ARRAY_POOL_MIN_BLOCK_BYTES = 1 << 20;
+
+	//! Alignment of the pooled blocks, which is the size of a huge page.
+	constexpr size_t ARRAY_POOL_BLOCK_ALIGNMENT = 1 << 21;
+
+	//!
+	//! \brief Aligned memory pool shared by the array storage.
+	//!
+	//! Every block is aligned to ARRAY_ALIGNMENT bytes. Blocks of at least
+	//! ARRAY_POOL_MIN_BLOCK_BYTES are rounded up to a size class (a quarter
+	//! step between powers of two). When pooling is enabled, they are kept in
+	//! a free list when released, so the temporaries that solvers resize every
+	//! time-step reuse the pages that were already faulted in. The cached
+	//! blocks stay allocated until Clear is called. On Linux, the large blocks
+	//! can also be advised to use transparent huge pages.
+	//!
+	//! The pool never writes to the blocks, so the pages of a fresh block are
+	//! placed by their first write, which Array2 and Array3 do with the
+	//! partition of their parallel loops. A recycled block is not placed
+	//! again; its pages stay where its previous user first touched them.
+	//!
+	class ArrayMemoryPool
+	{
+	public:
+		//! Allocates a block of \p bytes bytes.
+		static void* Allocate(size_t bytes);
+
+		//! Releases a block of \p bytes bytes allocated by Allocate.
+		static void Deallocate(void* ptr, size_t bytes);
+
+		//! Frees all the cached blocks.
+		static void Clear();
+
+		//! Returns true if the large blocks are recycled.
+		static bool GetIsPooling();
+
+		//! Enables or disables recycling of the large blocks. Default is false.
+		//! Disabling it frees all the cached blocks.
+		static void SetIsPooling(bool isPooling);
+
+		//! Returns the max number of bytes kept in the free lists.
+		static size_t GetMaxPooledBytes();
+
+		//! Sets the max number of bytes kept in the free lists. Default is 512 MB.
+		//! Blocks already in the free lists are kept until Clear is called.
+		static void SetMaxPooledBytes(size_t bytes);
+
+		//! Returns true if the large blocks are advised to use huge pages.
+		static bool GetIsUsingHugePages();
+
+		//!
+		//! \brief Enables or disables transparent huge pages for large blocks.
+		//!
+		//! This only affects the blocks allocated afterwards, and does nothing
+		//! on platforms without madvise(MADV_HUGEPAGE). Default is false.
+		//!
+		static void SetIsUsingHugePages(bool isUsing);
+
+		//! Returns the number of bytes currently kept in the free lists.
+		static size_t GetPooledBytes();
+
+		//! Returns the number of large blocks allocated from the system.
+		static size_t GetNumberOfFreshBlocks();
+
+		//! Returns the number of large blocks served from the free lists.
+		static size_t GetNumberOfRecycledBlocks();
+	};
+
+	//!
+	//! \brief Standard allocator that forwards to ArrayMemoryPool.
+	//!
+	//! Unlike std::allocator, it default-initializes the elements that a
+	//! container constructs without a value, so std::vector::resize(n) leaves
+	//! trivial elements unwritten. Array1, Array2 and Array3 only do that when
+	//! they overwrite every element right after, and their public functions
+	//! still value-initialize. Other users of ContainerType must do the same.
+	//!
+	//! \tparam T Value type.
+	//!
+	template <typename T>
+	class ArrayAllocator
+	{
+	public:
+		using value_type = T;
+		using is_always_equal = std::true_type;
+
+		ArrayAllocator() noexcept = default;
+
+		template <typename U>
+		ArrayAllocator(const ArrayAllocator<U>&) noexcept
+		{
+			// Do nothing
+		}
+
+		T* allocate(size_t n)
+		{
+			if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+			{
+				throw std::bad_array_new_length();
+			}
+
+			return static_cast<T*>(ArrayMemoryPool::Allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, size_t n) noexcept
+		{
+			ArrayMemoryPool::Deallocate(ptr, n * sizeof(T));
+		}
+
+		//! Default-initializes, so the caller can fill the elements in parallel.
+		template <typename U>
+		void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value)
+		{
+			::new (static_cast<void*>(ptr)) U;
+		}
+
+		template <typename U, typename... Args>
+		void construct(U* ptr, Args&&... args)
+		{
+			::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+		}
+	};
+
+	template <typename T, typename U>
+	bool operator==(const ArrayAllocator<T>&, const ArrayAllocator<U>&) noexcept
+	{
+		return true;
+	}
+
+	template <typename T, typename U>
+	bool operator!=(const ArrayAllocator<T>&, const ArrayAllocator<U>&) noexcept
+	{
+		return false;
+	}
+}
+
+#endif
@@ -10,6 +10,7 @@
 #ifndef CUBBYFLOW_VOLUME_GRID_EMITTER3_H
 #define CUBBYFLOW_VOLUME_GRID_EMITTER3_H
 
+#include <Core/Array/Array3.h>
 #include <Core/Emitter/GridEmitter3.h>
 #include <Core/Grid/ScalarGrid3.h>
 #include <Core/Grid/VectorGrid3.h>
@@ -97,6 +98,15 @@ namespace CubbyFlow
 		using ScalarTarget = std::tuple<ScalarGrid3Ptr, ScalarMapper>;
 		using VectorTarget = std::tuple<VectorGrid3Ptr, VectorMapper>;
 
+		//! Signed distances of the source region at the points of a data layout.
+		struct SourceSDF
+		{
+			Size3 size;
+			Vector3D origin;
+			Vector3D gridSpacing;
+			Array3<double> data;
+		};
+
 		ImplicitSurface3Ptr m_sourceRegion;
 		bool m_isOneShot = true;
 		bool m_hasEmitted = false;
@@ -10,6 +10,10 @@
 #ifndef CUBBYFLOW_KDTREE_IMPL_H
 #define CUBBYFLOW_KDTREE_IMPL_H
 
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
+#include <algorithm>
 #include <numeric>
 
 namespace CubbyFlow
@@ -21,21 +25,20 @@ namespace CubbyFlow
 	}
 
 	template <typename T, size_t K>
-	void KdTree<T, K>::Node::InitLeaf(size_t it, const Point& pt)
+	void KdTree<T, K>::Node::InitLeaf(size_t begin, size_t end)
 	{
 		flags = K;
-		item = it;
 		child = std::numeric_limits<size_t>::max();
-		point = pt;
+		itemBegin = begin;
+		itemEnd = end;
 	}
 
 	template <typename T, size_t K>
-	void KdTree<T, K>::Node::InitInternal(size_t axis, size_t it, size_t c, const Point& pt)
+	void KdTree<T, K>::Node::InitInternal(size_t axis, T splitPosition, size_t c)
 	{
 		flags = axis;
-		item = it;
 		child = c;
-		point = pt;
+		split = splitPosition;
 	}
 
 	template <typename T, size_t K>
@@ -45,7 +48,8 @@ namespace CubbyFlow
 	}
 
 	template <typename T, size_t K>
-	KdTree<T, K>::KdTree()
+	KdTree<T, K>::KdTree(size_t maxLeafSize) :
+		m_maxLeafSize(std::max(maxLeafSize, ONE_SIZE))
 	{
 		// Do nothing
 	}
@@ -56,17 +60,45 @@ namespace CubbyFlow
 		m_points.resize(points.size());
 		std::copy(points.begin(), points.end(), m_points.begin());
 
+		m_nodes.clear();
+		m_bucketPoints.clear();
+		m_bucketItems.clear();
+
 		if (m_points.empty())
 		{
 			return;
 		}
 
-		m_nodes.clear();
+		m_bucketItems.resize(m_points.size());
+		std::iota(std::begin(m_bucketItems), std::end(m_bucketItems), 0);
+
+		// The node count of a subtree only depends on its number of items, so
+		// every subtree gets a fixed slot range and can be built independently.
+		std::unordered_map<size_t, size_t> numberOfNodes;
+		m_nodes.resize(CountNodes(m_points.size(), &numberOfNodes));
+
+		// Split the upper levels serially until there are a few subtrees per
+		// thread, then build the subtrees in parallel.
+		size_t deferDepth = 2;
+		for (unsigned int n = GetMaxNumberOfThreads(); n > 1; n /= 2)
+		{
+			++deferDepth;
+		}
 
-		std::vector<size_t> itemIndices(m_points.size());
-		std::iota(std::begin(itemIndices), std::end(itemIndices), 0);
+		std::vector<BuildTask> tasks;
+		Build(0, 0, m_points.size(), 0, deferDepth, numberOfNodes, &tasks);
 
-		Build(0, itemIndices.data(), m_points.size(), 0);
+		ParallelFor(ZERO_SIZE, tasks.size(), [&](size_t i)
+		{
+			const BuildTask& task = tasks[i];
+			Build(task.nodeIndex, task.begin, task.end, deferDepth, std::numeric_limits<size_t>::max(), numberOfNodes, nullptr);
+		});
+
+		m_bucketPoints.resize(m_points.size());
+		ParallelFor(ZERO_SIZE, m_points.size(), [&](size_t i)
+		{
+			m_bucketPoints[i] = m_points[m_bucketItems[i]];
+		});
 	}
 
 	template <typename T, size_t K>
@@ -74,6 +106,11 @@ namespace CubbyFlow
 		const Point& origin, T radius,
 		const std::function<void(size_t, const Point&)>& callback) const
 	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
 		const T r2 = radius * radius;
 
 		// prepare to traverse the tree for sphere
@@ -86,13 +123,16 @@ namespace CubbyFlow
 
 		while (node != nullptr)
 		{
-			if (node->item != std::numeric_limits<size_t>::max() && (node->point - origin).LengthSquared() <= r2)
-			{
-				callback(node->item, node->point);
-			}
-
 			if (node->IsLeaf())
 			{
+				for (size_t i = node->itemBegin; i < node->itemEnd; ++i)
+				{
+					if ((m_bucketPoints[i] - origin).LengthSquared() <= r2)
+					{
+						callback(m_bucketItems[i], m_bucketPoints[i]);
+					}
+				}
+
 				// grab next node to process from todo stack
 				if (todoPos > 0)
 				{
@@ -109,11 +149,11 @@ namespace CubbyFlow
 			{
 				// get node children pointers for sphere
 				const Node* firstChild = node + 1;
-				const Node* secondChild = const_cast<Node*>(&m_nodes[node->child]);
+				const Node* secondChild = &m_nodes[node->child];
 
 				// advance to next child node, possibly enqueue other child
 				const size_t axis = node->flags;
-				const T plane = node->point[axis];
+				const T plane = node->split;
 
 				if (plane - origin[axis] > radius)
 				{
@@ -135,73 +175,92 @@ namespace CubbyFlow
 	}
 
 	template <typename T, size_t K>
-	bool KdTree<T, K>::HasNearbyPoint(const Point& origin, T radius) const
+	void KdTree<T, K>::ForEachKNearestPoints(
+		const Point& origin, size_t k,
+		const std::function<void(size_t, const Point&)>& callback) const
 	{
-		const T r2 = radius * radius;
+		if (m_nodes.empty() || k == 0)
+		{
+			return;
+		}
 
-		// prepare to traverse the tree for sphere
+		// Bounded max-heap of (squared distance, bucket index) pairs, so the
+		// farthest of the current k candidates is always at the front.
+		std::vector<std::pair<T, size_t>> candidates;
+		candidates.reserve(std::min(k, m_points.size()));
+
+		// Each entry keeps the lower bound of the squared distance from the
+		// origin to the node's region.
 		static const int maxTreeDepth = 8 * sizeof(size_t);
-		const Node* todo[maxTreeDepth];
+		std::pair<const Node*, T> todo[maxTreeDepth + 1];
 		size_t todoPos = 0;
 
-		// traverse the tree nodes for sphere
-		const Node* node = m_nodes.data();
+		todo[todoPos++] = std::make_pair(m_nodes.data(), static_cast<T>(0));
 
-		while (node != nullptr)
+		while (todoPos > 0)
 		{
-			if (node->item != std::numeric_limits<size_t>::max() && (node->point - origin).LengthSquared() <= r2)
+			--todoPos;
+			const Node* node = todo[todoPos].first;
+			const T nodeDist2 = todo[todoPos].second;
+
+			if (candidates.size() == k && nodeDist2 > candidates.front().first)
 			{
-				return true;
+				continue;
 			}
 
 			if (node->IsLeaf())
 			{
-				// grab next node to process from todo stack
-				if (todoPos > 0)
-				{
-					// dequeue
-					--todoPos;
-					node = todo[todoPos];
-				}
-				else
+				for (size_t i = node->itemBegin; i < node->itemEnd; ++i)
 				{
-					break;
+					const T dist2 = (m_bucketPoints[i] - origin).LengthSquared();
+
+					if (candidates.size() < k)
+					{
+						candidates.emplace_back(dist2, i);
+						std::push_heap(candidates.begin(), candidates.end());
+					}
+					else if (dist2 < candidates.front().first)
+					{
+						std::pop_heap(candidates.begin(), candidates.end());
+						candidates.back() = std::make_pair(dist2, i);
+						std::push_heap(candidates.begin(), candidates.end());
+					}
 				}
 			}
 			else
 			{
-				// get node children pointers for sphere
-				const Node* firstChild = node + 1;
-				const Node* secondChild = const_cast<Node*>(&m_nodes[node->child]);
-
-				// advance to next child node, possibly enqueue other child
 				const size_t axis = node->flags;
-				const T plane = node->point[axis];
-				
-				if (origin[axis] < plane && plane - origin[axis] > radius)
-				{
-					node = firstChild;
-				}
-				else if (origin[axis] > plane && origin[axis] - plane > radius)
-				{
-					node = secondChild;
-				}
-				else
-				{
-					// enqueue secondChild in todo stack
-					todo[todoPos] = secondChild;
-					++todoPos;
-					node = firstChild;
-				}
+				const T diff = origin[axis] - node->split;
+				const Node* nearChild = (diff <= 0) ? node + 1 : &m_nodes[node->child];
+				const Node* farChild = (diff <= 0) ? &m_nodes[node->child] : node + 1;
+
+				// enqueue the far child first so that the near child is visited
+				// first and shrinks the search radius early
+				todo[todoPos] = std::make_pair(farChild, std::max(nodeDist2, diff * diff));
+				++todoPos;
+				todo[todoPos] = std::make_pair(nearChild, nodeDist2);
+				++todoPos;
 			}
 		}
 
-		return false;
+		std::sort_heap(candidates.begin(), candidates.end());
+
+		for (const auto& candidate : candidates)
+		{
+			callback(m_bucketItems[candidate.second], m_bucketPoints[candidate.second]);
+		}
 	}
 
 	template <typename T, size_t K>
-	size_t KdTree<T, K>::GetNearestPoint(const Point& origin) const
+	bool KdTree<T, K>::HasNearbyPoint(const Point& origin, T radius) const
 	{
+		if (m_nodes.empty())
+		{
+			return false;
+		}
+
+		const T r2 = radius * radius;
+
 		// prepare to traverse the tree for sphere
 		static const int maxTreeDepth = 8 * sizeof(size_t);
 		const Node* todo[maxTreeDepth];
@@ -209,24 +268,23 @@ namespace CubbyFlow
 
 		// traverse the tree nodes for sphere
 		const Node* node = m_nodes.data();
-		size_t nearest = 0;
-		T minDist2 = (node->point - origin).LengthSquared();
 
 		while (node != nullptr)
 		{
-			const T newDist2 = (node->point - origin).LengthSquared();
-			if (newDist2 <= minDist2)
-			{
-				nearest = node->item;
-				minDist2 = newDist2;
-			}
-
 			if (node->IsLeaf())
 			{
+				for (size_t i = node->itemBegin; i < node->itemEnd; ++i)
+				{
+					if ((m_bucketPoints[i] - origin).LengthSquared() <= r2)
+					{
+						return true;
+					}
+				}
+
 				// grab next node to process from todo stack
 				if (todoPos > 0)
 				{
-					// Dequeue
+					// dequeue
 					--todoPos;
 					node = todo[todoPos];
 				}
@@ -239,18 +297,17 @@ namespace CubbyFlow
 			{
 				// get node children pointers for sphere
 				const Node* firstChild = node + 1;
-				const Node* secondChild = static_cast<Node*>(&m_nodes[node->child]);
+				const Node* secondChild = &m_nodes[node->child];
 
 				// advance to next child node, possibly enqueue other child
 				const size_t axis = node->flags;
-				const T plane = node->point[axis];
-				const T minDist = std::sqrt(minDist2);
-				
-				if (plane - origin[axis] > minDist)
+				const T plane = node->split;
+
+				if (plane - origin[axis] > radius)
 				{
 					node = firstChild;
 				}
-				else if (origin[axis] - plane > minDist)
+				else if (origin[axis] - plane > radius)
 				{
 					node = secondChild;
 				}
@@ -264,6 +321,19 @@ namespace CubbyFlow
 			}
 		}
 
+		return false;
+	}
+
+	template <typename T, size_t K>
+	size_t KdTree<T, K>::GetNearestPoint(const Point& origin) const
+	{
+		size_t nearest = 0;
+
+		ForEachKNearestPoints(origin, 1, [&](size_t i, const Point&)
+		{
+			nearest = i;
+		});
+
 		return nearest;
 	}
 
@@ -323,24 +393,34 @@ namespace CubbyFlow
 	};
 
 	template <typename T, size_t K>
-	size_t KdTree<T, K>::Build(size_t nodeIndex, size_t* itemIndices, size_t nItems, size_t currentDepth)
+	size_t KdTree<T, K>::GetMaxLeafSize() const
+	{
+		return m_maxLeafSize;
+	}
+
+	template <typename T, size_t K>
+	void KdTree<T, K>::Build(
+		size_t nodeIndex, size_t begin, size_t end, size_t currentDepth, size_t deferDepth,
+		const std::unordered_map<size_t, size_t>& numberOfNodes, std::vector<BuildTask>* deferred)
 	{
-		// add a node
-		m_nodes.emplace_back();
+		const size_t nItems = end - begin;
 
 		// initialize leaf node if termination criteria met
-		if (nItems == 0)
+		if (nItems <= m_maxLeafSize)
 		{
-			m_nodes[nodeIndex].InitLeaf(std::numeric_limits<size_t>::max(), {});
-			return currentDepth + 1;
+			m_nodes[nodeIndex].InitLeaf(begin, end);
+			return;
 		}
-		if (nItems == 1)
+
+		// hand over the subtree to a parallel task
+		if (deferred != nullptr && currentDepth >= deferDepth)
 		{
-			m_nodes[nodeIndex].InitLeaf(itemIndices[0], m_points[itemIndices[0]]);
-			return currentDepth + 1;
+			deferred->push_back(BuildTask{ nodeIndex, begin, end });
+			return;
 		}
 
 		// choose which axis to split along
+		size_t* itemIndices = m_bucketItems.data() + begin;
 		BBox nodeBound;
 		for (size_t i = 0; i < nItems; ++i)
 		{
@@ -350,19 +430,37 @@ namespace CubbyFlow
 		size_t axis = static_cast<size_t>(d.DominantAxis());
 
 		// pick mid point
-		std::nth_element(itemIndices, itemIndices + nItems / 2, itemIndices + nItems,
+		const size_t midPoint = nItems / 2;
+		std::nth_element(itemIndices, itemIndices + midPoint, itemIndices + nItems,
 			[&](size_t a, size_t b)
 		{
 			return m_points[a][axis] < m_points[b][axis];
 		});
-		const size_t midPoint = nItems / 2;
 
 		// recursively initialize children nodes
-		const size_t d0 = Build(nodeIndex + 1, itemIndices, midPoint, currentDepth + 1);
-		m_nodes[nodeIndex].InitInternal(axis, itemIndices[midPoint], m_nodes.size(), m_points[itemIndices[midPoint]]);
-		const size_t d1 = Build(m_nodes[nodeIndex].child, itemIndices + midPoint + 1, nItems - midPoint - 1, currentDepth + 1);
+		const size_t rightChild = nodeIndex + 1 + numberOfNodes.at(midPoint);
+		m_nodes[nodeIndex].InitInternal(axis, m_points[itemIndices[midPoint]][axis], rightChild);
+		Build(nodeIndex + 1, begin, begin + midPoint, currentDepth + 1, deferDepth, numberOfNodes, deferred);
+		Build(rightChild, begin + midPoint, end, currentDepth + 1, deferDepth, numberOfNodes, deferred);
+	}
+
+	template <typename T, size_t K>
+	size_t KdTree<T, K>::CountNodes(size_t numItems, std::unordered_map<size_t, size_t>* numberOfNodes) const
+	{
+		const auto iter = numberOfNodes->find(numItems);
+		if (iter != numberOfNodes->end())
+		{
+			return iter->second;
+		}
+
+		size_t count = 1;
+		if (numItems > m_maxLeafSize)
+		{
+			count += CountNodes(numItems / 2, numberOfNodes) + CountNodes(numItems - numItems / 2, numberOfNodes);
+		}
 
-		return std::max(d0, d1);
+		(*numberOfNodes)[numItems] = count;
+		return count;
 	}
 }
 
@@ -13,9 +13,21 @@
 #include <Core/BoundingBox/BoundingBox.h>
 #include <Core/Vector/Vector.h>
 
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
 namespace CubbyFlow
 {
-	//! Generic k-d tree structure.
+	//!
+	//! \brief Generic k-d tree structure.
+	//!
+	//! Internal nodes split their items at the median along the dominant axis
+	//! of the items' bounding box. Leaf nodes hold a bucket of up to
+	//! maxLeafSize items, and the points of each bucket are stored contiguously
+	//! so that leaf visits stream through memory instead of chasing a node per
+	//! point. Subtrees are built in parallel.
+	//!
 	template <typename T, size_t K>
 	class KdTree final
 	{
@@ -33,20 +45,23 @@ namespace CubbyFlow
 			//! Note that left child index is this node index + 1.
 			size_t child = std::numeric_limits<size_t>::max();
 
-			//! Item index.
-			size_t item = std::numeric_limits<size_t>::max();
+			//! First bucket index of the items in the leaf.
+			size_t itemBegin = 0;
+
+			//! One past the last bucket index of the items in the leaf.
+			size_t itemEnd = 0;
 
-			//! Point stored in the node.
-			Point point;
+			//! Split position along the split axis.
+			T split = 0;
 
 			//! Default contructor.
 			Node();
 
 			//! Initializes leaf node.
-			void InitLeaf(size_t it, const Point& pt);
+			void InitLeaf(size_t begin, size_t end);
 
 			//! Initializes internal node.
-			void InitInternal(size_t axis, size_t it, size_t c, const Point& pt);
+			void InitInternal(size_t axis, T splitPosition, size_t c);
 
 			//! Returns true if leaf.
 			bool IsLeaf() const;
@@ -60,8 +75,8 @@ namespace CubbyFlow
 		using NodeIterator = typename NodeContainerType::iterator;
 		using ConstNodeIterator = typename NodeContainerType::const_iterator;
 
-		//! Constructs an empty kD-tree instance.
-		KdTree();
+		//! Constructs an empty kD-tree instance with given leaf bucket size.
+		explicit KdTree(size_t maxLeafSize = 16);
 
 		//! Builds internal acceleration structure for given points list.
 		void Build(const ConstArrayAccessor1<Point>& points);
@@ -78,6 +93,21 @@ namespace CubbyFlow
 			const Point& origin, T radius,
 			const std::function<void(size_t, const Point&)>& callback) const;
 
+		//!
+		//! \brief Invokes the callback function for the k nearest points around
+		//!        the origin.
+		//!
+		//! The points are visited in ascending order of distance from the origin.
+		//! If the tree has less than k points, every point is visited.
+		//!
+		//! \param[in]  origin   The origin position.
+		//! \param[in]  k        The number of points to visit.
+		//! \param[in]  callback The callback function.
+		//!
+		void ForEachKNearestPoints(
+			const Point& origin, size_t k,
+			const std::function<void(size_t, const Point&)>& callback) const;
+
 		//!
 		//! Returns true if there are any nearby points for given origin within
 		//! radius.
@@ -116,14 +146,31 @@ namespace CubbyFlow
 		//! Returns the immutable end iterator of the node.
 		ConstNodeIterator EndNode() const;
 
+		//! Returns the maximum number of items in a leaf bucket.
+		size_t GetMaxLeafSize() const;
+
 		//! Reserves memory space for this tree.
 		void Reserve(size_t numPoints, size_t numNodes);
 
 	private:
+		size_t m_maxLeafSize = 16;
 		std::vector<Point> m_points;
 		std::vector<Node> m_nodes;
+		std::vector<Point> m_bucketPoints;
+		std::vector<size_t> m_bucketItems;
+
+		struct BuildTask
+		{
+			size_t nodeIndex;
+			size_t begin;
+			size_t end;
+		};
+
+		void Build(
+			size_t nodeIndex, size_t begin, size_t end, size_t currentDepth, size_t deferDepth,
+			const std::unordered_map<size_t, size_t>& numberOfNodes, std::vector<BuildTask>* deferred);
 
-		size_t Build(size_t nodeIndex, size_t* itemIndices, size_t nItems, size_t currentDepth);
+		size_t CountNodes(size_t numItems, std::unordered_map<size_t, size_t>* numberOfNodes) const;
 	};
 }
 
@@ -10,17 +10,14 @@
 #ifndef CUBBYFLOW_OCTREE_IMPL_H
 #define CUBBYFLOW_OCTREE_IMPL_H
 
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
 #include <numeric>
 #include <stack>
 
 namespace CubbyFlow
 {
-	template <typename T>
-	bool Octree<T>::Node::IsLeaf() const
-	{
-		return firstChild == std::numeric_limits<size_t>::max();
-	}
-
 	template <typename T>
 	Octree<T>::Octree()
 	{
@@ -34,19 +31,170 @@ namespace CubbyFlow
 		// Reset items
 		m_maxDepth = maxDepth;
 		m_items = items;
-		m_nodes.clear();
+		m_nodeFirstChildren.clear();
+		m_nodeItemStarts.clear();
+		m_nodeItems.clear();
 
 		// Normalize bounding box
 		m_bbox = bound;
 		double maxEdgeLen = std::max({ m_bbox.GetWidth(), m_bbox.GetHeight(), m_bbox.GetDepth() });
 		m_bbox.upperCorner = m_bbox.lowerCorner + Vector3D(maxEdgeLen, maxEdgeLen, maxEdgeLen);
 
-		// Build
-		m_nodes.resize(1);
-		m_nodes[0].items.resize(m_items.size());
-		std::iota(m_nodes[0].items.begin(), m_nodes[0].items.end(), ZERO_SIZE);
+		// Build level by level, starting from the root which has every item.
+		// Nodes are numbered in breadth-first order, so the nodes of a level
+		// are contiguous and the leaf items can be appended level by level.
+		// Items of the n-th node of the level are levelItems[levelStarts[n]]
+		// to levelItems[levelStarts[n + 1] - 1].
+		std::vector<BoundingBox3D> levelBounds(1, m_bbox);
+		std::vector<size_t> levelStarts = { 0, m_items.size() };
+		std::vector<size_t> levelItems(m_items.size());
+		std::vector<size_t> levelOwners(m_items.size(), 0);
+		std::iota(levelItems.begin(), levelItems.end(), ZERO_SIZE);
+
+		m_nodeFirstChildren.push_back(std::numeric_limits<size_t>::max());
+
+		size_t levelFirstNode = 0;
+		for (size_t depth = 1; !levelBounds.empty(); ++depth)
+		{
+			const size_t numberOfLevelNodes = levelBounds.size();
+			const size_t childFirstNode = m_nodeFirstChildren.size();
+
+			// Assign children to the non-empty nodes above the max depth, and
+			// item offsets to the rest which become leaves.
+			std::vector<size_t> splitIndices(numberOfLevelNodes, std::numeric_limits<size_t>::max());
+			std::vector<size_t> leafStarts(numberOfLevelNodes);
+			size_t numberOfSplits = 0;
+			size_t numberOfLeafItems = m_nodeItems.size();
+
+			for (size_t n = 0; n < numberOfLevelNodes; ++n)
+			{
+				const size_t numberOfItems = levelStarts[n + 1] - levelStarts[n];
+
+				leafStarts[n] = numberOfLeafItems;
+				m_nodeItemStarts.push_back(numberOfLeafItems);
+
+				if (depth < m_maxDepth && numberOfItems > 0)
+				{
+					splitIndices[n] = numberOfSplits;
+					m_nodeFirstChildren[levelFirstNode + n] = childFirstNode + 8 * numberOfSplits;
+					++numberOfSplits;
+				}
+				else
+				{
+					numberOfLeafItems += numberOfItems;
+				}
+			}
+
+			m_nodeItems.resize(numberOfLeafItems);
+			m_nodeFirstChildren.resize(childFirstNode + 8 * numberOfSplits, std::numeric_limits<size_t>::max());
+
+			ParallelFor(ZERO_SIZE, numberOfLevelNodes, [&](size_t n)
+			{
+				if (splitIndices[n] == std::numeric_limits<size_t>::max())
+				{
+					std::copy(
+						levelItems.begin() + levelStarts[n], levelItems.begin() + levelStarts[n + 1],
+						m_nodeItems.begin() + leafStarts[n]);
+				}
+			});
+
+			// Test every item against the octants of its node. This is where
+			// most of the time goes, so it runs over the items, not the nodes.
+			std::vector<uint8_t> masks(levelItems.size(), 0);
+
+			ParallelFor(ZERO_SIZE, levelItems.size(), [&](size_t e)
+			{
+				const size_t owner = levelOwners[e];
+				if (splitIndices[owner] == std::numeric_limits<size_t>::max())
+				{
+					return;
+				}
+
+				const BoundingBox3D& ownerBound = levelBounds[owner];
+				const Vector3D midPoint = ownerBound.MidPoint();
+				uint8_t mask = 0;
+
+				for (int j = 0; j < 8; ++j)
+				{
+					if (testFunc(m_items[levelItems[e]], BoundingBox3D(ownerBound.Corner(j), midPoint)))
+					{
+						mask |= static_cast<uint8_t>(1 << j);
+					}
+				}
+
+				masks[e] = mask;
+			});
+
+			// Count the items of each child and distribute them in the original
+			// order, so the result does not depend on the number of threads.
+			std::vector<size_t> childStarts(8 * numberOfSplits + 1, 0);
+
+			ParallelFor(ZERO_SIZE, numberOfLevelNodes, [&](size_t n)
+			{
+				const size_t split = splitIndices[n];
+				if (split == std::numeric_limits<size_t>::max())
+				{
+					return;
+				}
+
+				for (size_t e = levelStarts[n]; e < levelStarts[n + 1]; ++e)
+				{
+					for (int j = 0; j < 8; ++j)
+					{
+						if (masks[e] & (1 << j))
+						{
+							++childStarts[8 * split + j + 1];
+						}
+					}
+				}
+			});
+
+			for (size_t k = 0; k < 8 * numberOfSplits; ++k)
+			{
+				childStarts[k + 1] += childStarts[k];
+			}
+
+			std::vector<BoundingBox3D> childBounds(8 * numberOfSplits);
+			std::vector<size_t> childItems(childStarts.back());
+			std::vector<size_t> childOwners(childStarts.back());
+
+			ParallelFor(ZERO_SIZE, numberOfLevelNodes, [&](size_t n)
+			{
+				const size_t split = splitIndices[n];
+				if (split == std::numeric_limits<size_t>::max())
+				{
+					return;
+				}
+
+				size_t cursors[8];
+				for (int j = 0; j < 8; ++j)
+				{
+					cursors[j] = childStarts[8 * split + j];
+					childBounds[8 * split + j] = BoundingBox3D(levelBounds[n].Corner(j), levelBounds[n].MidPoint());
+				}
 
-		Build(0, 1, m_bbox, testFunc);
+				for (size_t e = levelStarts[n]; e < levelStarts[n + 1]; ++e)
+				{
+					for (int j = 0; j < 8; ++j)
+					{
+						if (masks[e] & (1 << j))
+						{
+							childItems[cursors[j]] = levelItems[e];
+							childOwners[cursors[j]] = 8 * split + j;
+							++cursors[j];
+						}
+					}
+				}
+			});
+
+			levelFirstNode = childFirstNode;
+			levelBounds.swap(childBounds);
+			levelStarts.swap(childStarts);
+			levelItems.swap(childItems);
+			levelOwners.swap(childOwners);
+		}
+
+		m_nodeItemStarts.push_back(m_nodeItems.size());
 	}
 
 	template <typename T>
@@ -54,7 +202,9 @@ namespace CubbyFlow
 	{
 		m_maxDepth = 1;
 		m_items.clear();
-		m_nodes.clear();
+		m_nodeFirstChildren.clear();
+		m_nodeItemStarts.clear();
+		m_nodeItems.clear();
 		m_bbox = BoundingBox3D();
 	}
 
@@ -67,19 +217,25 @@ namespace CubbyFlow
 		best.distance = std::numeric_limits<double>::max();
 		best.item = nullptr;
 
+		if (m_nodeFirstChildren.empty())
+		{
+			return best;
+		}
+
 		// Prepare to traverse octree
-		std::stack<std::pair<const Node*, BoundingBox3D>> todo;
+		std::stack<std::pair<size_t, BoundingBox3D>> todo;
 
 		// Traverse octree nodes
-		const Node* node = m_nodes.data();
+		size_t node = 0;
 		BoundingBox3D bound = m_bbox;
 
-		while (node != nullptr)
+		while (true)
 		{
-			if (node->IsLeaf())
+			if (IsLeaf(node))
 			{
-				for (size_t itemIdx : node->items)
+				for (size_t i = m_nodeItemStarts[node]; i < m_nodeItemStarts[node + 1]; ++i)
 				{
+					const size_t itemIdx = m_nodeItems[i];
 					double d = distanceFunc(m_items[itemIdx], pt);
 					if (d < best.distance)
 					{
@@ -100,7 +256,7 @@ namespace CubbyFlow
 			}
 			else
 			{
-				using NodeDistBox = std::tuple<const Node*, double, BoundingBox3D>;
+				using NodeDistBox = std::tuple<size_t, double, BoundingBox3D>;
 
 				const double bestDistSqr = best.distance * best.distance;
 				std::array<NodeDistBox, 8> childDistSqrPairs;
@@ -108,7 +264,7 @@ namespace CubbyFlow
 				
 				for (int i = 0; i < 8; ++i)
 				{
-					const Node* child = &m_nodes[node->firstChild + i];
+					const size_t child = m_nodeFirstChildren[node] + i;
 					const auto childBound = BoundingBox3D(bound.Corner(i), midPoint);
 					Vector3D cp = childBound.Clamp(pt);
 					double distMinSqr = cp.DistanceSquaredTo(pt);
@@ -226,19 +382,21 @@ namespace CubbyFlow
 	template <typename T>
 	size_t Octree<T>::GetNumberOfNodes() const
 	{
-		return m_nodes.size();
+		return m_nodeFirstChildren.size();
 	}
 
 	template <typename T>
-	const std::vector<size_t>& Octree<T>::GetItemsAtNode(size_t nodeIdx) const
+	ConstArrayAccessor1<size_t> Octree<T>::GetItemsAtNode(size_t nodeIdx) const
 	{
-		return m_nodes[nodeIdx].items;
+		return ConstArrayAccessor1<size_t>(
+			m_nodeItemStarts[nodeIdx + 1] - m_nodeItemStarts[nodeIdx],
+			m_nodeItems.data() + m_nodeItemStarts[nodeIdx]);
 	}
 
 	template <typename T>
 	size_t Octree<T>::GetChildIndex(size_t nodeIdx, size_t childIdx) const
 	{
-		return m_nodes[nodeIdx].firstChild + childIdx;
+		return m_nodeFirstChildren[nodeIdx] + childIdx;
 	}
 
 	template <typename T>
@@ -254,43 +412,9 @@ namespace CubbyFlow
 	}
 
 	template <typename T>
-	void Octree<T>::Build(size_t nodeIdx, size_t depth, const BoundingBox3D& bound,
-		const BoxIntersectionTestFunc3<T>& testFunc)
+	bool Octree<T>::IsLeaf(size_t nodeIdx) const
 	{
-		if (depth < m_maxDepth && !m_nodes[nodeIdx].items.empty())
-		{
-			size_t firstChild = m_nodes[nodeIdx].firstChild = m_nodes.size();
-			m_nodes.resize(m_nodes[nodeIdx].firstChild + 8);
-
-			BoundingBox3D bboxPerNode[8];
-
-			for (int i = 0; i < 8; ++i)
-			{
-				bboxPerNode[i] = BoundingBox3D(bound.Corner(i), bound.MidPoint());
-			}
-
-			auto& currentItems = m_nodes[nodeIdx].items;
-			for (size_t i = 0; i < currentItems.size(); ++i)
-			{
-				size_t currentItem = currentItems[i];
-				for (int j = 0; j < 8; ++j)
-				{
-					if (testFunc(m_items[currentItem], bboxPerNode[j]))
-					{
-						m_nodes[firstChild + j].items.push_back(currentItem);
-					}
-				}
-			}
-
-			// Remove non-leaf data
-			currentItems.clear();
-
-			// Refine
-			for (int i = 0; i < 8; ++i)
-			{
-				Build(firstChild + i, depth + 1, bboxPerNode[i], testFunc);
-			}
-		}
+		return m_nodeFirstChildren[nodeIdx] == std::numeric_limits<size_t>::max();
 	}
 
 	template <typename T>
@@ -303,24 +427,20 @@ namespace CubbyFlow
 			return false;
 		}
 
-		const Node& node = m_nodes[nodeIdx];
-
-		if (node.items.size() > 0)
+		for (size_t i = m_nodeItemStarts[nodeIdx]; i < m_nodeItemStarts[nodeIdx + 1]; ++i)
 		{
-			for (size_t itemIdx : node.items)
+			const size_t itemIdx = m_nodeItems[i];
+			if (testFunc(m_items[itemIdx], box))
 			{
-				if (testFunc(m_items[itemIdx], box))
-				{
-					return true;
-				}
+				return true;
 			}
 		}
 
-		if (node.firstChild != std::numeric_limits<size_t>::max())
+		if (!IsLeaf(nodeIdx))
 		{
 			for (int i = 0; i < 8; ++i)
 			{
-				if (IsIntersects(box, testFunc, node.firstChild + i, BoundingBox3D(bound.Corner(i), bound.MidPoint())))
+				if (IsIntersects(box, testFunc, m_nodeFirstChildren[nodeIdx] + i, BoundingBox3D(bound.Corner(i), bound.MidPoint())))
 				{
 					return true;
 				}
@@ -340,24 +460,20 @@ namespace CubbyFlow
 			return false;
 		}
 
-		const Node& node = m_nodes[nodeIdx];
-
-		if (node.items.size() > 0)
+		for (size_t i = m_nodeItemStarts[nodeIdx]; i < m_nodeItemStarts[nodeIdx + 1]; ++i)
 		{
-			for (size_t itemIdx : node.items)
+			const size_t itemIdx = m_nodeItems[i];
+			if (testFunc(m_items[itemIdx], ray))
 			{
-				if (testFunc(m_items[itemIdx], ray))
-				{
-					return true;
-				}
+				return true;
 			}
 		}
 
-		if (node.firstChild != std::numeric_limits<size_t>::max())
+		if (!IsLeaf(nodeIdx))
 		{
 			for (int i = 0; i < 8; ++i)
 			{
-				if (IsIntersects(ray, testFunc, node.firstChild + i, BoundingBox3D(bound.Corner(i), bound.MidPoint())))
+				if (IsIntersects(ray, testFunc, m_nodeFirstChildren[nodeIdx] + i, BoundingBox3D(bound.Corner(i), bound.MidPoint())))
 				{
 					return true;
 				}
@@ -378,25 +494,21 @@ namespace CubbyFlow
 			return;
 		}
 
-		const Node& node = m_nodes[nodeIdx];
-
-		if (node.items.size() > 0)
+		for (size_t i = m_nodeItemStarts[nodeIdx]; i < m_nodeItemStarts[nodeIdx + 1]; ++i)
 		{
-			for (size_t itemIdx : node.items)
+			const size_t itemIdx = m_nodeItems[i];
+			if (testFunc(m_items[itemIdx], box))
 			{
-				if (testFunc(m_items[itemIdx], box))
-				{
-					visitorFunc(m_items[itemIdx]);
-				}
+				visitorFunc(m_items[itemIdx]);
 			}
 		}
 
-		if (node.firstChild != std::numeric_limits<size_t>::max())
+		if (!IsLeaf(nodeIdx))
 		{
 			for (int i = 0; i < 8; ++i)
 			{
 				ForEachIntersectingItem(
-					box, testFunc, visitorFunc, node.firstChild + i,
+					box, testFunc, visitorFunc, m_nodeFirstChildren[nodeIdx] + i,
 					BoundingBox3D(bound.Corner(i), bound.MidPoint()));
 			}
 		}
@@ -413,25 +525,21 @@ namespace CubbyFlow
 			return;
 		}
 
-		const Node& node = m_nodes[nodeIdx];
-
-		if (node.items.size() > 0)
+		for (size_t i = m_nodeItemStarts[nodeIdx]; i < m_nodeItemStarts[nodeIdx + 1]; ++i)
 		{
-			for (size_t itemIdx : node.items)
+			const size_t itemIdx = m_nodeItems[i];
+			if (testFunc(m_items[itemIdx], ray))
 			{
-				if (testFunc(m_items[itemIdx], ray))
-				{
-					visitorFunc(m_items[itemIdx]);
-				}
+				visitorFunc(m_items[itemIdx]);
 			}
 		}
 
-		if (node.firstChild != std::numeric_limits<size_t>::max())
+		if (!IsLeaf(nodeIdx))
 		{
 			for (int i = 0; i < 8; ++i)
 			{
 				ForEachIntersectingItem(
-					ray, testFunc, visitorFunc, node.firstChild + i,
+					ray, testFunc, visitorFunc, m_nodeFirstChildren[nodeIdx] + i,
 					BoundingBox3D(bound.Corner(i), bound.MidPoint()));
 			}
 		}
@@ -448,27 +556,23 @@ namespace CubbyFlow
 			return best;
 		}
 
-		const Node& node = m_nodes[nodeIdx];
-
-		if (node.items.size() > 0)
+		for (size_t i = m_nodeItemStarts[nodeIdx]; i < m_nodeItemStarts[nodeIdx + 1]; ++i)
 		{
-			for (size_t itemIdx : node.items)
+			const size_t itemIdx = m_nodeItems[i];
+			double dist = testFunc(m_items[itemIdx], ray);
+			if (dist < best.distance)
 			{
-				double dist = testFunc(m_items[itemIdx], ray);
-				if (dist < best.distance)
-				{
-					best.distance = dist;
-					best.item = &m_items[itemIdx];
-				}
+				best.distance = dist;
+				best.item = &m_items[itemIdx];
 			}
 		}
 
-		if (node.firstChild != std::numeric_limits<size_t>::max())
+		if (!IsLeaf(nodeIdx))
 		{
 			for (int i = 0; i < 8; ++i)
 			{
 				best = GetClosestIntersection(
-					ray, testFunc, node.firstChild + i,
+					ray, testFunc, m_nodeFirstChildren[nodeIdx] + i,
 					BoundingBox3D(bound.Corner(i), bound.MidPoint()), best);
 			}
 		}
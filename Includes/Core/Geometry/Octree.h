@@ -10,9 +10,12 @@
 #ifndef CUBBYFLOW_OCTREE_H
 #define CUBBYFLOW_OCTREE_H
 
+#include <Core/Array/ArrayAccessor1.h>
 #include <Core/QueryEngine/IntersectionQueryEngine3.h>
 #include <Core/QueryEngine/NearestNeighborQueryEngine3.h>
 
+#include <vector>
+
 namespace CubbyFlow
 {
 	//!
@@ -22,6 +25,10 @@ namespace CubbyFlow
 	//! data. The octree supports closest neighbor search, overlapping test, and
 	//! ray intersection test.
 	//!
+	//! The tree is built level by level in parallel. Nodes are stored in flat
+	//! arrays in breadth-first order, and the item indices of all the leaves
+	//! are stored in one contiguous buffer addressed by per-node offsets.
+	//!
 	//! \tparam     T     Value type.
 	//!
 	template <typename T>
@@ -36,7 +43,8 @@ namespace CubbyFlow
 		Octree();
 
 		//! Builds an octree with given list of items, bounding box of the items,
-		//! overlapping test function, and max depth of the tree.
+		//! overlapping test function, and max depth of the tree. The test
+		//! function is invoked concurrently, so it must be thread-safe.
 		void Build(
 			const std::vector<T>& items, const BoundingBox3D& bound,
 			const BoxIntersectionTestFunc3<T>& testFunc, size_t maxDepth);
@@ -95,7 +103,7 @@ namespace CubbyFlow
 		size_t GetNumberOfNodes() const;
 
 		//! Returns the list of the items for given node index.
-		const std::vector<size_t>& GetItemsAtNode(size_t nodeIdx) const;
+		ConstArrayAccessor1<size_t> GetItemsAtNode(size_t nodeIdx) const;
 
 		//!
 		//! \brief      Returns a child's index for given node.
@@ -118,22 +126,19 @@ namespace CubbyFlow
 		size_t GetMaxDepth() const;
 
 	private:
-		struct Node
-		{
-			size_t firstChild = std::numeric_limits<size_t>::max();
-			std::vector<size_t> items;
-
-			bool IsLeaf() const;
-		};
-
 		size_t m_maxDepth = 1;
 		BoundingBox3D m_bbox;
 		std::vector<T> m_items;
-		std::vector<Node> m_nodes;
 
-		void Build(size_t nodeIdx, size_t currentDepth,
-			const BoundingBox3D& currentBound,
-			const BoxIntersectionTestFunc3<T>& overlapsFunc);
+		//! First child index of each node, or max() for leaves.
+		std::vector<size_t> m_nodeFirstChildren;
+
+		//! Node i owns m_nodeItems[m_nodeItemStarts[i]] to
+		//! m_nodeItems[m_nodeItemStarts[i + 1] - 1].
+		std::vector<size_t> m_nodeItemStarts;
+		std::vector<size_t> m_nodeItems;
+
+		bool IsLeaf(size_t nodeIdx) const;
 
 		bool IsIntersects(const BoundingBox3D& box,
 			const BoxIntersectionTestFunc3<T>& testFunc, size_t nodeIdx,
@@ -70,6 +70,21 @@ namespace CubbyFlow
 		//!
 		void Resize(const Size3& resolution, const Vector3D& gridSpacing, const Vector3D& origin);
 
+		//!
+		//! \brief      Resizes the whole system and moves its origin by whole
+		//!             cells while preserving the data.
+		//!
+		//! This function changes the resolution of the entire grid layers and
+		//! moves the origin by \p originOffset cells, keeping the grid spacing.
+		//! The data in the region overlapping with the old grids stay at the same
+		//! positions, and the rest is filled with zero. Only the overlapping
+		//! region is copied, so the cost is proportional to the grid size.
+		//!
+		//! \param[in]  resolution   The new resolution.
+		//! \param[in]  originOffset The offset of the new origin in cells.
+		//!
+		void ResizeAndShift(const Size3& resolution, const Point3I& originOffset);
+
 		//!
 		//! \brief      Returns the resolution of the grid.
 		//!
@@ -11,6 +11,7 @@
 #define CUBBYFLOW_SCALAR_GRID3_H
 
 #include <Core/Array/Array3.h>
+#include <Core/Array/ArrayAccessor1.h>
 #include <Core/Array/ArrayAccessor3.h>
 #include <Core/Array/ArraySamplers3.h>
 #include <Core/Field/ScalarField3.h>
@@ -143,6 +144,22 @@ namespace CubbyFlow
 		//!
 		std::function<double(const Vector3D&)> Sampler() const override;
 
+		//!
+		//! \brief Returns the sampled values of co-located grids at given
+		//!     position \p x.
+		//!
+		//! This function computes the linear sampling weights of this grid once
+		//! and gathers the data of each grid in \p grids with them, which saves
+		//! the sampling cost per field when several fields share the same
+		//! layout. The grids should have the same data size, data origin, and
+		//! grid spacing as this grid. The i-th result is stored to
+		//! \p results[i].
+		//!
+		void SampleMultiple(
+			const Vector3D& x,
+			const std::vector<const ScalarGrid3*>& grids,
+			ArrayAccessor1<double> results) const;
+
 		//! Returns the gradient vector at given position \p x.
 		Vector3D Gradient(const Vector3D& x) const override;
 
@@ -0,0 +1,35 @@
+/*************************************************************************
+> File Name: FixedPoint-Impl.h
+> Project Name: CubbyFlow
+> Purpose: Unsigned fixed-point number in [0, 1].
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_FIXED_POINT_IMPL_H
+#define CUBBYFLOW_FIXED_POINT_IMPL_H
+
+#include <algorithm>
+
+namespace CubbyFlow
+{
+	template <typename T>
+	FixedPoint<T>::FixedPoint(float value)
+	{
+		const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+		m_value = static_cast<T>(std::clamp(value, 0.0f, 1.0f) * maxValue + 0.5f);
+	}
+
+	template <typename T>
+	FixedPoint<T>::operator float() const
+	{
+		return static_cast<float>(m_value) * Epsilon();
+	}
+
+	template <typename T>
+	T FixedPoint<T>::GetRawValue() const
+	{
+		return m_value;
+	}
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*************************************************************************
+> File Name: FixedPoint.h
+> Project Name: CubbyFlow
+> Purpose: Unsigned fixed-point number in [0, 1].
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_FIXED_POINT_H
+#define CUBBYFLOW_FIXED_POINT_H
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace CubbyFlow
+{
+	//!
+	//! \brief Unsigned fixed-point number in [0, 1].
+	//!
+	//! This class stores a real number in [0, 1] as an unsigned integer of type
+	//! \p T, where the max value of \p T represents one. The input value is
+	//! clamped to [0, 1] and rounded to the nearest representable value, so
+	//! zero and one are exact. The value converts to float implicitly, so an
+	//! array of this type can replace an array of fractional weights with
+	//! the conversion only at use.
+	//!
+	//! \tparam T Unsigned integer type for the storage.
+	//!
+	template <typename T>
+	class FixedPoint
+	{
+	public:
+		static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "FixedPoint only can be instantiated with unsigned integer types");
+
+		//! Constructs zero.
+		constexpr FixedPoint() : m_value(0)
+		{
+			// Do nothing
+		}
+
+		//! Constructs with the nearest representable value of \p value.
+		FixedPoint(float value);
+
+		//! Returns the value as float.
+		operator float() const;
+
+		//! Returns the stored integer.
+		T GetRawValue() const;
+
+		//! Returns the difference between two consecutive representable values.
+		static constexpr float Epsilon()
+		{
+			return 1.0f / static_cast<float>(std::numeric_limits<T>::max());
+		}
+
+	private:
+		T m_value;
+	};
+
+	//! 8-bit fixed-point number in [0, 1].
+	using FixedPoint8 = FixedPoint<uint8_t>;
+
+	//! 16-bit fixed-point number in [0, 1].
+	using FixedPoint16 = FixedPoint<uint16_t>;
+}
+
+#include <Core/Math/FixedPoint-Impl.h>
+
+#endif
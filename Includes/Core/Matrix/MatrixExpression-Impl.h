@@ -275,7 +275,7 @@ namespace CubbyFlow
 	template <typename T, typename ME, typename VE>
 	size_t MatrixVectorMul<T, ME, VE>::size() const
 	{
-		return m_v.size();
+		return m_m.Rows();
 	}
 
 	template <typename T, typename ME, typename VE>
@@ -292,6 +292,18 @@ namespace CubbyFlow
 		return sum;
 	}
 
+	template <typename T, typename ME, typename VE>
+	const ME& MatrixVectorMul<T, ME, VE>::GetMatrixOperand() const
+	{
+		return m_m;
+	}
+
+	template <typename T, typename ME, typename VE>
+	const VE& MatrixVectorMul<T, ME, VE>::GetVectorOperand() const
+	{
+		return m_v;
+	}
+
 	// MARK: MatrixMul
 	template <typename T, typename E1, typename E2>
 	MatrixMul<T, E1, E2>::MatrixMul(const E1& u, const E2& v) : m_u(u), m_v(v)
@@ -332,6 +344,18 @@ namespace CubbyFlow
 		return sum;
 	}
 
+	template <typename T, typename E1, typename E2>
+	const E1& MatrixMul<T, E1, E2>::GetLeftOperand() const
+	{
+		return m_u;
+	}
+
+	template <typename T, typename E1, typename E2>
+	const E2& MatrixMul<T, E1, E2>::GetRightOperand() const
+	{
+		return m_v;
+	}
+
 	// MARK: Operator overloadings
 	template <typename T, typename E>
 	MatrixScalarMul<T, E> operator-(const MatrixExpression<T, E>& a)
@@ -305,6 +305,12 @@ namespace CubbyFlow
 		//! Returns vector element at i.
 		T operator[](size_t i) const;
 
+		//! Returns the input matrix expression.
+		const ME& GetMatrixOperand() const;
+
+		//! Returns the input vector expression.
+		const VE& GetVectorOperand() const;
+
 	private:
 		const ME& m_m;
 		const VE& m_v;
@@ -339,6 +345,12 @@ namespace CubbyFlow
 		//! Returns matrix element at (i, j).
 		T operator()(size_t i, size_t j) const;
 
+		//! Returns the first input expression.
+		const E1& GetLeftOperand() const;
+
+		//! Returns the second input expression.
+		const E2& GetRightOperand() const;
+
 	private:
 		const E1& m_u;
 		const E2& m_v;
@@ -0,0 +1,190 @@
+/*************************************************************************
+> File Name: MatrixGEMM-Impl.h
+> Project Name: CubbyFlow
+> Purpose: Cache-blocked evaluation of dense matrix products.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_MATRIX_GEMM_IMPL_H
+#define CUBBYFLOW_MATRIX_GEMM_IMPL_H
+
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace CubbyFlow
+{
+	namespace Internal
+	{
+		// Accumulates the product of an MR x kc and a kc x NR packed
+		// micro-panel into the top-left mr x nr corner of c. The fixed-size
+		// inner loops are kept branch-free so they vectorize.
+		template <typename T>
+		void GEMMMicroKernel(size_t kc, const T* a, const T* b, T* c, size_t ldc, size_t mr, size_t nr)
+		{
+			T ab[GEMM_MR * GEMM_NR];
+			std::fill(ab, ab + GEMM_MR * GEMM_NR, T(0));
+
+			for (size_t p = 0; p < kc; ++p)
+			{
+				const T* ap = a + p * GEMM_MR;
+				const T* bp = b + p * GEMM_NR;
+
+				for (size_t i = 0; i < GEMM_MR; ++i)
+				{
+					for (size_t j = 0; j < GEMM_NR; ++j)
+					{
+						ab[i * GEMM_NR + j] += ap[i] * bp[j];
+					}
+				}
+			}
+
+			for (size_t i = 0; i < mr; ++i)
+			{
+				for (size_t j = 0; j < nr; ++j)
+				{
+					c[i * ldc + j] += ab[i * GEMM_NR + j];
+				}
+			}
+		}
+	}
+
+	template <typename T, typename E1, typename E2>
+	void EvaluateMatrixMul(const MatrixMul<T, E1, E2>& expression, T* result)
+	{
+		const E1& a = expression.GetLeftOperand();
+		const E2& b = expression.GetRightOperand();
+		const size_t m = a.Rows();
+		const size_t n = b.Cols();
+		const size_t k = a.Cols();
+
+		if (k == 0)
+		{
+			return;
+		}
+
+		// The row blocks are split into contiguous slices, one per worker, and
+		// each worker packs its blocks of a into its own buffer.
+		const size_t numberOfRowBlocks = (m + GEMM_MC - 1) / GEMM_MC;
+		const size_t numberOfWorkers = std::max(std::min(numberOfRowBlocks, static_cast<size_t>(GetMaxNumberOfThreads())), ONE_SIZE);
+		const size_t maxNumberOfAPanels = (std::min(GEMM_MC, m) + GEMM_MR - 1) / GEMM_MR;
+		std::vector<std::vector<T>> packedA(numberOfWorkers, std::vector<T>(maxNumberOfAPanels * std::min(GEMM_KC, k) * GEMM_MR));
+
+		std::vector<T> packedB;
+
+		for (size_t jc = 0; jc < n; jc += GEMM_NC)
+		{
+			const size_t nc = std::min(GEMM_NC, n - jc);
+			const size_t numberOfBPanels = (nc + GEMM_NR - 1) / GEMM_NR;
+
+			for (size_t pc = 0; pc < k; pc += GEMM_KC)
+			{
+				const size_t kc = std::min(GEMM_KC, k - pc);
+
+				// Pack b(pc:pc+kc, jc:jc+nc) into zero-padded NR-wide panels
+				packedB.resize(numberOfBPanels * kc * GEMM_NR);
+				ParallelFor(ZERO_SIZE, numberOfBPanels, [&](size_t jp)
+				{
+					T* dst = packedB.data() + jp * kc * GEMM_NR;
+					const size_t j0 = jc + jp * GEMM_NR;
+					const size_t nr = std::min(GEMM_NR, jc + nc - j0);
+
+					for (size_t p = 0; p < kc; ++p)
+					{
+						for (size_t j = 0; j < GEMM_NR; ++j)
+						{
+							dst[p * GEMM_NR + j] = j < nr ? b(pc + p, j0 + j) : T(0);
+						}
+					}
+				});
+
+				ParallelFor(ZERO_SIZE, numberOfWorkers, [&](size_t worker)
+				{
+					const unsigned int numSlices = static_cast<unsigned int>(numberOfWorkers);
+					const size_t blockBegin = Internal::GetSliceBegin(ZERO_SIZE, numberOfRowBlocks, static_cast<unsigned int>(worker), numSlices);
+					const size_t blockEnd = Internal::GetSliceBegin(ZERO_SIZE, numberOfRowBlocks, static_cast<unsigned int>(worker) + 1, numSlices);
+
+					for (size_t ib = blockBegin; ib < blockEnd; ++ib)
+					{
+						const size_t ic = ib * GEMM_MC;
+						const size_t mc = std::min(GEMM_MC, m - ic);
+						const size_t numberOfAPanels = (mc + GEMM_MR - 1) / GEMM_MR;
+
+						for (size_t ip = 0; ip < numberOfAPanels; ++ip)
+						{
+							T* dst = packedA[worker].data() + ip * kc * GEMM_MR;
+							const size_t i0 = ic + ip * GEMM_MR;
+							const size_t mr = std::min(GEMM_MR, ic + mc - i0);
+
+							for (size_t i = 0; i < GEMM_MR; ++i)
+							{
+								for (size_t p = 0; p < kc; ++p)
+								{
+									dst[p * GEMM_MR + i] = i < mr ? a(i0 + i, pc + p) : T(0);
+								}
+							}
+						}
+
+						for (size_t jp = 0; jp < numberOfBPanels; ++jp)
+						{
+							const size_t j0 = jc + jp * GEMM_NR;
+							const size_t nr = std::min(GEMM_NR, jc + nc - j0);
+
+							for (size_t ip = 0; ip < numberOfAPanels; ++ip)
+							{
+								const size_t i0 = ic + ip * GEMM_MR;
+								const size_t mr = std::min(GEMM_MR, ic + mc - i0);
+
+								Internal::GEMMMicroKernel(
+									kc,
+									packedA[worker].data() + ip * kc * GEMM_MR,
+									packedB.data() + jp * kc * GEMM_NR,
+									result + i0 * n + j0, n, mr, nr);
+							}
+						}
+					}
+				});
+			}
+		}
+	}
+
+	template <typename T, typename ME, typename VE>
+	void EvaluateMatrixVectorMul(const MatrixVectorMul<T, ME, VE>& expression, T* result)
+	{
+		const ME& mat = expression.GetMatrixOperand();
+		const VE& vec = expression.GetVectorOperand();
+		const size_t m = mat.Rows();
+		const size_t n = mat.Cols();
+
+		std::vector<T> x(n);
+		ParallelFor(ZERO_SIZE, n, [&](size_t j)
+		{
+			x[j] = vec[j];
+		});
+
+		ParallelFor(ZERO_SIZE, m, [&](size_t i)
+		{
+			T sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+			size_t j = 0;
+
+			for (; j + 4 <= n; j += 4)
+			{
+				sum0 += mat(i, j) * x[j];
+				sum1 += mat(i, j + 1) * x[j + 1];
+				sum2 += mat(i, j + 2) * x[j + 2];
+				sum3 += mat(i, j + 3) * x[j + 3];
+			}
+
+			for (; j < n; ++j)
+			{
+				sum0 += mat(i, j) * x[j];
+			}
+
+			result[i] = (sum0 + sum1) + (sum2 + sum3);
+		});
+	}
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*************************************************************************
+> File Name: MatrixGEMM.h
+> Project Name: CubbyFlow
+> Purpose: Cache-blocked evaluation of dense matrix products.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_MATRIX_GEMM_H
+#define CUBBYFLOW_MATRIX_GEMM_H
+
+#include <Core/Matrix/MatrixExpression.h>
+
+#include <type_traits>
+
+namespace CubbyFlow
+{
+	//! Rows of the register block computed by the GEMM micro-kernel.
+	constexpr size_t GEMM_MR = 4;
+
+	//! Columns of the register block computed by the GEMM micro-kernel.
+	constexpr size_t GEMM_NR = 8;
+
+	//! Depth of the packed panels, sized so a micro-panel pair stays in L1.
+	constexpr size_t GEMM_KC = 256;
+
+	//! Rows of a packed left block, sized so the block stays in L2.
+	constexpr size_t GEMM_MC = 64;
+
+	//! Columns of a packed right panel, sized so the panel stays in L3.
+	constexpr size_t GEMM_NC = 2048;
+
+	//! Products with fewer multiply-adds than this are evaluated lazily.
+	constexpr size_t GEMM_MIN_FLOPS = 32 * 32 * 32;
+
+	//! True if \p E is a matrix-matrix multiplication expression.
+	template <typename E>
+	struct IsMatrixMul : std::false_type {};
+
+	template <typename T, typename E1, typename E2>
+	struct IsMatrixMul<MatrixMul<T, E1, E2>> : std::true_type {};
+
+	//! True if \p E is a matrix-vector multiplication expression.
+	template <typename E>
+	struct IsMatrixVectorMul : std::false_type {};
+
+	template <typename T, typename ME, typename VE>
+	struct IsMatrixVectorMul<MatrixVectorMul<T, ME, VE>> : std::true_type {};
+
+	//!
+	//! \brief Evaluates a matrix-matrix multiplication into dense storage.
+	//!
+	//! The operands are packed block by block into contiguous panels, so each
+	//! operand element is evaluated only once per block, and the product is
+	//! accumulated by a GEMM_MR x GEMM_NR register-blocked micro-kernel that
+	//! the compiler can vectorize. Row blocks of the left operand are
+	//! processed in parallel, and each thread writes disjoint rows.
+	//!
+	//! \param expression The product to evaluate.
+	//! \param result     Row-major output of Rows() x Cols() elements, which
+	//!                   the product is accumulated into. It must be
+	//!                   zero-filled and must not alias either operand.
+	//!
+	template <typename T, typename E1, typename E2>
+	void EvaluateMatrixMul(const MatrixMul<T, E1, E2>& expression, T* result);
+
+	//!
+	//! \brief Evaluates a matrix-vector multiplication into dense storage.
+	//!
+	//! The vector operand is evaluated once into a contiguous buffer, and the
+	//! rows are then reduced in parallel with independent partial sums.
+	//!
+	//! \param expression The product to evaluate.
+	//! \param result     Output of Rows() elements. It must not alias either
+	//!                   operand.
+	//!
+	template <typename T, typename ME, typename VE>
+	void EvaluateMatrixVectorMul(const MatrixVectorMul<T, ME, VE>& expression, T* result);
+}
+
+#include <Core/Matrix/MatrixGEMM-Impl.h>
+
+#endif
@@ -10,6 +10,8 @@
 #ifndef CUBBYFLOW_MATRIXMXN_IMPL_H
 #define CUBBYFLOW_MATRIXMXN_IMPL_H
 
+#include <Core/Matrix/MatrixGEMM.h>
+
 namespace CubbyFlow
 {
 	// MARK: MatrixMxN
@@ -79,10 +81,25 @@ namespace CubbyFlow
 	template <typename E>
 	void MatrixMxN<T>::Set(const MatrixExpression<T, E>& other)
 	{
+		const E& expression = other();
+
+		if constexpr (IsMatrixMul<E>::value)
+		{
+			// Blocked evaluation of large products into a temporary, since
+			// either operand may refer to this matrix
+			if (expression.Rows() * expression.Cols() * expression.GetLeftOperand().Cols() >= GEMM_MIN_FLOPS)
+			{
+				MatrixMxN result;
+				result.Resize(expression.Rows(), expression.Cols());
+				EvaluateMatrixMul(expression, result.data());
+				m_elements.Swap(result.m_elements);
+				return;
+			}
+		}
+
 		Resize(other.Rows(), other.Cols());
 
 		// Parallel evaluation of the expression
-		const E& expression = other();
 		ParallelForEachIndex([&](size_t i, size_t j) { (*this)(i, j) = expression(i, j); });
 	}
 
@@ -181,6 +181,20 @@ namespace CubbyFlow
 			const ConstArrayAccessor1<Vector3D>& newVelocities = ConstArrayAccessor1<Vector3D>(),
 			const ConstArrayAccessor1<Vector3D>& newForces = ConstArrayAccessor1<Vector3D>());
 
+		//!
+		//! \brief      Removes particles from the data structure.
+		//!
+		//! This function removes the particles whose \p isRemoved value is
+		//! non-zero from every data layer, keeping the order of the remaining
+		//! particles. However, this will invalidate neighbor searcher and
+		//! neighbor lists. It is users responsibility to call
+		//! ParticleSystemData3::BuildNeighborSearcher and
+		//! ParticleSystemData3::BuildNeighborLists to refresh those data.
+		//!
+		//! \param[in]  isRemoved Non-zero for the particles to remove.
+		//!
+		void RemoveParticles(const ConstArrayAccessor1<char>& isRemoved);
+
 		//!
 		//! \brief      Returns neighbor searcher.
 		//!
@@ -232,6 +246,9 @@ namespace CubbyFlow
 		void DeserializeParticleSystemData(
 			const fbs::ParticleSystemData3* fbsParticleSystemData);
 
+		//! Replaces the neighbor lists, for subclasses that build their own.
+		void SetNeighborLists(std::vector<std::vector<size_t>>&& neighborLists);
+
 	private:
 		double m_radius = 1e-3;
 		double m_mass = 1e-3;
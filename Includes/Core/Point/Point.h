@@ -11,6 +11,7 @@
 #define CUBBYFLOW_POINT_H
 
 #include <array>
+#include <cstddef>
 #include <type_traits>
 
 namespace CubbyFlow
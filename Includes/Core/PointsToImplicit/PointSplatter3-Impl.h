@@ -0,0 +1,93 @@
+/*************************************************************************
+> File Name: PointSplatter3-Impl.h
+> Project Name: CubbyFlow
+> Purpose: Tiled, parallel 3-D point-to-grid splatting engine.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_POINT_SPLATTER3_IMPL_H
+#define CUBBYFLOW_POINT_SPLATTER3_IMPL_H
+
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
+#include <algorithm>
+
+namespace CubbyFlow
+{
+	template <typename T, typename AccumulateFunc, typename FinalizeFunc>
+	void PointSplatter3::Splat(const T& initialValue, const AccumulateFunc& accumulate, const FinalizeFunc& finalize) const
+	{
+		const double radiusSquared = m_radius * m_radius;
+
+		ParallelFor(ZERO_SIZE, m_occupiedTiles.size(), [&](size_t n)
+		{
+			const size_t tile = m_occupiedTiles[n];
+			const size_t tileI = tile % m_numberOfTiles.x;
+			const size_t tileJ = (tile / m_numberOfTiles.x) % m_numberOfTiles.y;
+			const size_t tileK = tile / (m_numberOfTiles.x * m_numberOfTiles.y);
+
+			const Size3 tileBegin(tileI * m_tileSize, tileJ * m_tileSize, tileK * m_tileSize);
+			const Size3 tileEnd(
+				std::min(tileBegin.x + m_tileSize, m_dataSize.x),
+				std::min(tileBegin.y + m_tileSize, m_dataSize.y),
+				std::min(tileBegin.z + m_tileSize, m_dataSize.z));
+			const Size3 tileExtent(tileEnd.x - tileBegin.x, tileEnd.y - tileBegin.y, tileEnd.z - tileBegin.z);
+
+			std::vector<T> values(tileExtent.x * tileExtent.y * tileExtent.z, initialValue);
+
+			for (size_t idx = m_tileStarts[tile]; idx < m_tileStarts[tile + 1]; ++idx)
+			{
+				const size_t pointIndex = m_tilePointIndices[idx];
+				const Vector3D& point = m_points[pointIndex];
+
+				Size3 lower, upper;
+				GetDataIndexRange(point, &lower, &upper);
+
+				lower.x = std::max(lower.x, tileBegin.x);
+				lower.y = std::max(lower.y, tileBegin.y);
+				lower.z = std::max(lower.z, tileBegin.z);
+				upper.x = std::min(upper.x, tileEnd.x - 1);
+				upper.y = std::min(upper.y, tileEnd.y - 1);
+				upper.z = std::min(upper.z, tileEnd.z - 1);
+
+				for (size_t k = lower.z; k <= upper.z; ++k)
+				{
+					const double z = m_dataOrigin.z + m_gridSpacing.z * k;
+
+					for (size_t j = lower.y; j <= upper.y; ++j)
+					{
+						const double y = m_dataOrigin.y + m_gridSpacing.y * j;
+						T* row = &values[((k - tileBegin.z) * tileExtent.y + (j - tileBegin.y)) * tileExtent.x];
+
+						for (size_t i = lower.x; i <= upper.x; ++i)
+						{
+							const Vector3D x(m_dataOrigin.x + m_gridSpacing.x * i, y, z);
+							const double distanceSquared = (x - point).LengthSquared();
+
+							if (distanceSquared <= radiusSquared)
+							{
+								accumulate(row[i - tileBegin.x], pointIndex, x, distanceSquared);
+							}
+						}
+					}
+				}
+			}
+
+			for (size_t k = tileBegin.z; k < tileEnd.z; ++k)
+			{
+				for (size_t j = tileBegin.y; j < tileEnd.y; ++j)
+				{
+					const T* row = &values[((k - tileBegin.z) * tileExtent.y + (j - tileBegin.y)) * tileExtent.x];
+
+					for (size_t i = tileBegin.x; i < tileEnd.x; ++i)
+					{
+						finalize(i, j, k, row[i - tileBegin.x]);
+					}
+				}
+			}
+		});
+	}
+}
+
+#endif
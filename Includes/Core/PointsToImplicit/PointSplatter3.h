@@ -0,0 +1,104 @@
+/*************************************************************************
+> File Name: PointSplatter3.h
+> Project Name: CubbyFlow
+> Purpose: Tiled, parallel 3-D point-to-grid splatting engine.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_POINT_SPLATTER3_H
+#define CUBBYFLOW_POINT_SPLATTER3_H
+
+#include <Core/Array/ArrayAccessor1.h>
+#include <Core/Size/Size3.h>
+#include <Core/Vector/Vector3.h>
+
+#include <vector>
+
+namespace CubbyFlow
+{
+	//!
+	//! \brief Tiled, parallel 3-D point-to-grid splatting engine.
+	//!
+	//! This class scatters the contribution of each point to the grid data
+	//! points within a given support radius. Instead of gathering neighbors for
+	//! every grid data point, the grid is partitioned into cubic tiles and each
+	//! point is binned into the tiles its support overlaps. Tiles are then
+	//! processed in parallel with a tile-local accumulation buffer, so no two
+	//! threads ever write the same grid data point and no atomics are required.
+	//! Tiles without any point are never visited.
+	//!
+	//! Points in a tile are visited in ascending index order, so the result is
+	//! deterministic regardless of the number of threads.
+	//!
+	class PointSplatter3
+	{
+	public:
+		//!
+		//! \brief Constructs the splatter for a grid data layout.
+		//!
+		//! \param dataSize    The number of grid data points per axis.
+		//! \param gridSpacing The grid spacing.
+		//! \param dataOrigin  The position of the grid data point at (0, 0, 0).
+		//! \param tileSize    The edge length of a tile in data points.
+		//!
+		PointSplatter3(
+			const Size3& dataSize,
+			const Vector3D& gridSpacing,
+			const Vector3D& dataOrigin,
+			size_t tileSize = 16);
+
+		//!
+		//! \brief Bins the points into the tiles their support overlaps.
+		//!
+		//! The points are not copied, so \p points must stay valid until the
+		//! last call to Splat.
+		//!
+		//! \param points The points to splat.
+		//! \param radius The support radius of each point.
+		//!
+		void Build(const ConstArrayAccessor1<Vector3D>& points, double radius);
+
+		//!
+		//! \brief Splats the points into the grid tile by tile in parallel.
+		//!
+		//! For each occupied tile, a local buffer of \p initialValue is created
+		//! and \p accumulate is invoked as
+		//! \code
+		//! accumulate(T& value, size_t pointIndex, const Vector3D& x, double distanceSquared)
+		//! \endcode
+		//! for every data point x within the support radius of a point. Then
+		//! \p finalize is invoked as
+		//! \code
+		//! finalize(size_t i, size_t j, size_t k, const T& value)
+		//! \endcode
+		//! once for every data point in the tile, including the ones no point
+		//! has reached. Data points in empty tiles are not visited at all, so
+		//! the caller should fill them with the background value beforehand.
+		//!
+		template <typename T, typename AccumulateFunc, typename FinalizeFunc>
+		void Splat(const T& initialValue, const AccumulateFunc& accumulate, const FinalizeFunc& finalize) const;
+
+		//! Returns the number of tiles that have at least one point.
+		size_t GetNumberOfOccupiedTiles() const;
+
+	private:
+		Size3 m_dataSize;
+		Vector3D m_gridSpacing;
+		Vector3D m_dataOrigin;
+		size_t m_tileSize = 16;
+		Size3 m_numberOfTiles;
+
+		ConstArrayAccessor1<Vector3D> m_points;
+		double m_radius = 0.0;
+
+		std::vector<size_t> m_tileStarts;
+		std::vector<size_t> m_tilePointIndices;
+		std::vector<size_t> m_occupiedTiles;
+
+		bool GetDataIndexRange(const Vector3D& point, Size3* lower, Size3* upper) const;
+	};
+}
+
+#include <Core/PointsToImplicit/PointSplatter3-Impl.h>
+
+#endif
@@ -20,6 +20,10 @@
 
 namespace CubbyFlow
 {
+	//! Number of neighbors the SPH loops gather before calling the batch
+	//! kernel functions.
+	constexpr size_t SPH_KERNEL_BATCH_SIZE = 32;
+
 	//!
 	//! \brief Standard 3-D SPH kernel function object.
 	//!
@@ -65,6 +69,26 @@ namespace CubbyFlow
 
 		//! Returns the second derivative at given distance.
 		double SecondDerivative(double distance) const;
+
+		//!
+		//! \brief Evaluates the kernel function for a batch of squared distances.
+		//!
+		//! The standard kernel only depends on the squared distance, so no square
+		//! root is needed. The batch functions share the constants over the batch
+		//! and have no branches, which lets the compiler vectorize them. Unlike
+		//! the other batch functions, the FromSquared ones take squared distances.
+		//!
+		//! \param[in]  distancesSquared The squared distances.
+		//! \param[out] values           The kernel function values.
+		//! \param[in]  count            The number of distances.
+		//!
+		void BatchValuesFromSquared(const double* distancesSquared, double* values, size_t count) const;
+
+		//! Evaluates the first derivative for a batch of distances.
+		void BatchFirstDerivatives(const double* distances, double* values, size_t count) const;
+
+		//! Evaluates the second derivative for a batch of squared distances.
+		void BatchSecondDerivativesFromSquared(const double* distancesSquared, double* values, size_t count) const;
 	};
 
 	//!
@@ -115,6 +139,21 @@ namespace CubbyFlow
 
 		//! Returns the second derivative at given distance.
 		double SecondDerivative(double distance) const;
+
+		//!
+		//! \brief Evaluates the kernel function for a batch of distances.
+		//!
+		//! \param[in]  distances The distances.
+		//! \param[out] values    The kernel function values.
+		//! \param[in]  count     The number of distances.
+		//!
+		void BatchValues(const double* distances, double* values, size_t count) const;
+
+		//! Evaluates the first derivative for a batch of distances.
+		void BatchFirstDerivatives(const double* distances, double* values, size_t count) const;
+
+		//! Evaluates the second derivative for a batch of distances.
+		void BatchSecondDerivatives(const double* distances, double* values, size_t count) const;
 	};
 }
 
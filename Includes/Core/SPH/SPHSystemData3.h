@@ -11,6 +11,7 @@
 #define CUBBYFLOW_SPH_SYSTEM_DATA3_H
 
 #include <Core/Particle/ParticleSystemData3.h>
+#include <Core/Searcher/PointHierarchicalHashGridSearcher3.h>
 
 namespace CubbyFlow
 {
@@ -21,6 +22,12 @@ namespace CubbyFlow
 	//! It includes density and pressure array as a default particle attribute, and
 	//! it also contains SPH utilities such as interpolation operator.
 	//!
+	//! With the adaptive kernel enabled, each particle has its own smoothing
+	//! length h_i, and particle pairs use the symmetric h_ij = (h_i + h_j) / 2.
+	//! The mass of a particle scales with (h_i / kernel radius)^3 so that the
+	//! target density is kept for any resolution, and the neighbors are found
+	//! with a hierarchical grid that has one level per smoothing length class.
+	//!
 	class SPHSystemData3 : public ParticleSystemData3
 	{
 	public:
@@ -65,9 +72,51 @@ namespace CubbyFlow
 		//! Returns the pressure array accessor (mutable).
 		ArrayAccessor1<double> GetPressures();
 
+		//! Returns the smoothing length array accessor (immutable).
+		ConstArrayAccessor1<double> GetSmoothingLengths() const;
+
+		//! Returns the smoothing length array accessor (mutable).
+		ArrayAccessor1<double> GetSmoothingLengths();
+
+		//!
+		//! \brief Returns the smoothing length of i-th particle.
+		//!
+		//! This is the kernel radius unless the adaptive kernel is enabled and
+		//! the particle has a positive entry in the smoothing length array.
+		//! Newly added particles have zero, so they use the kernel radius.
+		//!
+		double GetSmoothingLengthAt(size_t i) const;
+
+		//! Returns the mass of i-th particle, which scales with the cube of
+		//! its smoothing length relative to the kernel radius.
+		double GetMassAt(size_t i) const;
+
+		//! Returns true if per-particle smoothing lengths are used.
+		bool GetIsUsingAdaptiveKernel() const;
+
+		//!
+		//! \brief Enables or disables per-particle smoothing lengths.
+		//!
+		//! Once this function is called, neighbor searcher, neighbor lists and
+		//! density should be updated. SPHSolver3 uses the smoothing lengths in
+		//! all of its kernels, while the density prediction of PCISPHSolver3
+		//! still assumes the kernel radius.
+		//!
+		void SetIsUsingAdaptiveKernel(bool isUsing);
+
 		//! Updates the density array with the latest particle positions.
 		void UpdateDensities();
 
+		//!
+		//! \brief Updates the density array from the neighbor lists.
+		//!
+		//! Unlike UpdateDensities, this function does not query the neighbor
+		//! searcher. The neighbor lists must contain every neighbor within the
+		//! kernel radius at the latest positions; farther ones are filtered
+		//! out by the kernel, so lists built with a larger radius also work.
+		//!
+		void UpdateDensitiesFromNeighborLists();
+
 		//! Sets the target density of this particle system.
 		void SetTargetDensity(double targetDensity);
 
@@ -148,12 +197,25 @@ namespace CubbyFlow
 		//! Returns the Laplacian of the given values at i-th particle.
 		Vector3D LaplacianAt(size_t i, const ConstArrayAccessor1<Vector3D>& values) const;
 
-		//! Builds neighbor searcher with kernel radius.
+		//!
+		//! \brief Builds neighbor searcher with kernel radius.
+		//!
+		//! With the adaptive kernel enabled, this builds the hierarchical grid
+		//! from the smoothing lengths instead of the default neighbor searcher.
+		//!
 		void BuildNeighborSearcher();
 
-		//! Builds neighbor lists with kernel radius.
+		//!
+		//! \brief Builds neighbor lists with kernel radius.
+		//!
+		//! With the adaptive kernel enabled, j is a neighbor of i if they are
+		//! within h_ij, which makes the lists symmetric.
+		//!
 		void BuildNeighborLists();
 
+		using ParticleSystemData3::BuildNeighborSearcher;
+		using ParticleSystemData3::BuildNeighborLists;
+
 		//! Serializes this SPH system data to the buffer.
 		void Serialize(std::vector<uint8_t>* buffer) const override;
 
@@ -184,6 +246,12 @@ namespace CubbyFlow
 
 		size_t m_densityIdx;
 
+		size_t m_smoothingLengthIdx;
+
+		bool m_isUsingAdaptiveKernel = false;
+
+		PointHierarchicalHashGridSearcher3 m_adaptiveNeighborSearcher;
+
 		//! Computes the mass based on the target density and spacing.
 		void ComputeMass();
 	};
@@ -0,0 +1,216 @@
+/*************************************************************************
+> File Name: PointCompactHashGridSearcher3.h
+> Project Name: CubbyFlow
+> Purpose: Compact hash grid-based 3-D point searcher with unbounded domain.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_POINT_COMPACT_HASH_GRID_SEARCHER3_H
+#define CUBBYFLOW_POINT_COMPACT_HASH_GRID_SEARCHER3_H
+
+#include <Core/Point/Point3.h>
+#include <Core/Searcher/PointNeighborSearcher3.h>
+
+#include <cstdint>
+#include <utility>
+
+namespace CubbyFlow
+{
+	//!
+	//! \brief Compact hash grid-based 3-D point searcher with unbounded domain.
+	//!
+	//! Unlike PointParallelHashGridSearcher3, this class does not allocate a
+	//! table for every bucket of a fixed resolution. The points are sorted by
+	//! the Morton code of their bucket, and only the occupied buckets are
+	//! stored along with an open addressing hash table which maps a Morton code
+	//! to its bucket. Memory is proportional to the number of points, and since
+	//! the full Morton code is compared on lookup, distant buckets are never
+	//! folded together. Bucket coordinates must fit in 21 bits per axis, which
+	//! is [-2^20, 2^20) times the grid spacing; Build rejects points outside of
+	//! that range, and queries ignore the part of the search box beyond it.
+	//!
+	class PointCompactHashGridSearcher3 final : public PointNeighborSearcher3
+	{
+	public:
+		CUBBYFLOW_NEIGHBOR_SEARCHER3_TYPE_NAME(PointCompactHashGridSearcher3)
+
+		class Builder;
+
+		//!
+		//! \brief      Constructs compact hash grid with given grid spacing.
+		//!
+		//! Any search radius is supported, but queries are the fastest when the
+		//! grid spacing is about 2x the search radius.
+		//!
+		//! \param[in]  gridSpacing The grid spacing.
+		//!
+		explicit PointCompactHashGridSearcher3(double gridSpacing);
+
+		//! Copy constructor
+		PointCompactHashGridSearcher3(const PointCompactHashGridSearcher3& other);
+
+		//!
+		//! \brief Builds internal acceleration structure for given points list.
+		//!
+		//! This function builds the compact hash grid for given points in
+		//! parallel. Throws std::invalid_argument if a point lies outside of
+		//! [-2^20, 2^20) times the grid spacing on any axis.
+		//!
+		//! \param[in]  points The points to be added.
+		//!
+		void Build(const ConstArrayAccessor1<Vector3D>& points) override;
+
+		//!
+		//! Invokes the callback function for each nearby point around the origin
+		//! within given radius.
+		//!
+		//! \param[in]  origin   The origin position.
+		//! \param[in]  radius   The search radius.
+		//! \param[in]  callback The callback function.
+		//!
+		void ForEachNearbyPoint(const Vector3D& origin, double radius, const ForEachNearbyPointFunc& callback) const override;
+
+		//!
+		//! Returns true if there are any nearby points for given origin within
+		//! radius.
+		//!
+		//! \param[in]  origin The origin.
+		//! \param[in]  radius The radius.
+		//!
+		//! \return     True if has nearby point, false otherwise.
+		//!
+		bool HasNearbyPoint(const Vector3D& origin, double radius) const override;
+
+		//!
+		//! \brief      Builds the neighbor lists of all the points.
+		//!
+		//! The occupied buckets are visited in parallel, and the sorted point
+		//! ranges of the surrounding buckets are looked up once per bucket.
+		//!
+		//! \param[in]  points        The points the searcher was built with.
+		//! \param[in]  radius        The search radius.
+		//! \param[out] neighborLists The neighbor lists.
+		//!
+		void BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const override;
+
+		//! Returns the grid spacing.
+		double GetGridSpacing() const;
+
+		//! Returns the number of buckets that have at least one point.
+		size_t GetNumberOfOccupiedBuckets() const;
+
+		//!
+		//! \brief      Returns the points of given occupied bucket.
+		//!
+		//! \param[in]  bucket The occupied bucket, less than
+		//!                    GetNumberOfOccupiedBuckets().
+		//!
+		//! \return     The range [first, second) of sorted indices.
+		//!
+		std::pair<size_t, size_t> GetBucketRange(size_t bucket) const;
+
+		//!
+		//! \brief      Returns the points of the buckets around an occupied bucket.
+		//!
+		//! Collects the sorted index ranges of the occupied buckets within
+		//! \p extent buckets along each axis, including the bucket itself.
+		//! The ranges are sorted, and adjacent ones are merged.
+		//!
+		//! \param[in]  bucket The occupied bucket.
+		//! \param[in]  extent The number of buckets to include on each side.
+		//! \param[out] ranges The ranges [first, second) of sorted indices.
+		//!
+		void GetNearbyBucketRanges(size_t bucket, size_t extent, std::vector<std::pair<size_t, size_t>>* ranges) const;
+
+		//!
+		//! \brief      Returns the sorted indices of the points.
+		//!
+		//! The list this function returns maps sorted index i to original
+		//! index j. The points are sorted by the Morton code of their bucket.
+		//!
+		//! \return     The sorted indices of the points.
+		//!
+		const std::vector<size_t>& SortedIndices() const;
+
+		//!
+		//! Gets the bucket index from a point.
+		//!
+		//! \param[in]  position The position of the point.
+		//!
+		//! \return     The bucket index.
+		//!
+		Point3I GetBucketIndex(const Vector3D& position) const;
+
+		//!
+		//! Returns the Morton code for given 3-D bucket index.
+		//!
+		//! \param[in]  bucketIndex The bucket index.
+		//!
+		//! \return     The Morton code of the bucket index.
+		//!
+		static uint64_t GetMortonCode(const Point3I& bucketIndex);
+
+		//!
+		//! \brief      Creates a new instance of the object with same properties
+		//!             than original.
+		//!
+		//! \return     Copy of this object.
+		//!
+		PointNeighborSearcher3Ptr Clone() const override;
+
+		//! Assignment operator.
+		PointCompactHashGridSearcher3& operator=(const PointCompactHashGridSearcher3& other);
+
+		//! Copy from the other instance.
+		void Set(const PointCompactHashGridSearcher3& other);
+
+		//! Serializes the neighbor searcher into the buffer.
+		void Serialize(std::vector<uint8_t>* buffer) const override;
+
+		//! Deserializes the neighbor searcher from the buffer.
+		void Deserialize(const std::vector<uint8_t>& buffer) override;
+
+		//! Returns builder fox PointCompactHashGridSearcher3.
+		static Builder GetBuilder();
+
+	private:
+		double m_gridSpacing = 1.0;
+		std::vector<Vector3D> m_points;
+		std::vector<size_t> m_sortedIndices;
+		std::vector<uint64_t> m_bucketKeys;
+		std::vector<size_t> m_bucketStarts;
+		std::vector<size_t> m_hashTable;
+
+		size_t FindBucket(const Point3I& bucketIndex) const;
+
+		template <typename Callback>
+		void ForEachBucketRange(const Point3I& lowerIndex, const Point3I& upperIndex, const Callback& callback) const;
+	};
+
+	//! Shared pointer for the PointCompactHashGridSearcher3 type.
+	using PointCompactHashGridSearcher3Ptr = std::shared_ptr<PointCompactHashGridSearcher3>;
+
+	//!
+	//! \brief Front-end to create PointCompactHashGridSearcher3 objects step by step.
+	//!
+	class PointCompactHashGridSearcher3::Builder final : public PointNeighborSearcherBuilder3
+	{
+	public:
+		//! Returns builder with grid spacing.
+		Builder& WithGridSpacing(double gridSpacing);
+
+		//! Builds PointCompactHashGridSearcher3 instance.
+		PointCompactHashGridSearcher3 Build() const;
+
+		//! Builds shared pointer of PointCompactHashGridSearcher3 instance.
+		PointCompactHashGridSearcher3Ptr MakeShared() const;
+
+		//! Returns shared pointer of PointNeighborSearcher3 type.
+		PointNeighborSearcher3Ptr BuildPointNeighborSearcher() const override;
+
+	private:
+		double m_gridSpacing = 1.0;
+	};
+}
+
+#endif
\ No newline at end of file
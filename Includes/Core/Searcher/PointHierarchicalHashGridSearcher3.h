@@ -0,0 +1,95 @@
+/*************************************************************************
+> File Name: PointHierarchicalHashGridSearcher3.h
+> Project Name: CubbyFlow
+> Purpose: Hierarchical hash grid-based 3-D point searcher for per-point radii.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_POINT_HIERARCHICAL_HASH_GRID_SEARCHER3_H
+#define CUBBYFLOW_POINT_HIERARCHICAL_HASH_GRID_SEARCHER3_H
+
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
+
+namespace CubbyFlow
+{
+	//!
+	//! \brief Hierarchical hash grid-based 3-D point searcher for per-point radii.
+	//!
+	//! Each point carries its own radius, and the points are grouped into
+	//! levels by radius class, where level L holds the radii in
+	//! [r_min * 2^L, r_min * 2^(L + 1)). Every level has its own compact hash
+	//! grid whose spacing follows the largest radius of the level, so small
+	//! points are not searched with the bucket size of the largest ones.
+	//!
+	//! The queries are symmetric: point j is a neighbor of a query with radius
+	//! h if the distance is within (h + h_j) / 2, which is the averaged
+	//! smoothing length h_ij used by adaptive SPH.
+	//!
+	class PointHierarchicalHashGridSearcher3 final
+	{
+	public:
+		using ForEachNearbyPointFunc = PointNeighborSearcher3::ForEachNearbyPointFunc;
+
+		//! Default constructor.
+		PointHierarchicalHashGridSearcher3() = default;
+
+		//!
+		//! \brief Builds internal acceleration structure for given points list.
+		//!
+		//! \param[in]  points The points to be added.
+		//! \param[in]  radii  The radius of each point. Must be positive.
+		//!
+		void Build(const ConstArrayAccessor1<Vector3D>& points, const ConstArrayAccessor1<double>& radii);
+
+		//!
+		//! Invokes the callback function for each point j whose distance to the
+		//! origin is within (radius + r_j) / 2.
+		//!
+		//! \param[in]  origin   The origin position.
+		//! \param[in]  radius   The radius of the query point.
+		//! \param[in]  callback The callback function.
+		//!
+		void ForEachNearbyPoint(const Vector3D& origin, double radius, const ForEachNearbyPointFunc& callback) const;
+
+		//!
+		//! Returns true if there is any point j whose distance to the origin
+		//! is within (radius + r_j) / 2.
+		//!
+		//! \param[in]  origin The origin.
+		//! \param[in]  radius The radius of the query point.
+		//!
+		//! \return     True if has nearby point, false otherwise.
+		//!
+		bool HasNearbyPoint(const Vector3D& origin, double radius) const;
+
+		//!
+		//! \brief      Builds the symmetric neighbor lists of the points.
+		//!
+		//! Each point is queried with its own radius, so j is in the list of i
+		//! if and only if i is in the list of j. A point is never its own
+		//! neighbor.
+		//!
+		//! \param[out] neighborLists The neighbor lists.
+		//!
+		void BuildNeighborLists(std::vector<std::vector<size_t>>* neighborLists) const;
+
+		//! Returns the number of levels.
+		size_t GetNumberOfLevels() const;
+
+		//! Returns the number of points in given level.
+		size_t GetNumberOfPointsAt(size_t level) const;
+
+		//! Returns the level for given radius.
+		size_t GetLevel(double radius) const;
+
+	private:
+		double m_minRadius = 0.0;
+		std::vector<Vector3D> m_points;
+		std::vector<double> m_radii;
+		std::vector<double> m_levelMaxRadii;
+		std::vector<std::vector<size_t>> m_levelIndices;
+		std::vector<PointCompactHashGridSearcher3> m_levelSearchers;
+	};
+}
+
+#endif
@@ -49,6 +49,21 @@ namespace CubbyFlow
 			const Vector2D& origin, double radius,
 			const ForEachNearbyPointFunc& callback) const override;
 
+		//!
+		//! \brief Invokes the callback function for the k nearest points around
+		//!        the origin.
+		//!
+		//! The points are visited in ascending order of distance from the origin.
+		//! If less than k points are stored, every point is visited.
+		//!
+		//! \param[in]  origin   The origin position.
+		//! \param[in]  k        The number of points to visit.
+		//! \param[in]  callback The callback function.
+		//!
+		void ForEachKNearestPoints(
+			const Vector2D& origin, size_t k,
+			const ForEachNearbyPointFunc& callback) const;
+
 		//!
 		//! Returns true if there are any nearby points for given origin within
 		//! radius.
@@ -10,12 +10,14 @@
 #ifndef CUBBYFLOW_POINT_NEIGHBOR_SEARCHER3_H
 #define CUBBYFLOW_POINT_NEIGHBOR_SEARCHER3_H
 
+#include <Core/Array/ArrayAccessor1.h>
 #include <Core/Utils/Serialization.h>
 #include <Core/Vector/Vector3.h>
 
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace CubbyFlow
 {
@@ -67,6 +69,22 @@ namespace CubbyFlow
 		//!
 		virtual bool HasNearbyPoint(const Vector3D& origin, double radius) const = 0;
 
+		//!
+		//! \brief      Builds the neighbor lists of all the points.
+		//!
+		//! For every point i of \p points, fills (*neighborLists)[i] with the
+		//! indices of the other points within given radius. The point itself
+		//! is excluded. The points must be the same list that was used to build
+		//! the searcher. The default implementation issues ForEachNearbyPoint
+		//! for each point in parallel; derived classes may override this with
+		//! a batched query.
+		//!
+		//! \param[in]  points        The points the searcher was built with.
+		//! \param[in]  radius        The search radius.
+		//! \param[out] neighborLists The neighbor lists.
+		//!
+		virtual void BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const;
+
 		//!
 		//! \brief      Creates a new instance of the object with same properties
 		//!             than original.
@@ -13,6 +13,8 @@
 #include <Core/Searcher/PointNeighborSearcher3.h>
 #include <Core/Size/Size3.h>
 
+#include <utility>
+
 namespace CubbyFlow
 {
 	//!
@@ -88,6 +90,23 @@ namespace CubbyFlow
 		//!
 		bool HasNearbyPoint(const Vector3D& origin, double radius) const override;
 
+		//!
+		//! \brief      Builds the neighbor lists of all the points.
+		//!
+		//! Instead of one query per point, this function walks the occupied
+		//! buckets in parallel. The sorted points of the surrounding buckets
+		//! are merged into a few contiguous ranges once per bucket (or per
+		//! octant of it if the radius is at most half of the grid spacing), so
+		//! the inner loop is a plain distance test over contiguous memory.
+		//! Unlike ForEachNearbyPoint, a radius up to the grid spacing is
+		//! supported; larger radii fall back to the per-point query.
+		//!
+		//! \param[in]  points        The points the searcher was built with.
+		//! \param[in]  radius        The search radius.
+		//! \param[out] neighborLists The neighbor lists.
+		//!
+		void BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const override;
+
 		//!
 		//! \brief      Returns the hash key list.
 		//!
@@ -213,6 +232,8 @@ namespace CubbyFlow
 		size_t GetHashKeyFromPosition(const Vector3D& position) const;
 
 		void GetNearbyKeys(const Vector3D& position, size_t* bucketIndices) const;
+
+		size_t GetNearbyRanges(const Vector3D& position, bool octantOnly, std::pair<size_t, size_t>* ranges) const;
 	};
 
 	//! Shared pointer for the PointParallelHashGridSearcher3 type.
@@ -10,8 +10,11 @@
 #ifndef CUBBYFLOW_SEMI_LAGRANGIAN3_H
 #define CUBBYFLOW_SEMI_LAGRANGIAN3_H
 
+#include <Core/Array/Array3.h>
 #include <Core/Solver/Advection/AdvectionSolver3.h>
 
+#include <deque>
+
 namespace CubbyFlow
 {
 	//!
@@ -55,7 +58,7 @@ namespace CubbyFlow
 			const VectorField3& flow,
 			double dt,
 			ScalarGrid3* output,
-			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) final;
+			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) override;
 
 		//!
 		//! \brief Computes semi-Lagrangian for given collocated vector grid.
@@ -80,7 +83,7 @@ namespace CubbyFlow
 			const VectorField3& flow,
 			double dt,
 			CollocatedVectorGrid3* output,
-			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) final;
+			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) override;
 
 		//!
 		//! \brief Computes semi-Lagrangian for given face-centered vector grid.
@@ -106,9 +109,53 @@ namespace CubbyFlow
 			const VectorField3& flow,
 			double dt,
 			FaceCenteredGrid3* output,
-			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) final;
+			const ScalarField3& boundarySDF = ConstantScalarField3(std::numeric_limits<double>::max())) override;
+
+		//! Returns true if the back-traced points are cached.
+		bool GetIsUsingBackTraceCache() const;
+
+		//!
+		//! \brief Enables or disables the back-trace cache.
+		//!
+		//! When enabled, the back-traced points are computed once per data point
+		//! layout (such as cell-centers or u-faces), flow field, boundary and
+		//! time-step, and are reused by every field advected on the same layout.
+		//! Up to four layouts are kept, and the oldest one is dropped first. The
+		//! cache is keyed by the addresses of the flow and boundary fields, so
+		//! it should be cleared whenever their values change. Default is false.
+		//!
+		void SetIsUsingBackTraceCache(bool isUsing);
+
+		//! Clears the back-trace cache and releases its memory.
+		void ClearBackTraceCache();
 
 	protected:
+		//! Back-traced points of the data points of a grid layout.
+		struct BackTracedPoints
+		{
+			//! Back-traced point of each data point.
+			Array3<Vector3D> points;
+
+			//! Non-zero if the data point is outside the boundary and advected.
+			Array3<char> isAdvected;
+		};
+
+		//!
+		//! \brief Returns the back-traced points of the given data point layout.
+		//!
+		//! This function returns the cached points if the back-trace cache is
+		//! enabled and already holds the layout; otherwise, the points are
+		//! computed in parallel, and cached if enabled.
+		//!
+		std::shared_ptr<const BackTracedPoints> GetBackTracedPoints(
+			const VectorField3& flow,
+			double dt,
+			double h,
+			const Size3& dataSize,
+			const Vector3D& dataOrigin,
+			const Vector3D& gridSpacing,
+			const ScalarField3& boundarySDF);
+
 		//!
 		//! \brief Returns spatial interpolation function object for given scalar grid.
 		//!
@@ -141,13 +188,34 @@ namespace CubbyFlow
 		//!
 		virtual std::function<Vector3D(const Vector3D&)> GetVectorSamplerFunc(const FaceCenteredGrid3& input) const;
 
-	private:
+		//!
+		//! \brief Traces the flow backward from the given point.
+		//!
+		//! This function traces the flow \p flow backward in time by \p dt from
+		//! \p pt0 using the mid-point rule with sub-steps of CFL <= 1, and stops
+		//! at the boundary interface. A negative \p dt traces the flow forward.
+		//!
 		Vector3D BackTrace(
 			const VectorField3& flow,
 			double dt,
 			double h,
 			const Vector3D& pt0,
 			const ScalarField3& boundarySDF) const;
+
+	private:
+		struct BackTraceCacheEntry
+		{
+			const VectorField3* flow;
+			const ScalarField3* boundarySDF;
+			double dt;
+			Size3 dataSize;
+			Vector3D dataOrigin;
+			Vector3D gridSpacing;
+			std::shared_ptr<BackTracedPoints> points;
+		};
+
+		bool m_isUsingBackTraceCache = false;
+		std::deque<BackTraceCacheEntry> m_backTraceCache;
 	};
 
 	using SemiLagrangian3Ptr = std::shared_ptr<SemiLagrangian3>;
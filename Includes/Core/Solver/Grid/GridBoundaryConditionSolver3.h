@@ -60,6 +60,29 @@ namespace CubbyFlow
 		//! Sets the closed domain boundary flag.
 		void SetClosedDomainBoundaryFlag(int flag);
 
+		//! Returns true if the collider SDF is cached between updates.
+		bool GetIsCachingColliderSDF() const;
+
+		//!
+		//! \brief Enables or disables caching of the collider SDF.
+		//!
+		//! When enabled, solvers that support it skip or limit the
+		//! rasterization of a collider whose surface has only moved. Changes
+		//! that do not show in the transform of the collider surface, such as a
+		//! mesh edited in place or a moving child of a surface set, are not
+		//! detected; call InvalidateColliderSDF after such changes. Default is
+		//! false.
+		//!
+		void SetIsCachingColliderSDF(bool isCaching);
+
+		//!
+		//! \brief Marks the cached collider SDF as outdated.
+		//!
+		//! The next update rasterizes the collider from scratch. Does nothing
+		//! for solvers that do not cache the collider SDF.
+		//!
+		virtual void InvalidateColliderSDF();
+
 		//!
 		//! Constrains the velocity field to conform the collider boundary.
 		//!
@@ -99,6 +122,7 @@ namespace CubbyFlow
 		Vector3D m_gridSpacing;
 		Vector3D m_gridOrigin;
 		int m_closedDomainBoundaryFlag = DIRECTION_ALL;
+		bool m_isCachingColliderSDF = false;
 	};
 
 	//! Shared pointer type for the GridBoundaryConditionSolver3.
@@ -18,6 +18,8 @@
 #include <Core/Solver/Grid/GridDiffusionSolver3.h>
 #include <Core/Solver/Grid/GridPressureSolver3.h>
 
+#include <limits>
+
 namespace CubbyFlow
 {
 	//!
@@ -110,6 +112,30 @@ namespace CubbyFlow
 		//! Sets the closed domain boundary flag.
 		void SetClosedDomainBoundaryFlag(int flag);
 
+		//! Returns true if the collider SDF is cached between time-steps.
+		bool GetIsCachingColliderSDF() const;
+
+		//!
+		//! \brief Enables or disables caching of the collider SDF.
+		//!
+		//! When enabled, the boundary condition solver only rasterizes the
+		//! collider again when its surface moves, if it supports caching.
+		//! Changes that do not show in the transform of the collider surface,
+		//! such as a mesh edited in place or a moving child of a surface set,
+		//! require a call to InvalidateColliderSDF. Default is false.
+		//!
+		//! \see GridBoundaryConditionSolver3::SetIsCachingColliderSDF
+		//!
+		void SetIsCachingColliderSDF(bool isCaching);
+
+		//!
+		//! \brief Marks the cached collider SDF as outdated.
+		//!
+		//! Call this function after changing the collider surface in place, so
+		//! the next time-step rasterizes the collider from scratch.
+		//!
+		void InvalidateColliderSDF() const;
+
 		//!
 		//! \brief Returns the grid system data.
 		//!
@@ -138,6 +164,76 @@ namespace CubbyFlow
 			const Vector3D& newGridSpacing,
 			const Vector3D& newGridOrigin) const;
 
+		//!
+		//! \brief Resizes grid system data and moves its origin by whole cells.
+		//!
+		//! This function resizes grid system data while preserving the data in
+		//! the region overlapping with the old grids. The grid spacing is kept.
+		//!
+		//! \param[in] newSize      The new size.
+		//! \param[in] originOffset The offset of the new origin in cells.
+		//!
+		//! \see GridSystemData3::ResizeAndShift
+		//!
+		void ResizeAndShiftGrid(const Size3& newSize, const Point3I& originOffset) const;
+
+		//! Returns true if the domain grows to keep the content inside.
+		bool GetIsUsingAutoResize() const;
+
+		//!
+		//! \brief Enables or disables the auto-resizing domain.
+		//!
+		//! When enabled, the domain grows by whole bricks at the beginning of
+		//! each time-step once the content comes within a brick of its boundary,
+		//! up to the max resolution. The content is where any advectable scalar
+		//! data, such as the smoke density, is larger than the threshold, or
+		//! where the fluid SDF is negative if it is advectable scalar data. The
+		//! velocity is not considered, so the domain does not chase the flow
+		//! induced by the pressure solver. Default is false.
+		//!
+		void SetIsUsingAutoResize(bool isUsing);
+
+		//! Returns the brick size of the domain updates in cells.
+		size_t GetDomainBrickSize() const;
+
+		//!
+		//! \brief Sets the brick size of the domain updates in cells.
+		//!
+		//! The auto-resizing domain grows and the moving window moves by the
+		//! multiple of this size, so the domain is not updated at every
+		//! time-step. Default is 8. The input value should be positive.
+		//!
+		void SetDomainBrickSize(size_t brickSize);
+
+		//! Returns the threshold of the content for the auto-resizing domain.
+		double GetAutoResizeThreshold() const;
+
+		//!
+		//! \brief Sets the threshold of the content for the auto-resizing domain.
+		//!
+		//! Default is 0.001. The input value should be non-negative.
+		//!
+		void SetAutoResizeThreshold(double threshold);
+
+		//! Returns the max resolution of the auto-resizing domain.
+		const Size3& GetMaxResolution() const;
+
+		//! Sets the max resolution of the auto-resizing domain.
+		void SetMaxResolution(const Size3& maxResolution);
+
+		//! Returns the surface that the domain follows.
+		const Surface3Ptr& GetMovingWindowTarget() const;
+
+		//!
+		//! \brief Sets the surface that the domain follows.
+		//!
+		//! When set, the domain moves by whole bricks at the beginning of each
+		//! time-step so that the center of the bounding box of the surface stays
+		//! within a brick of the center of the domain. The resolution is kept,
+		//! and the data leaving the domain is dropped. Set nullptr to disable.
+		//!
+		void SetMovingWindowTarget(const Surface3Ptr& target);
+
 		//!
 		//! \brief Returns the resolution of the grid system data.
 		//!
@@ -243,6 +339,15 @@ namespace CubbyFlow
 		//!
 		virtual ScalarField3Ptr GetFluidSDF() const;
 
+		//!
+		//! \brief Returns the signed-distance field of the advection boundary.
+		//!
+		//! The data points inside this boundary keep their values during the
+		//! advection, and the back-tracing stops at it. By default, this will
+		//! return the collider SDF.
+		//!
+		virtual ScalarField3Ptr GetAdvectionBoundarySDF() const;
+
 		//! Computes the gravity term.
 		void ComputeGravity(double timeIntervalInSeconds);
 
@@ -275,6 +380,12 @@ namespace CubbyFlow
 		double m_maxCFL = 5.0;
 		bool m_useCompressedLinearSys = false;
 		int m_closedDomainBoundaryFlag = DIRECTION_ALL;
+		bool m_isCachingColliderSDF = false;
+		bool m_isUsingAutoResize = false;
+		size_t m_domainBrickSize = 8;
+		double m_autoResizeThreshold = 0.001;
+		Size3 m_maxResolution{ std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max() };
+		Surface3Ptr m_movingWindowTarget;
 
 		GridSystemData3Ptr m_grids;
 		Collider3Ptr m_collider;
@@ -285,6 +396,8 @@ namespace CubbyFlow
 		GridPressureSolver3Ptr m_pressureSolver;
 		GridBoundaryConditionSolver3Ptr m_boundaryConditionSolver;
 
+		void UpdateDomain() const;
+
 		void BeginAdvanceTimeStep(double timeIntervalInSeconds);
 
 		void EndAdvanceTimeStep(double timeIntervalInSeconds);
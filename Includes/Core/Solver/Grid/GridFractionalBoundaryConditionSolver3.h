@@ -13,6 +13,7 @@
 #include <Core/Field/CustomVectorField3.h>
 #include <Core/Grid/CellCenteredScalarGrid3.h>
 #include <Core/Solver/Grid/GridBoundaryConditionSolver3.h>
+#include <Core/Surface/ImplicitSurface3.h>
 
 namespace CubbyFlow
 {
@@ -24,6 +25,14 @@ namespace CubbyFlow
 	//! should pair up with GridFractionalSinglePhasePressureSolver3 to provide
 	//! sub-grid resolution velocity projection.
 	//!
+	//! By default, the collider SDF is rasterized at every update. With
+	//! caching enabled, it is rasterized from scratch only when the collider,
+	//! its surface or the grid changes, or after InvalidateColliderSDF. A
+	//! collider that keeps its transform is not rasterized again. When only
+	//! the transform of the surface changes, the SDF is resampled from a copy
+	//! cached in the local frame of the surface, and only within the region
+	//! swept by the bounding box of the surface.
+	//!
 	class GridFractionalBoundaryConditionSolver3 : public GridBoundaryConditionSolver3
 	{
 	public:
@@ -50,6 +59,9 @@ namespace CubbyFlow
 		//! Returns the velocity field of the collider.
 		VectorField3Ptr GetColliderVelocityField() const override;
 
+		//! Marks the cached collider SDF as outdated.
+		void InvalidateColliderSDF() override;
+
 	protected:
 		//! Invoked when a new collider is set.
 		void OnColliderUpdated(
@@ -60,6 +72,29 @@ namespace CubbyFlow
 	private:
 		CellCenteredScalarGrid3Ptr m_colliderSDF;
 		CustomVectorField3Ptr m_colliderVel;
+
+		ImplicitSurface3Ptr m_colliderSurface;
+
+		//! SDF of the collider surface in its local frame. Null if the surface
+		//! is unbounded or much larger than the grid.
+		CellCenteredScalarGrid3Ptr m_localColliderSDF;
+
+		//! State of the last rasterization.
+		Collider3Ptr m_lastCollider;
+		Surface3Ptr m_lastSurface;
+		Transform3 m_lastTransform;
+		BoundingBox3D m_lastBoundingBox;
+		bool m_isColliderSDFValid = false;
+
+		//! Upper bound of the error outside the updated regions, which is the
+		//! distance moved by the surface since the last full update.
+		double m_staleDistance = 0.0;
+
+		void BuildLocalColliderSDF(const Vector3D& gridSpacing);
+
+		double SampleLocalColliderSDF(const Vector3D& pt) const;
+
+		void UpdateColliderSDF(const BoundingBox3D& region, bool isUsingLocalSDF);
 	};
 
 	//! Shared pointer type for the GridFractionalBoundaryConditionSolver3.
@@ -11,6 +11,7 @@
 #define CUBBYFLOW_FRACTIONAL_SINGLE_PHASE_PRESSURE_SOLVER3_H
 
 #include <Core/FDM/FDMMGLinearSystem3.h>
+#include <Core/Math/FixedPoint.h>
 #include <Core/Solver/FDM/FDMLinearSystemSolver3.h>
 #include <Core/Solver/FDM/FDMMGSolver3.h>
 #include <Core/Solver/Grid/GridPressureSolver3.h>
@@ -107,9 +108,10 @@ namespace CubbyFlow
 		FDMMGLinearSystem3 m_mgSystem;
 		FDMMGSolver3Ptr m_mgSystemSolver;
 
-		std::vector<Array3<float>> m_uWeights;
-		std::vector<Array3<float>> m_vWeights;
-		std::vector<Array3<float>> m_wWeights;
+		//! Fractional face weights in [0, 1] stored as 16-bit fixed-point numbers.
+		std::vector<Array3<FixedPoint16>> m_uWeights;
+		std::vector<Array3<FixedPoint16>> m_vWeights;
+		std::vector<Array3<FixedPoint16>> m_wWeights;
 		std::vector<Array3<float>> m_fluidSDF;
 
 		std::function<Vector3D(const Vector3D&)> m_boundaryVel;
@@ -10,7 +10,12 @@
 #ifndef CUBBYFLOW_GRID_SMOKE_SOLVER3_H
 #define CUBBYFLOW_GRID_SMOKE_SOLVER3_H
 
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/Point/Point3.h>
 #include <Core/Solver/Grid/GridFluidSolver3.h>
+#include <Core/Utils/Parallel.h>
+
+#include <vector>
 
 namespace CubbyFlow
 {
@@ -154,6 +159,50 @@ namespace CubbyFlow
 		//!
 		void SetTemperatureDecayFactor(double newValue);
 
+		//! Returns true if the simulation is restricted to the active region.
+		bool GetIsUsingActiveRegion() const;
+
+		//!
+		//! \brief      Enables or disables the active region.
+		//!
+		//! When enabled, the domain is divided into cubic bricks and only the
+		//! active bricks are simulated. The bricks with non-negligible smoke
+		//! density or temperature are activated and dilated by the distance the
+		//! flow travels in a sub-time-step plus a cell, and the active bricks
+		//! with non-negligible velocity stay active. Buoyancy, decay, diffusion,
+		//! and advection only update the active bricks, and the pressure is
+		//! solved for the active cells with zero pressure outside, like the open
+		//! boundary of a liquid. Use it with the compressed linear system so that
+		//! the linear systems only contain the active cells. Default is false.
+		//!
+		//! \param[in]  isUsing True to enable the active region.
+		//!
+		//! \see GridFluidSolver3::SetUseCompressedLinearSystem
+		//!
+		void SetIsUsingActiveRegion(bool isUsing);
+
+		//! Returns the size of the active region bricks in cells.
+		size_t GetActiveRegionBrickSize() const;
+
+		//! Sets the size of the active region bricks in cells. Default is 8.
+		void SetActiveRegionBrickSize(size_t newSize);
+
+		//! Returns the threshold of the values which activate a brick.
+		double GetActiveRegionThreshold() const;
+
+		//!
+		//! \brief      Sets the threshold of the values which activate a brick.
+		//!
+		//! The threshold applies to the absolute smoke density, temperature, and
+		//! velocity components of the cells in a brick. Default is 0.001.
+		//!
+		//! \param[in]  newValue The new threshold.
+		//!
+		void SetActiveRegionThreshold(double newValue);
+
+		//! Returns the number of cells in the active region of the last time-step.
+		size_t GetNumberOfActiveCells() const;
+
 		//! Returns smoke density field.
 		ScalarGrid3Ptr GetSmokeDensity() const;
 
@@ -164,10 +213,16 @@ namespace CubbyFlow
 		static Builder GetBuilder();
 
 	protected:
+		void OnBeginAdvanceTimeStep(double timeIntervalInSeconds) override;
+
 		void OnEndAdvanceTimeStep(double timeIntervalInSeconds) override;
 
 		void ComputeExternalForces(double timeIntervalInSeconds) override;
 
+		ScalarField3Ptr GetFluidSDF() const override;
+
+		ScalarField3Ptr GetAdvectionBoundarySDF() const override;
+
 	private:
 		size_t m_smokeDensityDataID = 0;
 		size_t m_temperatureDataID = 0;
@@ -178,9 +233,32 @@ namespace CubbyFlow
 		double m_smokeDecayFactor = 0.001;
 		double m_temperatureDecayFactor = 0.001;
 
+		bool m_isUsingActiveRegion = false;
+		size_t m_activeRegionBrickSize = 8;
+		double m_activeRegionThreshold = 0.001;
+
+		//! Active flags of the bricks and the list of the active bricks.
+		Array3<char> m_activeBricks;
+		std::vector<Point3UI> m_activeBrickList;
+
+		//! Negative inside the active cells and positive outside.
+		CellCenteredScalarGrid3Ptr m_activeRegionSDF;
+
 		void ComputeDiffusion(double timeIntervalInSeconds);
 
 		void ComputeBuoyancyForce(double timeIntervalInSeconds);
+
+		void UpdateActiveRegion(double timeIntervalInSeconds);
+
+		//!
+		//! Invokes \p func for each data point of a grid in the active region. The
+		//! data points are cells if \p faceDirection is zero, or the faces normal
+		//! to it otherwise. Without the active region, all data points are visited.
+		//!
+		void ForEachActiveIndex(
+			const Size3& faceDirection,
+			const std::function<void(size_t, size_t, size_t)>& func,
+			ExecutionPolicy policy = ExecutionPolicy::Parallel) const;
 	};
 
 	//! Shared pointer type for the GridSmokeSolver3.
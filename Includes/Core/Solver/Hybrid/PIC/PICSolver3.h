@@ -14,6 +14,9 @@
 #include <Core/Particle/ParticleSystemData3.h>
 #include <Core/Solver/Grid/GridFluidSolver3.h>
 
+#include <functional>
+#include <random>
+
 namespace CubbyFlow
 {
 	//!
@@ -55,6 +58,79 @@ namespace CubbyFlow
 		//! Sets the particle emitter.
 		void SetParticleEmitter(const ParticleEmitter3Ptr& newEmitter);
 
+		//! Returns true if the narrow-band mode is enabled.
+		bool GetIsUsingNarrowBand() const;
+
+		//!
+		//! \brief Enables or disables the narrow-band mode.
+		//!
+		//! When enabled, the particles are kept only within a narrow band below
+		//! the liquid surface, and the deep interior is represented by a liquid
+		//! level set and a velocity field advected on the grid. The grid
+		//! velocity fills the faces without particles inside the level set, and
+		//! the signed-distance field combines the particles with the level set.
+		//! At the beginning of each time-step, the particles deeper than the band
+		//! are deleted, and the band cells without particles are seeded with
+		//! eight particles that take the grid velocity. Default is false.
+		//!
+		//! \see Ferstl et al., Narrow band FLIP for liquid simulations,
+		//!      Computer Graphics Forum 35(2), 2016.
+		//!
+		void SetIsUsingNarrowBand(bool isUsing);
+
+		//! Returns the width of the narrow band in grid cells.
+		double GetNarrowBandWidth() const;
+
+		//!
+		//! \brief Sets the width of the narrow band in grid cells.
+		//!
+		//! Default is 3. The width is clamped to be at least one cell.
+		//!
+		void SetNarrowBandWidth(double width);
+
+		//!
+		//! \brief Returns the liquid level set of the narrow-band mode.
+		//!
+		//! This function returns nullptr if the narrow-band mode has never been
+		//! enabled.
+		//!
+		ScalarGrid3Ptr GetLevelSet() const;
+
+		//! Returns true if the particle reseeding is enabled.
+		bool GetIsUsingReseeding() const;
+
+		//!
+		//! \brief Enables or disables the particle reseeding.
+		//!
+		//! When enabled, the number of particles per cell is kept within the
+		//! min and max bounds at the beginning of each time-step. The particles
+		//! beyond the max count of a cell are deleted in index order, and the
+		//! fluid cells with fewer particles than the min count are seeded with
+		//! new particles that take the grid velocity. With the narrow band
+		//! enabled, only the fluid within the band is seeded. Default is false.
+		//!
+		void SetIsUsingReseeding(bool isUsing);
+
+		//! Returns the min number of particles per fluid cell.
+		size_t GetMinParticlesPerCell() const;
+
+		//!
+		//! \brief Sets the min number of particles per fluid cell.
+		//!
+		//! Default is 4. The max count is raised if it is less than this value.
+		//!
+		void SetMinParticlesPerCell(size_t count);
+
+		//! Returns the max number of particles per cell.
+		size_t GetMaxParticlesPerCell() const;
+
+		//!
+		//! \brief Sets the max number of particles per cell.
+		//!
+		//! Default is 16. The value is clamped to be at least the min count.
+		//!
+		void SetMaxParticlesPerCell(size_t count);
+
 		//! Returns builder fox PICSolver3.
 		static Builder GetBuilder();
 
@@ -63,6 +139,29 @@ namespace CubbyFlow
 		Array3<char> m_vMarkers;
 		Array3<char> m_wMarkers;
 
+		//!
+		//! \brief Fills the velocity of the narrow-band interior.
+		//!
+		//! This function copies the advected grid velocity to the faces without
+		//! particles inside the liquid level set, and marks them as valid. The
+		//! particle-to-grid transfers should call this function at the end, so
+		//! the filled velocity is part of the transferred field. This function
+		//! does nothing if the narrow-band mode is disabled.
+		//!
+		void FillNarrowBandInterior();
+
+		//!
+		//! \brief Invokes \p func for every particle in a race-free parallel order.
+		//!
+		//! The particles are binned into slabs of two cells along the z-axis,
+		//! and the even and odd slabs are processed in two parallel passes. The
+		//! trilinear stencils of two slabs with the same parity never overlap,
+		//! so \p func can scatter to the velocity grid without atomics. Each
+		//! slab visits its particles in index order, so the accumulation order
+		//! does not depend on the number of threads.
+		//!
+		void ParallelForEachParticleInSlabs(const std::function<void(size_t)>& func) const;
+
 		//! Initializes the simulator.
 		void OnInitialize() override;
 
@@ -89,10 +188,27 @@ namespace CubbyFlow
 		ParticleSystemData3Ptr m_particles;
 		ParticleEmitter3Ptr m_particleEmitter;
 
+		bool m_isUsingNarrowBand = false;
+		double m_narrowBandWidth = 3.0;
+		size_t m_levelSetID = std::numeric_limits<size_t>::max();
+		size_t m_interiorVelocityID = std::numeric_limits<size_t>::max();
+		std::mt19937 m_narrowBandRng;
+
+		bool m_isUsingReseeding = false;
+		size_t m_minParticlesPerCell = 4;
+		size_t m_maxParticlesPerCell = 16;
+		unsigned int m_reseedingStep = 0;
+
 		void ExtrapolateVelocityToAir() const;
 
 		void BuildSignedDistanceField();
 
+		void UpdateNarrowBandParticles();
+
+		void AdvectNarrowBand(double timeIntervalInSeconds) const;
+
+		void ReseedParticles();
+
 		void UpdateParticleEmitter(double timeIntervalInSeconds) const;
 	};
 
@@ -0,0 +1,178 @@
+/*************************************************************************
+> File Name: DFSPHSolver3.h
+> Project Name: CubbyFlow
+> Purpose: 3-D DFSPH solver.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#ifndef CUBBYFLOW_DFSPH_SOLVER3_H
+#define CUBBYFLOW_DFSPH_SOLVER3_H
+
+#include <Core/Solver/Particle/SPH/SPHSolver3.h>
+
+namespace CubbyFlow
+{
+	//!
+	//! \brief 3-D divergence-free SPH solver.
+	//!
+	//! This class implements 3-D divergence-free SPH solver. The pressure is
+	//! solved by two Jacobi-style velocity solvers: the divergence solver makes
+	//! the velocity field divergence-free at the beginning of the time step,
+	//! and the density solver corrects the predicted density error before the
+	//! time integration. Both solvers start from the stiffness values of the
+	//! previous time step, so a few iterations are needed in a steady flow. The
+	//! time step is bounded by the CFL condition instead of the speed of sound,
+	//! and the divergence is not corrected at the free surface.
+	//!
+	//! The solver uses the neighbor lists of the particle system with a single
+	//! kernel radius. The cell-tiled mode is ignored, and a time step throws
+	//! std::invalid_argument if the adaptive kernel of the particle system is
+	//! enabled.
+	//!
+	//! \see Bender and Koschier, Divergence-free smoothed particle
+	//!      hydrodynamics, SCA 2015.
+	//!
+	class DFSPHSolver3 : public SPHSolver3
+	{
+	public:
+		class Builder;
+
+		//! Constructs a solver with empty particle set.
+		DFSPHSolver3();
+
+		//! Constructs a solver with target density, spacing, and relative kernel radius.
+		DFSPHSolver3(double targetDensity, double targetSpacing, double relativeKernelRadius);
+
+		virtual ~DFSPHSolver3();
+
+		//! Returns max allowed average density error ratio.
+		double GetMaxDensityErrorRatio() const;
+
+		//!
+		//! \brief Sets max allowed average density error ratio.
+		//!
+		//! This function sets the max allowed average density error ratio of the
+		//! density solver. Default is 0.001 (0.1%). The input value should be
+		//! positive.
+		//!
+		void SetMaxDensityErrorRatio(double ratio);
+
+		//! Returns max allowed average divergence error ratio.
+		double GetMaxDivergenceErrorRatio() const;
+
+		//!
+		//! \brief Sets max allowed average divergence error ratio.
+		//!
+		//! This function sets the max allowed average density change ratio per
+		//! time step of the divergence solver. Default is 0.01 (1%). The input
+		//! value should be positive.
+		//!
+		void SetMaxDivergenceErrorRatio(double ratio);
+
+		//! Returns max number of iterations.
+		unsigned int GetMaxNumberOfIterations() const;
+
+		//!
+		//! \brief Sets max number of iterations.
+		//!
+		//! This function sets the max number of iterations of each solver.
+		//! Default is 100.
+		//!
+		void SetMaxNumberOfIterations(unsigned int n);
+
+		//! Returns true if the solvers are warm-started.
+		bool GetIsUsingWarmStart() const;
+
+		//!
+		//! \brief Enables or disables the warm start.
+		//!
+		//! When enabled, the density and divergence solvers first apply half
+		//! of the summed stiffness values of the previous time step to the
+		//! particles that are still compressed. Default is true.
+		//!
+		void SetIsUsingWarmStart(bool isUsing);
+
+		//! Returns the number of density solver iterations of the last time step.
+		unsigned int GetLastNumberOfDensityIterations() const;
+
+		//! Returns the number of divergence solver iterations of the last time step.
+		unsigned int GetLastNumberOfDivergenceIterations() const;
+
+		//! Returns builder fox DFSPHSolver3.
+		static Builder GetBuilder();
+
+	protected:
+		//! Returns the number of sub-time-steps.
+		unsigned int GetNumberOfSubTimeSteps(double timeIntervalInSeconds) const override;
+
+		//! Accumulates the pressure force to the forces array in the particle system.
+		void AccumulatePressureForce(double timeIntervalInSeconds) override;
+
+		//! Performs pre-processing step before the simulation.
+		void OnBeginAdvanceTimeStep(double timeStepInSeconds) override;
+
+		//! Returns false, since the solver always uses the neighbor lists.
+		bool IsCellTilingActive() const override;
+
+	private:
+		double m_maxDensityErrorRatio = 0.001;
+		double m_maxDivergenceErrorRatio = 0.01;
+		unsigned int m_maxNumberOfIterations = 100;
+		bool m_isUsingWarmStart = true;
+
+		unsigned int m_lastNumberOfDensityIterations = 0;
+		unsigned int m_lastNumberOfDivergenceIterations = 0;
+
+		//! Start of the kernel gradients of each particle.
+		Array1<size_t> m_gradientOffsets;
+
+		//! Mass times the kernel gradients of the neighbor lists.
+		Array1<Vector3D> m_gradients;
+
+		//! Inverse of the denominators of the DFSPH factors.
+		ParticleSystemData3::ScalarData m_factors;
+
+		//! DFSPH factors of the divergence solver, which are zero at the surface.
+		ParticleSystemData3::ScalarData m_divergenceFactors;
+
+		//! Stiffness values of the current solver iteration.
+		ParticleSystemData3::ScalarData m_stiffnesses;
+
+		//! Sum of the density stiffness values times the squared time step.
+		ParticleSystemData3::ScalarData m_densityStiffnesses;
+
+		//! Sum of the divergence stiffness values times the time step.
+		ParticleSystemData3::ScalarData m_divergenceStiffnesses;
+
+		ParticleSystemData3::VectorData m_tempPositions;
+		ParticleSystemData3::VectorData m_tempVelocities;
+
+		void ComputeFactors();
+
+		void CorrectDivergence(double timeStepInSeconds);
+
+		void CorrectDensityError(double timeStepInSeconds);
+
+		double ComputeDensityChangeRate(size_t i, const ConstArrayAccessor1<Vector3D>& velocities) const;
+
+		void ApplyStiffnesses(double timeStepInSeconds, const ConstArrayAccessor1<double>& stiffnesses, ArrayAccessor1<Vector3D> velocities) const;
+	};
+
+	//! Shared pointer type for the DFSPHSolver3.
+	using DFSPHSolver3Ptr = std::shared_ptr<DFSPHSolver3>;
+
+	//!
+	//! \brief Front-end to create DFSPHSolver3 objects step by step.
+	//!
+	class DFSPHSolver3::Builder final : public SPHSolverBuilderBase3<DFSPHSolver3::Builder>
+	{
+	public:
+		//! Builds DFSPHSolver3.
+		DFSPHSolver3 Build() const;
+
+		//! Builds shared pointer of DFSPHSolver3 instance.
+		DFSPHSolver3Ptr MakeShared() const;
+	};
+}
+
+#endif
@@ -10,9 +10,12 @@
 #ifndef CUBBYFLOW_SPH_SOLVER3_H
 #define CUBBYFLOW_SPH_SOLVER3_H
 
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
 #include <Core/Solver/Particle/ParticleSystemSolver3.h>
 #include <Core/SPH/SPHSystemData3.h>
 
+#include <functional>
+
 namespace CubbyFlow
 {
 	//!
@@ -114,6 +117,40 @@ namespace CubbyFlow
 		//!
 		void SetTimeStepLimitScale(double newScale);
 
+		//! Returns the skin distance of the neighbor lists.
+		double GetNeighborListSkin() const;
+
+		//!
+		//! \brief Sets the skin distance of the neighbor lists.
+		//!
+		//! With a positive skin, the solver keeps Verlet lists: the neighbor
+		//! searcher and lists are built with the kernel radius plus the skin,
+		//! and rebuilt only once a particle has moved more than half of the
+		//! skin since the last build (or particles were added). In between,
+		//! densities are updated from the lists and the kernels filter out the
+		//! neighbors beyond the kernel radius. The neighbor searcher of the
+		//! particle system is not refreshed on every sub-step in this mode.
+		//! Zero disables the lists, which is the default. Negative input will
+		//! be clamped to zero.
+		//!
+		void SetNeighborListSkin(double newSkin);
+
+		//! Returns true if the particles are processed cell by cell.
+		bool GetIsUsingCellTiling() const;
+
+		//!
+		//! \brief Enables or disables the cell-tiled execution mode.
+		//!
+		//! In this mode, the particles are binned into cells as large as the
+		//! kernel radius, and the particles of a cell are processed together
+		//! against the particles of the 27 cells around it, whose data is
+		//! gathered once into local buffers. This replaces the neighbor lists,
+		//! which are not built, so the functions of the particle system that
+		//! rely on them are not available. The neighbor lists are still used
+		//! when the adaptive kernel is enabled. Default is false.
+		//!
+		void SetIsUsingCellTiling(bool isUsing);
+
 		//! Returns the SPH system data.
 		SPHSystemData3Ptr GetSPHSystemData() const;
 
@@ -158,6 +195,60 @@ namespace CubbyFlow
 		//! Computes pseudo viscosity.
 		void ComputePseudoViscosity(double timeStepInSeconds);
 
+		//! Builds the neighbor lists and updates the densities.
+		void UpdateNeighborListsAndDensities();
+
+		//!
+		//! \brief Particles of one cell and the candidates around them.
+		//!
+		//! The candidate buffers are filled by ForEachParticleTile, and the
+		//! scratch buffers are reused from one cell to the next.
+		//!
+		struct ParticleTile
+		{
+			//! Indices of the particles in the cell.
+			std::vector<size_t> particles;
+
+			//! Indices of the particles in the cell and the cells around it.
+			std::vector<size_t> candidates;
+
+			//! Positions of the candidates.
+			std::vector<Vector3D> candidatePositions;
+
+			//! Per-candidate scalars gathered by the caller.
+			std::vector<double> candidateValues;
+
+			//! Per-candidate vectors gathered by the caller.
+			std::vector<Vector3D> candidateVectors;
+
+			//! Candidate slots found by CollectNeighbors.
+			std::vector<size_t> neighbors;
+
+			//! Squared distances to the neighbors.
+			std::vector<double> distancesSquared;
+
+			//! Distances to the neighbors, for the kernels of plain distances.
+			std::vector<double> distances;
+
+			//! Kernel values of the neighbors.
+			std::vector<double> kernelValues;
+
+			//! Collects the candidates within the radius of the origin,
+			//! except the particle with given index.
+			void CollectNeighbors(size_t index, const Vector3D& origin, double radiusSquared);
+		};
+
+		//! Returns true if the cell tiles are used instead of neighbor lists.
+		virtual bool IsCellTilingActive() const;
+
+		//!
+		//! \brief Invokes the function for each cell of the particles.
+		//!
+		//! The cells are built in UpdateNeighborListsAndDensities and processed
+		//! in parallel. The candidate positions are gathered from \p positions.
+		//!
+		void ForEachParticleTile(const ConstArrayAccessor1<Vector3D>& positions, const std::function<void(ParticleTile&)>& func) const;
+
 	private:
 		//! Exponent component of equation-of-state (or Tait's equation).
 		double m_eosExponent = 7.0;
@@ -181,6 +272,22 @@ namespace CubbyFlow
 
 		//! Scales the max allowed time-step.
 		double m_timeStepLimitScale = 1.0;
+
+		//! Skin distance of the Verlet lists. Zero means disabled.
+		double m_neighborListSkin = 0.0;
+
+		//! Search radius of the last Verlet list build. Zero means not built.
+		double m_neighborListRadius = 0.0;
+
+		//! Particle positions at the last Verlet list build.
+		Array1<Vector3D> m_neighborListPositions;
+
+		bool m_isUsingCellTiling = false;
+
+		//! Cells of the particles for the cell-tiled mode.
+		PointCompactHashGridSearcher3Ptr m_tileGrid;
+
+		bool IsNeighborListOutdated() const;
 	};
 
 	//! Shared pointer type for the SPHSolver3.
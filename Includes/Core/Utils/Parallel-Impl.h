@@ -54,6 +54,30 @@ namespace CubbyFlow
         template <typename TASK>
         using operator_return_t = typename std::result_of<TASK()>::type;
 
+        // Pins the calling worker thread to the CPU of the slot when thread
+        // affinity is enabled.
+        void BindCurrentThread(unsigned int slot);
+
+        // Returns the number of slices to split a range of size n among the
+        // threads, so that no slice is empty.
+        template <typename IndexType>
+        unsigned int GetNumberOfSlices(IndexType n, unsigned int numThreads)
+        {
+            return static_cast<unsigned int>(std::min(static_cast<unsigned long long>(n),
+                static_cast<unsigned long long>(numThreads)));
+        }
+
+        // Returns the begin of the slot-th of numSlices contiguous slices of
+        // [beginIndex, endIndex). Every loop splits its range at the same
+        // fractions, so data first touched in one loop is worked on by the
+        // same slot in the others.
+        template <typename IndexType>
+        IndexType GetSliceBegin(IndexType beginIndex, IndexType endIndex, unsigned int slot, unsigned int numSlices)
+        {
+            const unsigned long long n = static_cast<unsigned long long>(endIndex - beginIndex);
+            return beginIndex + static_cast<IndexType>(n * slot / numSlices);
+        }
+
         template <typename TASK>
         inline auto Async(TASK&& fn) -> future<operator_return_t<TASK>>
         {
@@ -229,14 +253,14 @@ namespace CubbyFlow
             const unsigned int numThreadsHint = GetMaxNumberOfThreads();
             const unsigned int numThreads = (numThreadsHint == 0u) ? 8u : numThreadsHint;
 
-            // Size of a slice for the range functions
-            IndexType n = endIndex - beginIndex + 1;
-            IndexType slice = static_cast<IndexType>(std::round(n / static_cast<double>(numThreads)));
-            slice = std::max(slice, IndexType(1));
+            // Number of contiguous slices, one per thread
+            const unsigned int numSlices = Internal::GetNumberOfSlices(endIndex - beginIndex, numThreads);
 
             // [Helper] Inner loop
-            auto launchRange = [&function](IndexType k1, IndexType k2)
+            auto launchRange = [&function](IndexType k1, IndexType k2, unsigned int slot)
             {
+                Internal::BindCurrentThread(slot);
+
                 for (IndexType k = k1; k < k2; ++k)
                 {
                     function(k);
@@ -245,20 +269,13 @@ namespace CubbyFlow
 
             // Create pool and launch jobs
             std::vector<std::thread> pool;
-            pool.reserve(numThreads);
-            IndexType i1 = beginIndex;
-            IndexType i2 = std::min(beginIndex + slice, endIndex);
-
-            for (unsigned int i = 0; i + 1 < numThreads && i1 < endIndex; ++i)
-            {
-                pool.emplace_back(launchRange, i1, i2);
-                i1 = i2;
-                i2 = std::min(i2 + slice, endIndex);
-            }
+            pool.reserve(numSlices);
 
-            if (i1 < endIndex)
+            for (unsigned int i = 0; i < numSlices; ++i)
             {
-                pool.emplace_back(launchRange, i1, endIndex);
+                pool.emplace_back(launchRange,
+                    Internal::GetSliceBegin(beginIndex, endIndex, i, numSlices),
+                    Internal::GetSliceBegin(beginIndex, endIndex, i + 1, numSlices), i);
             }
 
             // Wait for jobs to finish
@@ -273,7 +290,7 @@ namespace CubbyFlow
             (void)policy;
 
 #if defined(CUBBYFLOW_TASKING_OPENMP)
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)
 #if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
             for (ssize_t i = beginIndex; i < static_cast<ssize_t>(endIndex); ++i)
             {
@@ -320,27 +337,24 @@ namespace CubbyFlow
             const unsigned int numThreads =
                 numThreadsHint == 0u ? 8u : numThreadsHint;
 
-            // Size of a slice for the range functions
-            IndexType n = endIndex - beginIndex + 1;
-            IndexType slice = static_cast<IndexType>(
-                std::round(n / static_cast<double>(numThreads)));
-            slice = std::max(slice, IndexType(1));
+            // Number of contiguous slices, one per thread
+            const unsigned int numSlices =
+                Internal::GetNumberOfSlices(endIndex - beginIndex, numThreads);
 
             // Create pool and launch jobs
             std::vector<CubbyFlow::Internal::future<void>> pool;
-            pool.reserve(numThreads);
-            IndexType i1 = beginIndex;
-            IndexType i2 = std::min(beginIndex + slice, endIndex);
-
-            for (unsigned int i = 0; i + 1 < numThreads && i1 < endIndex; ++i) {
-                pool.emplace_back(Internal::Async([=]() { function(i1, i2); }));
-                i1 = i2;
-                i2 = std::min(i2 + slice, endIndex);
-            }
+            pool.reserve(numSlices);
+
+            for (unsigned int i = 0; i < numSlices; ++i) {
+                const IndexType i1 =
+                    Internal::GetSliceBegin(beginIndex, endIndex, i, numSlices);
+                const IndexType i2 =
+                    Internal::GetSliceBegin(beginIndex, endIndex, i + 1, numSlices);
 
-            if (i1 < endIndex) {
-                pool.emplace_back(
-                    Internal::Async([=]() { function(i1, endIndex); }));
+                pool.emplace_back(Internal::Async([=, &function]() {
+                    Internal::BindCurrentThread(i);
+                    function(i1, i2);
+                }));
             }
 
             // Wait for jobs to finish
@@ -424,6 +438,29 @@ namespace CubbyFlow
             return identity;
         }
 
+        if (policy == ExecutionPolicy::Parallel && GetIsDeterministic())
+        {
+            // Fixed partitions combined in index order
+            const IndexType chunkSize = static_cast<IndexType>(DETERMINISTIC_REDUCE_CHUNK_SIZE);
+            const IndexType numberOfChunks = (endIndex - beginIndex + chunkSize - 1) / chunkSize;
+            std::vector<Value> results(static_cast<size_t>(numberOfChunks), identity);
+
+            ParallelFor(IndexType(0), numberOfChunks, [&](IndexType chunk)
+            {
+                const IndexType k1 = beginIndex + chunk * chunkSize;
+                const IndexType k2 = std::min(k1 + chunkSize, endIndex);
+                results[static_cast<size_t>(chunk)] = function(k1, k2, identity);
+            });
+
+            Value finalResult = identity;
+            for (const Value& val : results)
+            {
+                finalResult = reduce(finalResult, val);
+            }
+
+            return finalResult;
+        }
+
         if (policy == ExecutionPolicy::Parallel)
         {
 #if defined(CUBBYFLOW_TASKING_TBB)
@@ -438,44 +475,31 @@ namespace CubbyFlow
             const unsigned int numThreadsHint = GetMaxNumberOfThreads();
             const unsigned int numThreads = (numThreadsHint == 0u) ? 8u : numThreadsHint;
 
-            // Size of a slice for the range functions
-            IndexType n = endIndex - beginIndex + 1;
-            IndexType slice = static_cast<IndexType>(std::round(n / static_cast<double>(numThreads)));
-            slice = std::max(slice, IndexType(1));
+            // Number of contiguous slices, one per thread
+            const unsigned int numSlices = Internal::GetNumberOfSlices(endIndex - beginIndex, numThreads);
 
             // Results
-            std::vector<Value> results(numThreads, identity);
+            std::vector<Value> results(numSlices, identity);
 
             // [Helper] Inner loop
             auto launchRange = [&](IndexType k1, IndexType k2, unsigned int tid)
             {
+                Internal::BindCurrentThread(tid);
                 results[tid] = function(k1, k2, identity);
             };
 
             // Create pool and launch jobs
             std::vector<CubbyFlow::Internal::future<void>> pool;
-            pool.reserve(numThreads);
-
-            IndexType i1 = beginIndex;
-            IndexType i2 = std::min(beginIndex + slice, endIndex);
-            unsigned int threadID = 0;
+            pool.reserve(numSlices);
 
-            for (; threadID + 1 < numThreads && i1 < endIndex; ++threadID)
+            for (unsigned int threadID = 0; threadID < numSlices; ++threadID)
             {
-                pool.emplace_back(Internal::Async([=]()
-                {
-                    launchRange(i1, i2, threadID);
-                }));
+                const IndexType i1 = Internal::GetSliceBegin(beginIndex, endIndex, threadID, numSlices);
+                const IndexType i2 = Internal::GetSliceBegin(beginIndex, endIndex, threadID + 1, numSlices);
 
-                i1 = i2;
-                i2 = std::min(i2 + slice, endIndex);
-            }
-
-            if (i1 < endIndex)
-            {
                 pool.emplace_back(Internal::Async([=]()
                 {
-                    launchRange(i1, endIndex, threadID);
+                    launchRange(i1, i2, threadID);
                 }));
             }
 
@@ -10,11 +10,16 @@
 #ifndef CUBBYFLOW_PARALLEL_H
 #define CUBBYFLOW_PARALLEL_H
 
+#include <cstddef>
+
 namespace CubbyFlow
 {
 	//! Execution policy tag.
 	enum class ExecutionPolicy { Serial, Parallel };
 
+	//! Number of elements per partition of a reduce in deterministic mode.
+	constexpr size_t DETERMINISTIC_REDUCE_CHUNK_SIZE = 4096;
+
 	//!
 	//! \brief      Fills from \p begin to \p end with \p value in parallel.
 	//!
@@ -192,7 +197,10 @@ namespace CubbyFlow
 	//! \brief      Performs reduce operation in parallel.
 	//!
 	//! This function reduces the series of values into a single value using the
-	//! provided reduce function.
+	//! provided reduce function. In deterministic mode, the range is split into
+	//! fixed partitions of DETERMINISTIC_REDUCE_CHUNK_SIZE elements whose
+	//! results are combined in index order, so the result is bitwise identical
+	//! regardless of the number of threads and the scheduling.
 	//!
 	//! \param[in]  beginIndex The begin index.
 	//! \param[in]  endIndex   The end index.
@@ -254,6 +262,35 @@ namespace CubbyFlow
 
 	//! Returns maximum number of threads to use.
 	unsigned int GetMaxNumberOfThreads();
+
+	//!
+	//! \brief Enables or disables the deterministic execution mode.
+	//!
+	//! When enabled, the parallel operations whose result depends on the order
+	//! of floating-point operations, such as ParallelReduce, use a partition
+	//! that only depends on the input range, so reruns are bit-identical on any
+	//! number of cores. Default is false.
+	//!
+	void SetIsDeterministic(bool isDeterministic);
+
+	//! Returns true if the deterministic execution mode is enabled.
+	bool GetIsDeterministic();
+
+	//!
+	//! \brief Enables or disables pinning the worker threads to CPUs.
+	//!
+	//! The parallel loops split a range into contiguous slices at fixed
+	//! fractions, one per thread. When enabled, the thread that runs the i-th
+	//! slice is pinned to the i-th CPU the process may run on, so the same part
+	//! of an array, such as a band of k-slabs of a grid, is first touched and
+	//! later processed on the same core and NUMA node in every loop. This is
+	//! supported with the C++11 thread and OpenMP tasking systems on Linux, and
+	//! does nothing otherwise. Default is false.
+	//!
+	void SetIsUsingThreadAffinity(bool isUsing);
+
+	//! Returns true if the worker threads are pinned to CPUs.
+	bool GetIsUsingThreadAffinity();
 }
 
 #include <Core/Utils/Parallel-Impl.h>
@@ -11,6 +11,7 @@
 #define CUBBYFLOW_VECTORN_IMPL_H
 
 #include <Core/Math/MathUtils.h>
+#include <Core/Matrix/MatrixGEMM.h>
 #include <Core/Utils/Parallel.h>
 
 namespace CubbyFlow
@@ -83,10 +84,21 @@ namespace CubbyFlow
 	template <typename E>
 	void VectorN<T>::Set(const VectorExpression<T, E>& other)
 	{
+		const E& expression = other();
+
+		if constexpr (IsMatrixVectorMul<E>::value)
+		{
+			// Evaluate into a temporary, since either operand may refer to
+			// this vector
+			ContainerType result(expression.size());
+			EvaluateMatrixVectorMul(expression, result.data());
+			std::swap(result, m_elements);
+			return;
+		}
+
 		Resize(other.size());
 
 		// Parallel evaluation of the expression
-		const E& expression = other();
 		ParallelForEachIndex([&](size_t i) { m_elements[i] = expression[i]; });
 	}
 
@@ -0,0 +1,223 @@
+/*************************************************************************
+> File Name: ArrayAllocator.cpp
+> Project Name: CubbyFlow
+> Purpose: Aligned, pooled allocator for the array storage.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/Array/ArrayAllocator.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace CubbyFlow
+{
+	namespace
+	{
+		struct PoolState
+		{
+			std::mutex mutex;
+			std::unordered_map<size_t, std::vector<void*>> freeLists;
+			size_t pooledBytes = 0;
+			size_t maxPooledBytes = size_t(512) << 20;
+			size_t numberOfFreshBlocks = 0;
+			size_t numberOfRecycledBlocks = 0;
+			bool isPooling = false;
+			bool isUsingHugePages = false;
+		};
+
+		// Never destroyed, so arrays with static storage duration can still
+		// release their blocks at exit.
+		PoolState& GetPoolState()
+		{
+			static PoolState* state = new PoolState();
+			return *state;
+		}
+
+		// Rounds up to a quarter step between two powers of two, which wastes
+		// at most 25% while letting slightly different sizes share blocks.
+		size_t GetSizeClass(size_t bytes)
+		{
+			size_t powerOfTwo = ARRAY_POOL_MIN_BLOCK_BYTES;
+			while (powerOfTwo <= bytes / 2)
+			{
+				powerOfTwo *= 2;
+			}
+
+			const size_t step = powerOfTwo / 4;
+			return (bytes + step - 1) / step * step;
+		}
+
+		void FreeLargeBlock(void* ptr)
+		{
+			::operator delete(ptr, std::align_val_t(ARRAY_POOL_BLOCK_ALIGNMENT));
+		}
+	}
+
+	void* ArrayMemoryPool::Allocate(size_t bytes)
+	{
+		if (bytes < ARRAY_POOL_MIN_BLOCK_BYTES)
+		{
+			return ::operator new(bytes, std::align_val_t(ARRAY_ALIGNMENT));
+		}
+
+		PoolState& state = GetPoolState();
+		const size_t sizeClass = GetSizeClass(bytes);
+		bool isUsingHugePages;
+
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			auto iter = state.freeLists.find(sizeClass);
+			if (iter != state.freeLists.end() && !iter->second.empty())
+			{
+				void* ptr = iter->second.back();
+				iter->second.pop_back();
+				state.pooledBytes -= sizeClass;
+				++state.numberOfRecycledBlocks;
+				return ptr;
+			}
+
+			++state.numberOfFreshBlocks;
+			isUsingHugePages = state.isUsingHugePages;
+		}
+
+		void* ptr = ::operator new(sizeClass, std::align_val_t(ARRAY_POOL_BLOCK_ALIGNMENT));
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if (isUsingHugePages)
+		{
+			madvise(ptr, sizeClass, MADV_HUGEPAGE);
+		}
+#else
+		(void)isUsingHugePages;
+#endif
+
+		return ptr;
+	}
+
+	void ArrayMemoryPool::Deallocate(void* ptr, size_t bytes)
+	{
+		if (ptr == nullptr)
+		{
+			return;
+		}
+
+		if (bytes < ARRAY_POOL_MIN_BLOCK_BYTES)
+		{
+			::operator delete(ptr, std::align_val_t(ARRAY_ALIGNMENT));
+			return;
+		}
+
+		PoolState& state = GetPoolState();
+		const size_t sizeClass = GetSizeClass(bytes);
+
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+
+			if (state.isPooling && state.pooledBytes + sizeClass <= state.maxPooledBytes)
+			{
+				state.freeLists[sizeClass].push_back(ptr);
+				state.pooledBytes += sizeClass;
+				return;
+			}
+		}
+
+		FreeLargeBlock(ptr);
+	}
+
+	void ArrayMemoryPool::Clear()
+	{
+		PoolState& state = GetPoolState();
+		std::unordered_map<size_t, std::vector<void*>> freeLists;
+
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			freeLists.swap(state.freeLists);
+			state.pooledBytes = 0;
+		}
+
+		for (auto& freeList : freeLists)
+		{
+			for (void* ptr : freeList.second)
+			{
+				FreeLargeBlock(ptr);
+			}
+		}
+	}
+
+	bool ArrayMemoryPool::GetIsPooling()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.isPooling;
+	}
+
+	void ArrayMemoryPool::SetIsPooling(bool isPooling)
+	{
+		{
+			PoolState& state = GetPoolState();
+			std::lock_guard<std::mutex> lock(state.mutex);
+			state.isPooling = isPooling;
+		}
+
+		if (!isPooling)
+		{
+			Clear();
+		}
+	}
+
+	size_t ArrayMemoryPool::GetMaxPooledBytes()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.maxPooledBytes;
+	}
+
+	void ArrayMemoryPool::SetMaxPooledBytes(size_t bytes)
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.maxPooledBytes = bytes;
+	}
+
+	bool ArrayMemoryPool::GetIsUsingHugePages()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.isUsingHugePages;
+	}
+
+	void ArrayMemoryPool::SetIsUsingHugePages(bool isUsing)
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.isUsingHugePages = isUsing;
+	}
+
+	size_t ArrayMemoryPool::GetPooledBytes()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.pooledBytes;
+	}
+
+	size_t ArrayMemoryPool::GetNumberOfFreshBlocks()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.numberOfFreshBlocks;
+	}
+
+	size_t ArrayMemoryPool::GetNumberOfRecycledBlocks()
+	{
+		PoolState& state = GetPoolState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		return state.numberOfRecycledBlocks;
+	}
+}
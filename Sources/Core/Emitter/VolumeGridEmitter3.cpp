@@ -13,6 +13,9 @@
 #include <Core/LevelSet/LevelSetUtils.h>
 #include <Core/Surface/SurfaceToImplicit3.h>
 #include <Core/Utils/Macros.h>
+#include <Core/Utils/Parallel.h>
+
+#include <deque>
 
 namespace CubbyFlow
 {
@@ -93,18 +96,48 @@ namespace CubbyFlow
 
 		m_sourceRegion->UpdateQueryEngine();
 
+		// The signed distances are evaluated once per data layout and shared by
+		// all targets with the same layout, such as the density and temperature
+		// grids of a smoke solver.
+		std::deque<SourceSDF> sdfs;
+		const auto getSDF = [&](const Size3& size, const Vector3D& origin, const Vector3D& gridSpacing) -> const Array3<double>&
+		{
+			for (const auto& sdf : sdfs)
+			{
+				if (sdf.size == size && sdf.origin == origin && sdf.gridSpacing == gridSpacing)
+				{
+					return sdf.data;
+				}
+			}
+
+			sdfs.push_back({ size, origin, gridSpacing, Array3<double>(size) });
+			Array3<double>& data = sdfs.back().data;
+
+			ParallelFor(
+				ZERO_SIZE, size.x,
+				ZERO_SIZE, size.y,
+				ZERO_SIZE, size.z,
+				[&](size_t i, size_t j, size_t k)
+			{
+				data(i, j, k) = m_sourceRegion->SignedDistance(origin + gridSpacing * Vector3D({ i, j, k }));
+			});
+
+			return data;
+		};
+
 		for (const auto& target : m_customScalarTargets)
 		{
 			const auto& grid = std::get<0>(target);
 			const auto& mapper = std::get<1>(target);
 
 			auto pos = grid->GetDataPosition();
+			const Array3<double>& sdf = getSDF(grid->GetDataSize(), grid->GetDataOrigin(), grid->GridSpacing());
+
 			grid->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
 			{
 				Vector3D gx = pos(i, j, k);
-				double sdf = GetSourceRegion()->SignedDistance(gx);
 
-				(*grid)(i, j, k) = mapper(sdf, gx, (*grid)(i, j, k));
+				(*grid)(i, j, k) = mapper(sdf(i, j, k), gx, (*grid)(i, j, k));
 			});
 		}
 
@@ -117,14 +150,15 @@ namespace CubbyFlow
 			if (collocated != nullptr)
 			{
 				auto pos = collocated->GetDataPosition();
+				const Array3<double>& sdf = getSDF(collocated->GetDataSize(), collocated->GetDataOrigin(), collocated->GridSpacing());
+
 				collocated->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
 				{
 					Vector3D gx = pos(i, j, k);
-					double sdf = GetSourceRegion()->SignedDistance(gx);
 
-					if (IsInsideSDF(sdf))
+					if (IsInsideSDF(sdf(i, j, k)))
 					{
-						(*collocated)(i, j, k) = mapper(sdf, gx, (*collocated)(i, j, k));
+						(*collocated)(i, j, k) = mapper(sdf(i, j, k), gx, (*collocated)(i, j, k));
 					}
 				});
 
@@ -137,33 +171,34 @@ namespace CubbyFlow
 				auto uPos = faceCentered->GetUPosition();
 				auto vPos = faceCentered->GetVPosition();
 				auto wPos = faceCentered->GetWPosition();
+				const Vector3D& h = faceCentered->GridSpacing();
 
+				const Array3<double>& uSDF = getSDF(faceCentered->GetUSize(), faceCentered->GetUOrigin(), h);
 				faceCentered->ParallelForEachUIndex([&](size_t i, size_t j, size_t k)
 				{
 					Vector3D gx = uPos(i, j, k);
-					double sdf = GetSourceRegion()->SignedDistance(gx);
 					Vector3D oldVal = faceCentered->Sample(gx);
-					Vector3D newVal = mapper(sdf, gx, oldVal);
+					Vector3D newVal = mapper(uSDF(i, j, k), gx, oldVal);
 
 					faceCentered->GetU(i, j, k) = newVal.x;
 				});
 
+				const Array3<double>& vSDF = getSDF(faceCentered->GetVSize(), faceCentered->GetVOrigin(), h);
 				faceCentered->ParallelForEachVIndex([&](size_t i, size_t j, size_t k)
 				{
 					Vector3D gx = vPos(i, j, k);
-					double sdf = GetSourceRegion()->SignedDistance(gx);
 					Vector3D oldVal = faceCentered->Sample(gx);
-					Vector3D newVal = mapper(sdf, gx, oldVal);
+					Vector3D newVal = mapper(vSDF(i, j, k), gx, oldVal);
 
 					faceCentered->GetV(i, j, k) = newVal.y;
 				});
 
+				const Array3<double>& wSDF = getSDF(faceCentered->GetWSize(), faceCentered->GetWOrigin(), h);
 				faceCentered->ParallelForEachWIndex([&](size_t i, size_t j, size_t k)
 				{
 					Vector3D gx = wPos(i, j, k);
-					double sdf = GetSourceRegion()->SignedDistance(gx);
 					Vector3D oldVal = faceCentered->Sample(gx);
-					Vector3D newVal = mapper(sdf, gx, oldVal);
+					Vector3D newVal = mapper(wSDF(i, j, k), gx, oldVal);
 
 					faceCentered->GetW(i, j, k) = newVal.z;
 				});
@@ -11,57 +11,19 @@
 namespace CubbyFlow {
 namespace fbs {
 
-struct PointKdTreeSearcherNode3;
-
 struct PointKdTreeSearcher3;
 
-MANUALLY_ALIGNED_STRUCT(8) PointKdTreeSearcherNode3 FLATBUFFERS_FINAL_CLASS {
- private:
-  uint64_t flags_;
-  uint64_t child_;
-  uint64_t item_;
-
- public:
-  PointKdTreeSearcherNode3() {
-    memset(this, 0, sizeof(PointKdTreeSearcherNode3));
-  }
-  PointKdTreeSearcherNode3(const PointKdTreeSearcherNode3 &_o) {
-    memcpy(this, &_o, sizeof(PointKdTreeSearcherNode3));
-  }
-  PointKdTreeSearcherNode3(uint64_t _flags, uint64_t _child, uint64_t _item)
-      : flags_(flatbuffers::EndianScalar(_flags)),
-        child_(flatbuffers::EndianScalar(_child)),
-        item_(flatbuffers::EndianScalar(_item)) {
-  }
-  uint64_t flags() const {
-    return flatbuffers::EndianScalar(flags_);
-  }
-  uint64_t child() const {
-    return flatbuffers::EndianScalar(child_);
-  }
-  uint64_t item() const {
-    return flatbuffers::EndianScalar(item_);
-  }
-};
-STRUCT_END(PointKdTreeSearcherNode3, 24);
-
 struct PointKdTreeSearcher3 FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   enum {
-    VT_POINTS = 4,
-    VT_NODES = 6
+    VT_POINTS = 4
   };
   const flatbuffers::Vector<const CubbyFlow::fbs::Vector3D *> *points() const {
     return GetPointer<const flatbuffers::Vector<const CubbyFlow::fbs::Vector3D *> *>(VT_POINTS);
   }
-  const flatbuffers::Vector<const PointKdTreeSearcherNode3 *> *nodes() const {
-    return GetPointer<const flatbuffers::Vector<const PointKdTreeSearcherNode3 *> *>(VT_NODES);
-  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_POINTS) &&
            verifier.Verify(points()) &&
-           VerifyOffset(verifier, VT_NODES) &&
-           verifier.Verify(nodes()) &&
            verifier.EndTable();
   }
 };
@@ -72,16 +34,13 @@ struct PointKdTreeSearcher3Builder {
   void add_points(flatbuffers::Offset<flatbuffers::Vector<const CubbyFlow::fbs::Vector3D *>> points) {
     fbb_.AddOffset(PointKdTreeSearcher3::VT_POINTS, points);
   }
-  void add_nodes(flatbuffers::Offset<flatbuffers::Vector<const PointKdTreeSearcherNode3 *>> nodes) {
-    fbb_.AddOffset(PointKdTreeSearcher3::VT_NODES, nodes);
-  }
   PointKdTreeSearcher3Builder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
   PointKdTreeSearcher3Builder &operator=(const PointKdTreeSearcher3Builder &);
   flatbuffers::Offset<PointKdTreeSearcher3> Finish() {
-    const auto end = fbb_.EndTable(start_, 2);
+    const auto end = fbb_.EndTable(start_, 1);
     auto o = flatbuffers::Offset<PointKdTreeSearcher3>(end);
     return o;
   }
@@ -89,22 +48,18 @@ struct PointKdTreeSearcher3Builder {
 
 inline flatbuffers::Offset<PointKdTreeSearcher3> CreatePointKdTreeSearcher3(
     flatbuffers::FlatBufferBuilder &_fbb,
-    flatbuffers::Offset<flatbuffers::Vector<const CubbyFlow::fbs::Vector3D *>> points = 0,
-    flatbuffers::Offset<flatbuffers::Vector<const PointKdTreeSearcherNode3 *>> nodes = 0) {
+    flatbuffers::Offset<flatbuffers::Vector<const CubbyFlow::fbs::Vector3D *>> points = 0) {
   PointKdTreeSearcher3Builder builder_(_fbb);
-  builder_.add_nodes(nodes);
   builder_.add_points(points);
   return builder_.Finish();
 }
 
 inline flatbuffers::Offset<PointKdTreeSearcher3> CreatePointKdTreeSearcher3Direct(
     flatbuffers::FlatBufferBuilder &_fbb,
-    const std::vector<const CubbyFlow::fbs::Vector3D *> *points = nullptr,
-    const std::vector<const PointKdTreeSearcherNode3 *> *nodes = nullptr) {
+    const std::vector<const CubbyFlow::fbs::Vector3D *> *points = nullptr) {
   return CubbyFlow::fbs::CreatePointKdTreeSearcher3(
       _fbb,
-      points ? _fbb.CreateVector<const CubbyFlow::fbs::Vector3D *>(*points) : 0,
-      nodes ? _fbb.CreateVector<const PointKdTreeSearcherNode3 *>(*nodes) : 0);
+      points ? _fbb.CreateVector<const CubbyFlow::fbs::Vector3D *>(*points) : 0);
 }
 
 inline const CubbyFlow::fbs::PointKdTreeSearcher3 *GetPointKdTreeSearcher3(const void *buf) {
@@ -22,7 +22,9 @@ struct SPHSystemData3 FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     VT_KERNELRADIUSOVERTARGETSPACING = 10,
     VT_KERNELRADIUS = 12,
     VT_PRESSUREIDX = 14,
-    VT_DENSITYIDX = 16
+    VT_DENSITYIDX = 16,
+    VT_SMOOTHINGLENGTHIDX = 18,
+    VT_ISUSINGADAPTIVEKERNEL = 20
   };
   const CubbyFlow::fbs::ParticleSystemData3 *base() const {
     return GetPointer<const CubbyFlow::fbs::ParticleSystemData3 *>(VT_BASE);
@@ -45,6 +47,12 @@ struct SPHSystemData3 FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   uint64_t densityIdx() const {
     return GetField<uint64_t>(VT_DENSITYIDX, 0);
   }
+  uint64_t smoothingLengthIdx() const {
+    return GetField<uint64_t>(VT_SMOOTHINGLENGTHIDX, 18446744073709551615ULL);
+  }
+  bool isUsingAdaptiveKernel() const {
+    return GetField<uint8_t>(VT_ISUSINGADAPTIVEKERNEL, 0) != 0;
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_BASE) &&
@@ -55,6 +63,8 @@ struct SPHSystemData3 FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<double>(verifier, VT_KERNELRADIUS) &&
            VerifyField<uint64_t>(verifier, VT_PRESSUREIDX) &&
            VerifyField<uint64_t>(verifier, VT_DENSITYIDX) &&
+           VerifyField<uint64_t>(verifier, VT_SMOOTHINGLENGTHIDX) &&
+           VerifyField<uint8_t>(verifier, VT_ISUSINGADAPTIVEKERNEL) &&
            verifier.EndTable();
   }
 };
@@ -83,13 +93,19 @@ struct SPHSystemData3Builder {
   void add_densityIdx(uint64_t densityIdx) {
     fbb_.AddElement<uint64_t>(SPHSystemData3::VT_DENSITYIDX, densityIdx, 0);
   }
+  void add_smoothingLengthIdx(uint64_t smoothingLengthIdx) {
+    fbb_.AddElement<uint64_t>(SPHSystemData3::VT_SMOOTHINGLENGTHIDX, smoothingLengthIdx, 18446744073709551615ULL);
+  }
+  void add_isUsingAdaptiveKernel(bool isUsingAdaptiveKernel) {
+    fbb_.AddElement<uint8_t>(SPHSystemData3::VT_ISUSINGADAPTIVEKERNEL, static_cast<uint8_t>(isUsingAdaptiveKernel), 0);
+  }
   SPHSystemData3Builder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
   SPHSystemData3Builder &operator=(const SPHSystemData3Builder &);
   flatbuffers::Offset<SPHSystemData3> Finish() {
-    const auto end = fbb_.EndTable(start_, 7);
+    const auto end = fbb_.EndTable(start_, 9);
     auto o = flatbuffers::Offset<SPHSystemData3>(end);
     return o;
   }
@@ -103,8 +119,11 @@ inline flatbuffers::Offset<SPHSystemData3> CreateSPHSystemData3(
     double kernelRadiusOverTargetSpacing = 0.0,
     double kernelRadius = 0.0,
     uint64_t pressureIdx = 0,
-    uint64_t densityIdx = 0) {
+    uint64_t densityIdx = 0,
+    uint64_t smoothingLengthIdx = 18446744073709551615ULL,
+    bool isUsingAdaptiveKernel = false) {
   SPHSystemData3Builder builder_(_fbb);
+  builder_.add_smoothingLengthIdx(smoothingLengthIdx);
   builder_.add_densityIdx(densityIdx);
   builder_.add_pressureIdx(pressureIdx);
   builder_.add_kernelRadius(kernelRadius);
@@ -112,6 +131,7 @@ inline flatbuffers::Offset<SPHSystemData3> CreateSPHSystemData3(
   builder_.add_targetSpacing(targetSpacing);
   builder_.add_targetDensity(targetDensity);
   builder_.add_base(base);
+  builder_.add_isUsingAdaptiveKernel(isUsingAdaptiveKernel);
   return builder_.Finish();
 }
 
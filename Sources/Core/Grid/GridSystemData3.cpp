@@ -7,14 +7,93 @@
 > Created Time: 2017/08/05
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
+#include <Core/Array/Array3.h>
+#include <Core/Grid/CollocatedVectorGrid3.h>
 #include <Core/Grid/GridSystemData3.h>
 #include <Core/Utils/Factory.h>
 #include <Core/Utils/FlatbuffersHelper.h>
+#include <Core/Utils/Parallel.h>
 
 #include <Flatbuffers/generated/GridSystemData3_generated.h>
 
+#include <algorithm>
+
 namespace CubbyFlow
 {
+	namespace
+	{
+		// The part of a data array that stays inside the grid when its origin
+		// moves by whole cells, with its position in the moved grid.
+		template <typename T>
+		struct ShiftedOverlap
+		{
+			Size3 begin;
+			Array3<T> data;
+		};
+
+		// Copies the data points of the source which land inside of a data
+		// array of size destSize when shifted by offset.
+		template <typename T>
+		ShiftedOverlap<T> SaveShiftedOverlap(const ConstArrayAccessor3<T>& source, const Size3& destSize, const Point3I& offset)
+		{
+			ShiftedOverlap<T> overlap;
+			Size3 extent;
+
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const ssize_t lower = std::max(static_cast<ssize_t>(0), -offset[axis]);
+				const ssize_t upper = std::min(
+					static_cast<ssize_t>(destSize[axis]),
+					static_cast<ssize_t>(source.size()[axis]) - offset[axis]);
+
+				overlap.begin[axis] = static_cast<size_t>(lower);
+				extent[axis] = upper > lower ? static_cast<size_t>(upper - lower) : 0;
+			}
+
+			overlap.data.Resize(extent);
+
+			const Size3 sourceBegin(
+				static_cast<size_t>(static_cast<ssize_t>(overlap.begin.x) + offset.x),
+				static_cast<size_t>(static_cast<ssize_t>(overlap.begin.y) + offset.y),
+				static_cast<size_t>(static_cast<ssize_t>(overlap.begin.z) + offset.z));
+
+			ParallelFor(
+				ZERO_SIZE, extent.x,
+				ZERO_SIZE, extent.y,
+				ZERO_SIZE, extent.z,
+				[&](size_t i, size_t j, size_t k)
+			{
+				overlap.data(i, j, k) = source(sourceBegin.x + i, sourceBegin.y + j, sourceBegin.z + k);
+			});
+
+			return overlap;
+		}
+
+		// Writes the saved overlap back and fills the rest with zero.
+		template <typename T>
+		void RestoreShiftedOverlap(const ShiftedOverlap<T>& overlap, ArrayAccessor3<T> dest)
+		{
+			const Size3 destSize = dest.size();
+			const Size3 end = overlap.begin + overlap.data.size();
+
+			ParallelFor(
+				ZERO_SIZE, destSize.x,
+				ZERO_SIZE, destSize.y,
+				ZERO_SIZE, destSize.z,
+				[&](size_t i, size_t j, size_t k)
+			{
+				if (i >= overlap.begin.x && i < end.x && j >= overlap.begin.y && j < end.y && k >= overlap.begin.z && k < end.z)
+				{
+					dest(i, j, k) = overlap.data(i - overlap.begin.x, j - overlap.begin.y, k - overlap.begin.z);
+				}
+				else
+				{
+					dest(i, j, k) = T();
+				}
+			});
+		}
+	}
+
 	GridSystemData3::GridSystemData3() :
 		GridSystemData3({ 0, 0, 0 }, { 1, 1, 1 }, { 0, 0, 0 })
 	{
@@ -89,6 +168,83 @@ namespace CubbyFlow
 		}
 	}
 
+	void GridSystemData3::ResizeAndShift(const Size3& resolution, const Point3I& originOffset)
+	{
+		const Vector3D origin = m_origin + m_gridSpacing * Vector3D(
+			static_cast<double>(originOffset.x),
+			static_cast<double>(originOffset.y),
+			static_cast<double>(originOffset.z));
+
+		// Every grid type has a fixed number of data points more than cells,
+		// so the data size of a grid after resizing is known beforehand.
+		const Size3 oldResolution = m_resolution;
+		const auto newDataSize = [&](const Size3& oldDataSize)
+		{
+			Size3 result;
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				result[axis] = oldDataSize[axis] + resolution[axis] >= oldResolution[axis]
+					? oldDataSize[axis] + resolution[axis] - oldResolution[axis] : 0;
+			}
+
+			return result;
+		};
+
+		const auto resizeScalarGrid = [&](const ScalarGrid3Ptr& grid)
+		{
+			const auto overlap = SaveShiftedOverlap(grid->GetConstDataAccessor(), newDataSize(grid->GetDataSize()), originOffset);
+			grid->Resize(resolution, m_gridSpacing, origin);
+			RestoreShiftedOverlap(overlap, grid->GetDataAccessor());
+		};
+
+		const auto resizeVectorGrid = [&](const VectorGrid3Ptr& grid)
+		{
+			auto collocated = std::dynamic_pointer_cast<CollocatedVectorGrid3>(grid);
+			if (collocated != nullptr)
+			{
+				const auto overlap = SaveShiftedOverlap(collocated->GetConstDataAccessor(), newDataSize(collocated->GetDataSize()), originOffset);
+				grid->Resize(resolution, m_gridSpacing, origin);
+				RestoreShiftedOverlap(overlap, collocated->GetDataAccessor());
+				return;
+			}
+
+			auto faceCentered = std::dynamic_pointer_cast<FaceCenteredGrid3>(grid);
+			if (faceCentered != nullptr)
+			{
+				const auto overlapU = SaveShiftedOverlap(faceCentered->GetUConstAccessor(), newDataSize(faceCentered->GetUSize()), originOffset);
+				const auto overlapV = SaveShiftedOverlap(faceCentered->GetVConstAccessor(), newDataSize(faceCentered->GetVSize()), originOffset);
+				const auto overlapW = SaveShiftedOverlap(faceCentered->GetWConstAccessor(), newDataSize(faceCentered->GetWSize()), originOffset);
+				grid->Resize(resolution, m_gridSpacing, origin);
+				RestoreShiftedOverlap(overlapU, faceCentered->GetUAccessor());
+				RestoreShiftedOverlap(overlapV, faceCentered->GetVAccessor());
+				RestoreShiftedOverlap(overlapW, faceCentered->GetWAccessor());
+				return;
+			}
+
+			grid->Resize(resolution, m_gridSpacing, origin);
+		};
+
+		m_resolution = resolution;
+		m_origin = origin;
+
+		for (auto& data : m_scalarDataList)
+		{
+			resizeScalarGrid(data);
+		}
+		for (auto& data : m_vectorDataList)
+		{
+			resizeVectorGrid(data);
+		}
+		for (auto& data : m_advectableScalarDataList)
+		{
+			resizeScalarGrid(data);
+		}
+		for (auto& data : m_advectableVectorDataList)
+		{
+			resizeVectorGrid(data);
+		}
+	}
+
 	Size3 GridSystemData3::GetResolution() const
 	{
 		return m_resolution;
@@ -13,6 +13,8 @@
 
 #include <Flatbuffers/generated/ScalarGrid3_generated.h>
 
+#include <cassert>
+
 namespace CubbyFlow
 {
 	ScalarGrid3::ScalarGrid3() :
@@ -101,6 +103,35 @@ namespace CubbyFlow
 		return m_sampler;
 	}
 
+	void ScalarGrid3::SampleMultiple(
+		const Vector3D& x,
+		const std::vector<const ScalarGrid3*>& grids,
+		ArrayAccessor1<double> results) const
+	{
+		assert(results.size() >= grids.size());
+
+		std::array<Point3UI, 8> indices;
+		std::array<double, 8> weights;
+		m_linearSampler.GetCoordinatesAndWeights(x, &indices, &weights);
+
+		for (size_t n = 0; n < grids.size(); ++n)
+		{
+			assert(grids[n]->GetDataSize() == GetDataSize());
+			assert(grids[n]->GetDataOrigin() == GetDataOrigin());
+			assert(grids[n]->GridSpacing() == GridSpacing());
+
+			const Array3<double>& data = grids[n]->m_data;
+			double result = 0.0;
+
+			for (int i = 0; i < 8; ++i)
+			{
+				result += weights[i] * data(indices[i].x, indices[i].y, indices[i].z);
+			}
+
+			results[n] = result;
+		}
+	}
+
 	Vector3D ScalarGrid3::Gradient(const Vector3D& x) const
 	{
 		std::array<Point3UI, 8> indices;
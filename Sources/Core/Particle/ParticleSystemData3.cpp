@@ -217,6 +217,61 @@ namespace CubbyFlow
 		}
 	}
 
+	void ParticleSystemData3::RemoveParticles(const ConstArrayAccessor1<char>& isRemoved)
+	{
+		if (isRemoved.size() != GetNumberOfParticles())
+		{
+			throw std::invalid_argument("isRemoved.size() != GetNumberOfParticles()");
+		}
+
+		size_t newNumberOfParticles = 0;
+		for (size_t i = 0; i < isRemoved.size(); ++i)
+		{
+			if (!isRemoved[i])
+			{
+				++newNumberOfParticles;
+			}
+		}
+
+		if (newNumberOfParticles == GetNumberOfParticles())
+		{
+			return;
+		}
+
+		// Source index of each remaining particle, so every layer can be
+		// gathered in parallel.
+		Array1<size_t> sourceIndices(newNumberOfParticles);
+		for (size_t i = 0, next = 0; i < isRemoved.size(); ++i)
+		{
+			if (!isRemoved[i])
+			{
+				sourceIndices[next++] = i;
+			}
+		}
+
+		const auto compact = [&](auto& attr)
+		{
+			std::remove_reference_t<decltype(attr)> compacted(newNumberOfParticles);
+			ParallelFor(ZERO_SIZE, newNumberOfParticles, [&](size_t i)
+			{
+				compacted[i] = attr[sourceIndices[i]];
+			});
+			attr.Swap(compacted);
+		};
+
+		for (auto& attr : m_scalarDataList)
+		{
+			compact(attr);
+		}
+
+		for (auto& attr : m_vectorDataList)
+		{
+			compact(attr);
+		}
+
+		m_numberOfParticles = newNumberOfParticles;
+	}
+
 	const PointNeighborSearcher3Ptr& ParticleSystemData3::GetNeighborSearcher() const
 	{
 		return m_neighborSearcher;
@@ -254,23 +309,7 @@ namespace CubbyFlow
 	{
 		Timer timer;
 
-		m_neighborLists.resize(GetNumberOfParticles());
-
-		auto points = GetPositions();
-
-		for (size_t i = 0; i < GetNumberOfParticles(); ++i)
-		{
-			Vector3D origin = points[i];
-			m_neighborLists[i].clear();
-
-			m_neighborSearcher->ForEachNearbyPoint(origin, maxSearchRadius, [&](size_t j, const Vector3D&)
-			{
-				if (i != j)
-				{
-					m_neighborLists[i].push_back(j);
-				}
-			});
-		}
+		m_neighborSearcher->BuildNeighborLists(GetPositions(), maxSearchRadius, &m_neighborLists);
 
 		CUBBYFLOW_INFO << "Building neighbor list took: "
 			<< timer.DurationInSeconds()
@@ -464,4 +503,9 @@ namespace CubbyFlow
 			});
 		}
 	}
+
+	void ParticleSystemData3::SetNeighborLists(std::vector<std::vector<size_t>>&& neighborLists)
+	{
+		m_neighborLists = std::move(neighborLists);
+	}
 }
\ No newline at end of file
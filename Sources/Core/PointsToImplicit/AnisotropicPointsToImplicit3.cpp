@@ -10,6 +10,7 @@
 #include <Core/Math/SVD.h>
 #include <Core/Matrix/Matrix3x3.h>
 #include <Core/PointsToImplicit/AnisotropicPointsToImplicit3.h>
+#include <Core/PointsToImplicit/PointSplatter3.h>
 #include <Core/Searcher/PointKdTreeSearcher3.h>
 #include <Core/Solver/LevelSet/FMMLevelSetSolver3.h>
 #include <Core/SPH/SPHSystemData3.h>
@@ -188,21 +189,29 @@ namespace CubbyFlow
 		const auto d = meanParticles.GetDensities();
 		const double m = meanParticles.GetMass();
 
-		PointKdTreeSearcher3 meanNeighborSearcher3;
-		meanNeighborSearcher3.Build(xMeans);
+		// Compute SDF by splatting each anisotropic kernel into the nearby data
+		// points instead of gathering the neighbors of every data point.
+		std::vector<double> gDets(points.size());
+		ParallelFor(ZERO_SIZE, points.size(), [&](size_t i)
+		{
+			gDets[i] = gs[i].Determinant();
+		});
 
-		// Compute SDF
 		auto temp = output->Clone();
-		temp->Fill([&](const Vector3D& x)
-		{
-			double sum = 0.0;
-			meanNeighborSearcher3.ForEachNearbyPoint(x, r,
-				[&](size_t i, const Vector3D& neighborPosition)
-			{
-				sum += m / d[i] * W(neighborPosition - x, gs[i], gs[i].Determinant());
-			});
+		temp->Fill(m_cutOffDensity);
+
+		PointSplatter3 splatter(temp->GetDataSize(), temp->GridSpacing(), temp->GetDataOrigin());
+		splatter.Build(xMeans, r);
 
-			return m_cutOffDensity - sum;
+		auto tempAcc = temp->GetDataAccessor();
+		splatter.Splat(0.0,
+			[&](double& value, size_t i, const Vector3D& x, double)
+		{
+			value += m / d[i] * W(xMeans[i] - x, gs[i], gDets[i]);
+		},
+			[&](size_t i, size_t j, size_t k, double value)
+		{
+			tempAcc(i, j, k) = m_cutOffDensity - value;
 		});
 
 		CUBBYFLOW_INFO << "Computed SDF.";
@@ -0,0 +1,155 @@
+/*************************************************************************
+> File Name: PointSplatter3.cpp
+> Project Name: CubbyFlow
+> Purpose: Tiled, parallel 3-D point-to-grid splatting engine.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/PointsToImplicit/PointSplatter3.h>
+#include <Core/Utils/Constants.h>
+#include <Core/Utils/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace CubbyFlow
+{
+	PointSplatter3::PointSplatter3(
+		const Size3& dataSize,
+		const Vector3D& gridSpacing,
+		const Vector3D& dataOrigin,
+		size_t tileSize) :
+		m_dataSize(dataSize), m_gridSpacing(gridSpacing), m_dataOrigin(dataOrigin),
+		m_tileSize(std::max(tileSize, ONE_SIZE))
+	{
+		m_numberOfTiles.x = (m_dataSize.x + m_tileSize - 1) / m_tileSize;
+		m_numberOfTiles.y = (m_dataSize.y + m_tileSize - 1) / m_tileSize;
+		m_numberOfTiles.z = (m_dataSize.z + m_tileSize - 1) / m_tileSize;
+	}
+
+	void PointSplatter3::Build(const ConstArrayAccessor1<Vector3D>& points, double radius)
+	{
+		m_points = points;
+		m_radius = radius;
+
+		const size_t numberOfTiles = m_numberOfTiles.x * m_numberOfTiles.y * m_numberOfTiles.z;
+		m_tileStarts.assign(numberOfTiles + 1, 0);
+		m_tilePointIndices.clear();
+		m_occupiedTiles.clear();
+
+		if (numberOfTiles == 0)
+		{
+			return;
+		}
+
+		// Counting sort of (tile, point) pairs. Each point is binned into every
+		// tile its support overlaps. The points are split into contiguous
+		// chunks that are counted and scattered in parallel; chunk c writes
+		// its points of a tile after those of chunks 0, ..., c - 1, so the
+		// points in each bin stay in ascending index order.
+		const auto forEachOverlappingTile = [&](size_t pointIndex, const auto& func)
+		{
+			Size3 lower, upper;
+			if (!GetDataIndexRange(points[pointIndex], &lower, &upper))
+			{
+				return;
+			}
+
+			for (size_t k = lower.z / m_tileSize; k <= upper.z / m_tileSize; ++k)
+			{
+				for (size_t j = lower.y / m_tileSize; j <= upper.y / m_tileSize; ++j)
+				{
+					for (size_t i = lower.x / m_tileSize; i <= upper.x / m_tileSize; ++i)
+					{
+						func((k * m_numberOfTiles.y + j) * m_numberOfTiles.x + i);
+					}
+				}
+			}
+		};
+
+		const size_t numberOfPoints = points.size();
+		const size_t numberOfChunks = std::max(std::min(numberOfPoints, static_cast<size_t>(GetMaxNumberOfThreads())), ONE_SIZE);
+		const auto chunkBegin = [&](size_t chunk)
+		{
+			return numberOfPoints * chunk / numberOfChunks;
+		};
+
+		// chunkCursors[c * numberOfTiles + tile] first holds the number of
+		// (tile, point) pairs of chunk c, then the position chunk c writes to.
+		std::vector<size_t> chunkCursors(numberOfChunks * numberOfTiles, 0);
+
+		ParallelFor(ZERO_SIZE, numberOfChunks, [&](size_t chunk)
+		{
+			size_t* counts = &chunkCursors[chunk * numberOfTiles];
+
+			for (size_t p = chunkBegin(chunk); p < chunkBegin(chunk + 1); ++p)
+			{
+				forEachOverlappingTile(p, [&](size_t tile)
+				{
+					++counts[tile];
+				});
+			}
+		});
+
+		size_t offset = 0;
+		for (size_t tile = 0; tile < numberOfTiles; ++tile)
+		{
+			m_tileStarts[tile] = offset;
+
+			for (size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+			{
+				const size_t count = chunkCursors[chunk * numberOfTiles + tile];
+				chunkCursors[chunk * numberOfTiles + tile] = offset;
+				offset += count;
+			}
+
+			if (offset > m_tileStarts[tile])
+			{
+				m_occupiedTiles.push_back(tile);
+			}
+		}
+		m_tileStarts[numberOfTiles] = offset;
+
+		m_tilePointIndices.resize(offset);
+
+		ParallelFor(ZERO_SIZE, numberOfChunks, [&](size_t chunk)
+		{
+			size_t* cursors = &chunkCursors[chunk * numberOfTiles];
+
+			for (size_t p = chunkBegin(chunk); p < chunkBegin(chunk + 1); ++p)
+			{
+				forEachOverlappingTile(p, [&](size_t tile)
+				{
+					m_tilePointIndices[cursors[tile]++] = p;
+				});
+			}
+		});
+	}
+
+	size_t PointSplatter3::GetNumberOfOccupiedTiles() const
+	{
+		return m_occupiedTiles.size();
+	}
+
+	bool PointSplatter3::GetDataIndexRange(const Vector3D& point, Size3* lower, Size3* upper) const
+	{
+		const Vector3D lowerBound = (point - Vector3D(m_radius, m_radius, m_radius) - m_dataOrigin) / m_gridSpacing;
+		const Vector3D upperBound = (point + Vector3D(m_radius, m_radius, m_radius) - m_dataOrigin) / m_gridSpacing;
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			const double lo = std::max(std::ceil(lowerBound[axis]), 0.0);
+			const double hi = std::min(std::floor(upperBound[axis]), static_cast<double>(m_dataSize[axis]) - 1.0);
+
+			if (lo > hi)
+			{
+				return false;
+			}
+
+			(*lower)[axis] = static_cast<size_t>(lo);
+			(*upper)[axis] = static_cast<size_t>(hi);
+		}
+
+		return true;
+	}
+}
@@ -7,13 +7,18 @@
 > Created Time: 2017/11/18
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
+#include <Core/Array/Array1.h>
+#include <Core/PointsToImplicit/PointSplatter3.h>
 #include <Core/PointsToImplicit/SPHPointsToImplicit3.h>
+#include <Core/Searcher/PointParallelHashGridSearcher3.h>
 #include <Core/Solver/LevelSet/FMMLevelSetSolver3.h>
-#include <Core/SPH/SPHSystemData3.h>
+#include <Core/SPH/SPHStdKernel3.h>
 #include <Core/Utils/Logging.h>
 
 namespace CubbyFlow
 {
+	static const size_t DEFAULT_HASH_GRID_RESOLUTION = 64;
+
 	SPHPointsToImplicit3::SPHPointsToImplicit3(double kernelRadius, double cutOffDensity, bool isOutputSDF) :
 		m_kernelRadius(kernelRadius), m_cutOffDensity(cutOffDensity), m_isOutputSDF(isOutputSDF)
 	{
@@ -42,18 +47,48 @@ namespace CubbyFlow
 			return;
 		}
 
-		SPHSystemData3 sphParticles;
-		sphParticles.AddParticles(points);
-		sphParticles.SetKernelRadius(m_kernelRadius);
-		sphParticles.BuildNeighborSearcher();
-		sphParticles.UpdateDensities();
+		// Number density of each point. Interpolating a constant field with
+		// weight m / d_i turns into 1 / sum_j W_ij, so the mass cancels out
+		// and no SPH particle system is required.
+		PointParallelHashGridSearcher3 neighborSearcher(
+			DEFAULT_HASH_GRID_RESOLUTION,
+			DEFAULT_HASH_GRID_RESOLUTION,
+			DEFAULT_HASH_GRID_RESOLUTION,
+			2.0 * m_kernelRadius);
+		neighborSearcher.Build(points);
+
+		const SPHStdKernel3 kernel(m_kernelRadius);
+		Array1<double> invNumberDensities(points.size());
+
+		ParallelFor(ZERO_SIZE, points.size(), [&](size_t i)
+		{
+			double sum = 0.0;
+			neighborSearcher.ForEachNearbyPoint(points[i], m_kernelRadius,
+				[&](size_t, const Vector3D& neighborPosition)
+			{
+				sum += kernel(points[i].DistanceTo(neighborPosition));
+			});
+
+			invNumberDensities[i] = 1.0 / sum;
+		});
 
-		Array1<double> constData(sphParticles.GetNumberOfParticles(), 1.0);
 		auto temp = output->Clone();
-		temp->Fill([&](const Vector3D& x)
+		temp->Fill(m_cutOffDensity);
+
+		// Splat the interpolation weights into the nearby data points instead of
+		// gathering the neighbors of every data point.
+		PointSplatter3 splatter(temp->GetDataSize(), temp->GridSpacing(), temp->GetDataOrigin());
+		splatter.Build(points, m_kernelRadius);
+
+		auto tempAcc = temp->GetDataAccessor();
+		splatter.Splat(0.0,
+			[&](double& value, size_t pointIndex, const Vector3D&, double distanceSquared)
+		{
+			value += invNumberDensities[pointIndex] * kernel(std::sqrt(distanceSquared));
+		},
+			[&](size_t i, size_t j, size_t k, double value)
 		{
-			double d = sphParticles.Interpolate(x, constData);
-			return m_cutOffDensity - d;
+			tempAcc(i, j, k) = m_cutOffDensity - value;
 		});
 
 		if (m_isOutputSDF)
@@ -7,14 +7,14 @@
 > Created Time: 2017/11/18
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
-#include <Core/Particle/ParticleSystemData3.h>
+#include <Core/PointsToImplicit/PointSplatter3.h>
 #include <Core/PointsToImplicit/ZhuBridsonPointsToImplicit3.h>
 #include <Core/Solver/LevelSet/FMMLevelSetSolver3.h>
 #include <Core/Utils/Logging.h>
 
 namespace CubbyFlow
 {
-	inline double k(double s)
+	inline double Kernel(double s)
 	{
 		return std::max(0.0, Cubic(1.0 - s * s));
 	}
@@ -47,32 +47,38 @@ namespace CubbyFlow
 			return;
 		}
 
-		ParticleSystemData3 particles;
-		particles.AddParticles(points);
-		particles.BuildNeighborSearcher(m_kernelRadius);
-
-		const auto neighborSearcher = particles.GetNeighborSearcher();
 		const double isoContValue = m_cutOffThreshold * m_kernelRadius;
+		const double farValue = bbox.DiagonalLength();
 
 		auto temp = output->Clone();
-		temp->Fill([&](const Vector3D& x) -> double
+		temp->Fill(farValue);
+
+		// Each point splats its weight and weighted position into the nearby
+		// data points. Data points which no point reaches keep the far value.
+		struct WeightedSum
 		{
-			Vector3D xAvg;
-			double wSum = 0.0;
-			const auto func = [&](size_t, const Vector3D& xi)
-			{
-				const double wi = k((x - xi).Length() / m_kernelRadius);
-				wSum += wi;
-				xAvg += wi * xi;
-			};
-			neighborSearcher->ForEachNearbyPoint(x, m_kernelRadius, func);
+			double wSum;
+			Vector3D xSum;
+		};
 
-			if (wSum > 0.0) {
-				xAvg /= wSum;
-				return (x - xAvg).Length() - isoContValue;
-			}
-			else {
-				return output->BoundingBox().DiagonalLength();
+		PointSplatter3 splatter(temp->GetDataSize(), temp->GridSpacing(), temp->GetDataOrigin());
+		splatter.Build(points, m_kernelRadius);
+
+		auto tempAcc = temp->GetDataAccessor();
+		const auto pos = temp->GetDataPosition();
+		splatter.Splat(WeightedSum{ 0.0, Vector3D() },
+			[&](WeightedSum& value, size_t pointIndex, const Vector3D&, double distanceSquared)
+		{
+			const double wi = Kernel(std::sqrt(distanceSquared) / m_kernelRadius);
+			value.wSum += wi;
+			value.xSum += wi * points[pointIndex];
+		},
+			[&](size_t i, size_t j, size_t k, const WeightedSum& value)
+		{
+			if (value.wSum > 0.0)
+			{
+				const Vector3D xAvg = value.xSum / value.wSum;
+				tempAcc(i, j, k) = (pos(i, j, k) - xAvg).Length() - isoContValue;
 			}
 		});
 
@@ -16,6 +16,8 @@
 #include <Core/SPH/SPHStdKernel3.h>
 #include <Core/Utils/Constants.h>
 
+#include <algorithm>
+
 namespace CubbyFlow
 {
 	SPHStdKernel3::SPHStdKernel3() :
@@ -90,6 +92,60 @@ namespace CubbyFlow
 		return 945.0 / (32.0 * PI_DOUBLE * h5) * (1 - x) * (5 * x - 1);
 	}
 
+	void SPHStdKernel3::BatchValuesFromSquared(const double* distancesSquared, double* values, size_t count) const
+	{
+		if (h2 <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = 315.0 / (64.0 * PI_DOUBLE * h3);
+		const double invH2 = 1.0 / h2;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = std::max(1.0 - distancesSquared[i] * invH2, 0.0);
+			values[i] = factor * x * x * x;
+		}
+	}
+
+	void SPHStdKernel3::BatchFirstDerivatives(const double* distances, double* values, size_t count) const
+	{
+		if (h2 <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = -945.0 / (32.0 * PI_DOUBLE * h5);
+		const double invH2 = 1.0 / h2;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = std::max(1.0 - distances[i] * distances[i] * invH2, 0.0);
+			values[i] = factor * distances[i] * x * x;
+		}
+	}
+
+	void SPHStdKernel3::BatchSecondDerivativesFromSquared(const double* distancesSquared, double* values, size_t count) const
+	{
+		if (h2 <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = 945.0 / (32.0 * PI_DOUBLE * h5);
+		const double invH2 = 1.0 / h2;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = distancesSquared[i] * invH2;
+			values[i] = x < 1.0 ? factor * (1.0 - x) * (5.0 * x - 1.0) : 0.0;
+		}
+	}
+
 	SPHSpikyKernel3::SPHSpikyKernel3() :
 		h(0), h2(0), h3(0), h4(0), h5(0)
 	{
@@ -157,4 +213,58 @@ namespace CubbyFlow
 		double x = 1.0 - distance / h;
 		return 90.0 / (PI_DOUBLE * h5) * x;
 	}
+
+	void SPHSpikyKernel3::BatchValues(const double* distances, double* values, size_t count) const
+	{
+		if (h <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = 15.0 / (PI_DOUBLE * h3);
+		const double invH = 1.0 / h;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = std::max(1.0 - distances[i] * invH, 0.0);
+			values[i] = factor * x * x * x;
+		}
+	}
+
+	void SPHSpikyKernel3::BatchFirstDerivatives(const double* distances, double* values, size_t count) const
+	{
+		if (h <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = -45.0 / (PI_DOUBLE * h4);
+		const double invH = 1.0 / h;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = std::max(1.0 - distances[i] * invH, 0.0);
+			values[i] = factor * x * x;
+		}
+	}
+
+	void SPHSpikyKernel3::BatchSecondDerivatives(const double* distances, double* values, size_t count) const
+	{
+		if (h <= 0.0)
+		{
+			std::fill(values, values + count, 0.0);
+			return;
+		}
+
+		const double factor = 90.0 / (PI_DOUBLE * h5);
+		const double invH = 1.0 / h;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double x = std::max(1.0 - distances[i] * invH, 0.0);
+			values[i] = factor * x;
+		}
+	}
 }
\ No newline at end of file
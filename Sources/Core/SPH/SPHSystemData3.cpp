@@ -11,9 +11,13 @@
 #include <Core/PointGenerator/BccLatticePointGenerator.h>
 #include <Core/SPH/SPHStdKernel3.h>
 #include <Core/SPH/SPHSystemData3.h>
+#include <Core/Utils/Logging.h>
+#include <Core/Utils/Timer.h>
 
 #include <Flatbuffers/generated/SPHSystemData3_generated.h>
 
+#include <limits>
+
 namespace CubbyFlow
 {
 	SPHSystemData3::SPHSystemData3() :
@@ -27,6 +31,7 @@ namespace CubbyFlow
 	{
 		m_densityIdx = AddScalarData();
 		m_pressureIdx = AddScalarData();
+		m_smoothingLengthIdx = AddScalarData();
 
 		SetTargetSpacing(m_targetSpacing);
 	}
@@ -74,12 +79,70 @@ namespace CubbyFlow
 		return ScalarDataAt(m_pressureIdx);
 	}
 
+	ConstArrayAccessor1<double> SPHSystemData3::GetSmoothingLengths() const
+	{
+		return ScalarDataAt(m_smoothingLengthIdx);
+	}
+
+	ArrayAccessor1<double> SPHSystemData3::GetSmoothingLengths()
+	{
+		return ScalarDataAt(m_smoothingLengthIdx);
+	}
+
+	double SPHSystemData3::GetSmoothingLengthAt(size_t i) const
+	{
+		if (m_isUsingAdaptiveKernel)
+		{
+			const double h = ScalarDataAt(m_smoothingLengthIdx)[i];
+			if (h > 0.0)
+			{
+				return h;
+			}
+		}
+
+		return m_kernelRadius;
+	}
+
+	double SPHSystemData3::GetMassAt(size_t i) const
+	{
+		return GetMass() * Cubic(GetSmoothingLengthAt(i) / m_kernelRadius);
+	}
+
+	bool SPHSystemData3::GetIsUsingAdaptiveKernel() const
+	{
+		return m_isUsingAdaptiveKernel;
+	}
+
+	void SPHSystemData3::SetIsUsingAdaptiveKernel(bool isUsing)
+	{
+		m_isUsingAdaptiveKernel = isUsing;
+	}
+
 	void SPHSystemData3::UpdateDensities()
 	{
 		auto p = GetPositions();
 		auto d = GetDensities();
 		const double m = GetMass();
 
+		if (m_isUsingAdaptiveKernel)
+		{
+			ParallelFor(ZERO_SIZE, GetNumberOfParticles(), [&](size_t i)
+			{
+				const double hi = GetSmoothingLengthAt(i);
+				double sum = 0.0;
+
+				m_adaptiveNeighborSearcher.ForEachNearbyPoint(p[i], hi,
+					[&](size_t j, const Vector3D& neighborPosition)
+				{
+					const SPHStdKernel3 kernel(0.5 * (hi + GetSmoothingLengthAt(j)));
+					sum += GetMassAt(j) * kernel(p[i].DistanceTo(neighborPosition));
+				});
+
+				d[i] = sum;
+			});
+			return;
+		}
+
 		ParallelFor(ZERO_SIZE, GetNumberOfParticles(), [&](size_t i)
 		{
 			double sum = SumOfKernelNearby(p[i]);
@@ -87,6 +150,58 @@ namespace CubbyFlow
 		});
 	}
 
+	void SPHSystemData3::UpdateDensitiesFromNeighborLists()
+	{
+		auto p = GetPositions();
+		auto d = GetDensities();
+		const double m = GetMass();
+		const SPHStdKernel3 kernel(m_kernelRadius);
+		const auto& neighborLists = GetNeighborLists();
+
+		if (m_isUsingAdaptiveKernel)
+		{
+			ParallelFor(ZERO_SIZE, GetNumberOfParticles(), [&](size_t i)
+			{
+				const double hi = GetSmoothingLengthAt(i);
+				double sum = GetMassAt(i) * SPHStdKernel3(hi)(0.0);
+
+				for (size_t j : neighborLists[i])
+				{
+					const SPHStdKernel3 kernelIJ(0.5 * (hi + GetSmoothingLengthAt(j)));
+					sum += GetMassAt(j) * kernelIJ(p[i].DistanceTo(p[j]));
+				}
+
+				d[i] = sum;
+			});
+			return;
+		}
+
+		ParallelFor(ZERO_SIZE, GetNumberOfParticles(), [&](size_t i)
+		{
+			const auto& neighbors = neighborLists[i];
+			double distancesSquared[SPH_KERNEL_BATCH_SIZE];
+			double values[SPH_KERNEL_BATCH_SIZE];
+			double sum = kernel(0.0);
+
+			for (size_t begin = 0; begin < neighbors.size(); begin += SPH_KERNEL_BATCH_SIZE)
+			{
+				const size_t count = std::min(SPH_KERNEL_BATCH_SIZE, neighbors.size() - begin);
+				for (size_t c = 0; c < count; ++c)
+				{
+					distancesSquared[c] = p[i].DistanceSquaredTo(p[neighbors[begin + c]]);
+				}
+
+				kernel.BatchValuesFromSquared(distancesSquared, values, count);
+				for (size_t c = 0; c < count; ++c)
+				{
+					sum += values[c];
+				}
+			}
+
+			d[i] = m * sum;
+		});
+	}
+
 	void SPHSystemData3::SetTargetDensity(double targetDensity)
 	{
 		m_targetDensity = targetDensity;
@@ -145,13 +260,46 @@ namespace CubbyFlow
 		double sum = 0.0;
 		SPHStdKernel3 kernel(m_kernelRadius);
 
+		if (m_isUsingAdaptiveKernel)
+		{
+			m_adaptiveNeighborSearcher.ForEachNearbyPoint(origin, m_kernelRadius,
+				[&](size_t j, const Vector3D& neighborPosition)
+			{
+				const SPHStdKernel3 kernelIJ(0.5 * (m_kernelRadius + GetSmoothingLengthAt(j)));
+				sum += kernelIJ(origin.DistanceTo(neighborPosition));
+			});
+
+			return sum;
+		}
+
+		// Squared distances are gathered and evaluated in batches.
+		double distancesSquared[SPH_KERNEL_BATCH_SIZE];
+		double values[SPH_KERNEL_BATCH_SIZE];
+		size_t count = 0;
+
+		const auto flush = [&]()
+		{
+			kernel.BatchValuesFromSquared(distancesSquared, values, count);
+			for (size_t c = 0; c < count; ++c)
+			{
+				sum += values[c];
+			}
+
+			count = 0;
+		};
+
 		GetNeighborSearcher()->ForEachNearbyPoint(origin, m_kernelRadius,
 			[&](size_t, const Vector3D& neighborPosition)
 		{
-			double dist = origin.DistanceTo(neighborPosition);
-			sum += kernel(dist);
+			distancesSquared[count++] = origin.DistanceSquaredTo(neighborPosition);
+			if (count == SPH_KERNEL_BATCH_SIZE)
+			{
+				flush();
+			}
 		});
 
+		flush();
+
 		return sum;
 	}
 
@@ -162,6 +310,20 @@ namespace CubbyFlow
 		SPHStdKernel3 kernel(m_kernelRadius);
 		const double m = GetMass();
 
+		if (m_isUsingAdaptiveKernel)
+		{
+			m_adaptiveNeighborSearcher.ForEachNearbyPoint(origin, m_kernelRadius,
+				[&](size_t i, const Vector3D& neighborPosition)
+			{
+				const SPHStdKernel3 kernelIJ(0.5 * (m_kernelRadius + GetSmoothingLengthAt(i)));
+				double weight = GetMassAt(i) / d[i] * kernelIJ(origin.DistanceTo(neighborPosition));
+
+				sum += weight * values[i];
+			});
+
+			return sum;
+		}
+
 		GetNeighborSearcher()->ForEachNearbyPoint(origin, m_kernelRadius,
 			[&](size_t i, const Vector3D& neighborPosition)
 		{
@@ -181,6 +343,20 @@ namespace CubbyFlow
 		SPHStdKernel3 kernel(m_kernelRadius);
 		const double m = GetMass();
 
+		if (m_isUsingAdaptiveKernel)
+		{
+			m_adaptiveNeighborSearcher.ForEachNearbyPoint(origin, m_kernelRadius,
+				[&](size_t i, const Vector3D& neighborPosition)
+			{
+				const SPHStdKernel3 kernelIJ(0.5 * (m_kernelRadius + GetSmoothingLengthAt(i)));
+				double weight = GetMassAt(i) / d[i] * kernelIJ(origin.DistanceTo(neighborPosition));
+
+				sum += weight * values[i];
+			});
+
+			return sum;
+		}
+
 		GetNeighborSearcher()->ForEachNearbyPoint(origin, m_kernelRadius,
 			[&](size_t i, const Vector3D& neighborPosition)
 		{
@@ -211,7 +387,16 @@ namespace CubbyFlow
 			if (dist > 0.0)
 			{
 				Vector3D dir = (neighborPosition - origin) / dist;
-				sum += d[i] * m * (values[i] / Square(d[i]) + values[j] / Square(d[j])) * kernel.Gradient(dist, dir);
+
+				if (m_isUsingAdaptiveKernel)
+				{
+					const SPHSpikyKernel3 kernelIJ(0.5 * (GetSmoothingLengthAt(i) + GetSmoothingLengthAt(j)));
+					sum += d[i] * GetMassAt(j) * (values[i] / Square(d[i]) + values[j] / Square(d[j])) * kernelIJ.Gradient(dist, dir);
+				}
+				else
+				{
+					sum += d[i] * m * (values[i] / Square(d[i]) + values[j] / Square(d[j])) * kernel.Gradient(dist, dir);
+				}
 			}
 		}
 
@@ -232,7 +417,16 @@ namespace CubbyFlow
 		{
 			Vector3D neighborPosition = p[j];
 			double dist = origin.DistanceTo(neighborPosition);
-			sum += m * (values[j] - values[i]) / d[j] * kernel.SecondDerivative(dist);
+
+			if (m_isUsingAdaptiveKernel)
+			{
+				const SPHSpikyKernel3 kernelIJ(0.5 * (GetSmoothingLengthAt(i) + GetSmoothingLengthAt(j)));
+				sum += GetMassAt(j) * (values[j] - values[i]) / d[j] * kernelIJ.SecondDerivative(dist);
+			}
+			else
+			{
+				sum += m * (values[j] - values[i]) / d[j] * kernel.SecondDerivative(dist);
+			}
 		}
 
 		return sum;
@@ -252,7 +446,16 @@ namespace CubbyFlow
 		{
 			Vector3D neighborPosition = p[j];
 			double dist = origin.DistanceTo(neighborPosition);
-			sum += m * (values[j] - values[i]) / d[j] * kernel.SecondDerivative(dist);
+
+			if (m_isUsingAdaptiveKernel)
+			{
+				const SPHSpikyKernel3 kernelIJ(0.5 * (GetSmoothingLengthAt(i) + GetSmoothingLengthAt(j)));
+				sum += GetMassAt(j) * (values[j] - values[i]) / d[j] * kernelIJ.SecondDerivative(dist);
+			}
+			else
+			{
+				sum += m * (values[j] - values[i]) / d[j] * kernel.SecondDerivative(dist);
+			}
 		}
 
 		return sum;
@@ -260,11 +463,39 @@ namespace CubbyFlow
 
 	void SPHSystemData3::BuildNeighborSearcher()
 	{
+		if (m_isUsingAdaptiveKernel)
+		{
+			Timer timer;
+
+			Array1<double> smoothingLengths(GetNumberOfParticles());
+			ParallelFor(ZERO_SIZE, smoothingLengths.size(), [&](size_t i)
+			{
+				smoothingLengths[i] = GetSmoothingLengthAt(i);
+			});
+
+			m_adaptiveNeighborSearcher.Build(GetPositions(), smoothingLengths.ConstAccessor());
+
+			CUBBYFLOW_INFO << "Building adaptive neighbor searcher with "
+				<< m_adaptiveNeighborSearcher.GetNumberOfLevels()
+				<< " levels took: "
+				<< timer.DurationInSeconds()
+				<< " seconds";
+			return;
+		}
+
 		ParticleSystemData3::BuildNeighborSearcher(m_kernelRadius);
 	}
 
 	void SPHSystemData3::BuildNeighborLists()
 	{
+		if (m_isUsingAdaptiveKernel)
+		{
+			std::vector<std::vector<size_t>> neighborLists;
+			m_adaptiveNeighborSearcher.BuildNeighborLists(&neighborLists);
+			SetNeighborLists(std::move(neighborLists));
+			return;
+		}
+
 		ParticleSystemData3::BuildNeighborLists(m_kernelRadius);
 	}
 
@@ -317,7 +548,9 @@ namespace CubbyFlow
 			m_kernelRadiusOverTargetSpacing,
 			m_kernelRadius,
 			m_pressureIdx,
-			m_densityIdx);
+			m_densityIdx,
+			m_smoothingLengthIdx,
+			m_isUsingAdaptiveKernel);
 
 		builder.Finish(fbsSPHSystemData);
 
@@ -342,6 +575,21 @@ namespace CubbyFlow
 		m_kernelRadius = fbsSPHSystemData->kernelRadius();
 		m_pressureIdx = static_cast<size_t>(fbsSPHSystemData->pressureIdx());
 		m_densityIdx = static_cast<size_t>(fbsSPHSystemData->densityIdx());
+
+		// Buffers written before the smoothing lengths were introduced do not
+		// have the field and read the sentinel default. Such data gets a fresh
+		// channel, which falls back to the kernel radius.
+		const uint64_t smoothingLengthIdx = fbsSPHSystemData->smoothingLengthIdx();
+		if (smoothingLengthIdx != std::numeric_limits<uint64_t>::max())
+		{
+			m_smoothingLengthIdx = static_cast<size_t>(smoothingLengthIdx);
+		}
+		else
+		{
+			m_smoothingLengthIdx = AddScalarData();
+		}
+
+		m_isUsingAdaptiveKernel = fbsSPHSystemData->isUsingAdaptiveKernel();
 	}
 
 	void SPHSystemData3::Set(const SPHSystemData3& other)
@@ -354,6 +602,9 @@ namespace CubbyFlow
 		m_kernelRadius = other.m_kernelRadius;
 		m_densityIdx = other.m_densityIdx;
 		m_pressureIdx = other.m_pressureIdx;
+		m_smoothingLengthIdx = other.m_smoothingLengthIdx;
+		m_isUsingAdaptiveKernel = other.m_isUsingAdaptiveKernel;
+		m_adaptiveNeighborSearcher = other.m_adaptiveNeighborSearcher;
 	}
 
 	SPHSystemData3& SPHSystemData3::operator=(const SPHSystemData3& other)
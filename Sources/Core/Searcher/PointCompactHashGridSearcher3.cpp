@@ -0,0 +1,491 @@
+/*************************************************************************
+> File Name: PointCompactHashGridSearcher3.cpp
+> Project Name: CubbyFlow
+> Purpose: Compact hash grid-based 3-D point searcher with unbounded domain.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
+#include <Core/Utils/FlatbuffersHelper.h>
+#include <Core/Utils/Parallel.h>
+
+#include <Flatbuffers/generated/PointCompactHashGridSearcher3_generated.h>
+
+#include <flatbuffers/flatbuffers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace CubbyFlow
+{
+	namespace
+	{
+		// Bucket coordinates are biased by this value so that negative indices
+		// map to unsigned 21-bit integers.
+		constexpr ssize_t MORTON_BIAS = 1 << 20;
+
+		// Converts a floored coordinate to a bucket coordinate. Coordinates
+		// outside of [-2^20, 2^20), including NaN, are clamped to the first
+		// value beyond the range, so they neither overflow nor wrap.
+		ssize_t ToBucketCoordinate(double x)
+		{
+			if (!(x >= static_cast<double>(-MORTON_BIAS)))
+			{
+				return -MORTON_BIAS - 1;
+			}
+
+			if (x >= static_cast<double>(MORTON_BIAS))
+			{
+				return MORTON_BIAS;
+			}
+
+			return static_cast<ssize_t>(x);
+		}
+
+		bool IsInMortonRange(const Point3I& bucketIndex)
+		{
+			return bucketIndex.x >= -MORTON_BIAS && bucketIndex.x < MORTON_BIAS
+				&& bucketIndex.y >= -MORTON_BIAS && bucketIndex.y < MORTON_BIAS
+				&& bucketIndex.z >= -MORTON_BIAS && bucketIndex.z < MORTON_BIAS;
+		}
+
+		uint64_t SpreadBits(uint64_t x)
+		{
+			x &= 0x1fffff;
+			x = (x | (x << 32)) & 0x001f00000000ffff;
+			x = (x | (x << 16)) & 0x001f0000ff0000ff;
+			x = (x | (x << 8)) & 0x100f00f00f00f00f;
+			x = (x | (x << 4)) & 0x10c30c30c30c30c3;
+			x = (x | (x << 2)) & 0x1249249249249249;
+			return x;
+		}
+
+		size_t HashMortonCode(uint64_t key)
+		{
+			// Finalizer of splitmix64. Morton codes of nearby buckets only differ
+			// in the low bits, so they have to be mixed before masking.
+			key ^= key >> 30;
+			key *= 0xbf58476d1ce4e5b9;
+			key ^= key >> 27;
+			key *= 0x94d049bb133111eb;
+			key ^= key >> 31;
+			return static_cast<size_t>(key);
+		}
+	}
+
+	PointCompactHashGridSearcher3::PointCompactHashGridSearcher3(double gridSpacing) :
+		m_gridSpacing(gridSpacing)
+	{
+		// Do nothing
+	}
+
+	PointCompactHashGridSearcher3::PointCompactHashGridSearcher3(const PointCompactHashGridSearcher3& other)
+	{
+		Set(other);
+	}
+
+	template <typename Callback>
+	void PointCompactHashGridSearcher3::ForEachBucketRange(const Point3I& lowerQueryIndex, const Point3I& upperQueryIndex, const Callback& callback) const
+	{
+		if (m_bucketKeys.empty())
+		{
+			return;
+		}
+
+		// Every point lies within the Morton range, so the buckets outside of
+		// it are skipped instead of being wrapped onto distant ones.
+		const Point3I lowerIndex(
+			std::max(lowerQueryIndex.x, -MORTON_BIAS),
+			std::max(lowerQueryIndex.y, -MORTON_BIAS),
+			std::max(lowerQueryIndex.z, -MORTON_BIAS));
+		const Point3I upperIndex(
+			std::min(upperQueryIndex.x, MORTON_BIAS - 1),
+			std::min(upperQueryIndex.y, MORTON_BIAS - 1),
+			std::min(upperQueryIndex.z, MORTON_BIAS - 1));
+		if (lowerIndex.x > upperIndex.x || lowerIndex.y > upperIndex.y || lowerIndex.z > upperIndex.z)
+		{
+			return;
+		}
+
+		// If the box covers more buckets than there are occupied ones, it is
+		// cheaper to scan every point.
+		const double numberOfBuckets =
+			static_cast<double>(upperIndex.x - lowerIndex.x + 1) *
+			static_cast<double>(upperIndex.y - lowerIndex.y + 1) *
+			static_cast<double>(upperIndex.z - lowerIndex.z + 1);
+		if (numberOfBuckets > static_cast<double>(m_bucketKeys.size()))
+		{
+			callback(ZERO_SIZE, m_points.size());
+			return;
+		}
+
+		for (ssize_t k = lowerIndex.z; k <= upperIndex.z; ++k)
+		{
+			for (ssize_t j = lowerIndex.y; j <= upperIndex.y; ++j)
+			{
+				for (ssize_t i = lowerIndex.x; i <= upperIndex.x; ++i)
+				{
+					const size_t b = FindBucket(Point3I(i, j, k));
+					if (b != std::numeric_limits<size_t>::max())
+					{
+						callback(m_bucketStarts[b], m_bucketStarts[b + 1]);
+					}
+				}
+			}
+		}
+	}
+
+	void PointCompactHashGridSearcher3::Build(const ConstArrayAccessor1<Vector3D>& points)
+	{
+		const size_t numberOfPoints = points.size();
+
+		m_points.resize(numberOfPoints);
+		m_sortedIndices.resize(numberOfPoints);
+		m_bucketKeys.clear();
+		m_bucketStarts.clear();
+		m_hashTable.clear();
+
+		if (numberOfPoints == 0)
+		{
+			return;
+		}
+
+		// Sort indices based on the Morton code of the bucket. Ties are broken
+		// by the index, so the result does not depend on the sort algorithm.
+		std::vector<uint64_t> tempKeys(numberOfPoints);
+		std::atomic<bool> isOutOfRange(false);
+		ParallelFor(ZERO_SIZE, numberOfPoints, [&](size_t i)
+		{
+			const Point3I bucketIndex = GetBucketIndex(points[i]);
+			if (!IsInMortonRange(bucketIndex))
+			{
+				isOutOfRange = true;
+			}
+
+			m_sortedIndices[i] = i;
+			tempKeys[i] = GetMortonCode(bucketIndex);
+		});
+
+		if (isOutOfRange)
+		{
+			m_points.clear();
+			m_sortedIndices.clear();
+			throw std::invalid_argument("A point lies outside of the bucket coordinate range [-2^20, 2^20).");
+		}
+
+		ParallelSort(m_sortedIndices.begin(), m_sortedIndices.end(), [&tempKeys](size_t indexA, size_t indexB)
+		{
+			return tempKeys[indexA] < tempKeys[indexB] || (tempKeys[indexA] == tempKeys[indexB] && indexA < indexB);
+		});
+
+		ParallelFor(ZERO_SIZE, numberOfPoints, [&](size_t i)
+		{
+			m_points[i] = points[m_sortedIndices[i]];
+		});
+
+		// Each run of equal keys is one occupied bucket.
+		for (size_t i = 0; i < numberOfPoints; ++i)
+		{
+			const uint64_t key = tempKeys[m_sortedIndices[i]];
+			if (i == 0 || key != m_bucketKeys.back())
+			{
+				m_bucketKeys.push_back(key);
+				m_bucketStarts.push_back(i);
+			}
+		}
+		m_bucketStarts.push_back(numberOfPoints);
+
+		// Open addressing with linear probing, at most half full.
+		size_t tableSize = 1;
+		while (tableSize < 2 * m_bucketKeys.size())
+		{
+			tableSize <<= 1;
+		}
+
+		m_hashTable.assign(tableSize, std::numeric_limits<size_t>::max());
+
+		for (size_t b = 0; b < m_bucketKeys.size(); ++b)
+		{
+			size_t slot = HashMortonCode(m_bucketKeys[b]) & (tableSize - 1);
+			while (m_hashTable[slot] != std::numeric_limits<size_t>::max())
+			{
+				slot = (slot + 1) & (tableSize - 1);
+			}
+
+			m_hashTable[slot] = b;
+		}
+	}
+
+	void PointCompactHashGridSearcher3::ForEachNearbyPoint(const Vector3D& origin, double radius, const ForEachNearbyPointFunc& callback) const
+	{
+		const double queryRadiusSquared = radius * radius;
+		const Vector3D extent(radius, radius, radius);
+
+		ForEachBucketRange(GetBucketIndex(origin - extent), GetBucketIndex(origin + extent), [&](size_t start, size_t end)
+		{
+			for (size_t j = start; j < end; ++j)
+			{
+				if ((m_points[j] - origin).LengthSquared() <= queryRadiusSquared)
+				{
+					callback(m_sortedIndices[j], m_points[j]);
+				}
+			}
+		});
+	}
+
+	bool PointCompactHashGridSearcher3::HasNearbyPoint(const Vector3D& origin, double radius) const
+	{
+		const double queryRadiusSquared = radius * radius;
+		const Vector3D extent(radius, radius, radius);
+		bool hasNearbyPoint = false;
+
+		ForEachBucketRange(GetBucketIndex(origin - extent), GetBucketIndex(origin + extent), [&](size_t start, size_t end)
+		{
+			for (size_t j = start; j < end && !hasNearbyPoint; ++j)
+			{
+				hasNearbyPoint = (m_points[j] - origin).LengthSquared() <= queryRadiusSquared;
+			}
+		});
+
+		return hasNearbyPoint;
+	}
+
+	void PointCompactHashGridSearcher3::BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const
+	{
+		if (points.size() != m_points.size())
+		{
+			PointNeighborSearcher3::BuildNeighborLists(points, radius, neighborLists);
+			return;
+		}
+
+		neighborLists->resize(m_points.size());
+
+		const double queryRadiusSquared = radius * radius;
+		const size_t extent = static_cast<size_t>(std::ceil(radius / m_gridSpacing));
+
+		ParallelFor(ZERO_SIZE, m_bucketKeys.size(), [&](size_t b)
+		{
+			const size_t begin = m_bucketStarts[b];
+			const size_t end = m_bucketStarts[b + 1];
+
+			// Every point of the bucket shares the ranges of the buckets
+			// around it.
+			std::vector<std::pair<size_t, size_t>> ranges;
+			GetNearbyBucketRanges(b, extent, &ranges);
+			const size_t numberOfRanges = ranges.size();
+
+			for (size_t p = begin; p < end; ++p)
+			{
+				const Vector3D origin = m_points[p];
+				std::vector<size_t>& neighbors = (*neighborLists)[m_sortedIndices[p]];
+				neighbors.clear();
+
+				for (size_t r = 0; r < numberOfRanges; ++r)
+				{
+					for (size_t q = ranges[r].first; q < ranges[r].second; ++q)
+					{
+						const double dx = m_points[q].x - origin.x;
+						const double dy = m_points[q].y - origin.y;
+						const double dz = m_points[q].z - origin.z;
+
+						if (dx * dx + dy * dy + dz * dz <= queryRadiusSquared && q != p)
+						{
+							neighbors.push_back(m_sortedIndices[q]);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	double PointCompactHashGridSearcher3::GetGridSpacing() const
+	{
+		return m_gridSpacing;
+	}
+
+	size_t PointCompactHashGridSearcher3::GetNumberOfOccupiedBuckets() const
+	{
+		return m_bucketKeys.size();
+	}
+
+	std::pair<size_t, size_t> PointCompactHashGridSearcher3::GetBucketRange(size_t bucket) const
+	{
+		return std::make_pair(m_bucketStarts[bucket], m_bucketStarts[bucket + 1]);
+	}
+
+	void PointCompactHashGridSearcher3::GetNearbyBucketRanges(size_t bucket, size_t extent, std::vector<std::pair<size_t, size_t>>* ranges) const
+	{
+		const Point3I bucketIndex = GetBucketIndex(m_points[m_bucketStarts[bucket]]);
+		const ssize_t signedExtent = static_cast<ssize_t>(extent);
+		const Point3I stencil(signedExtent, signedExtent, signedExtent);
+
+		ranges->clear();
+
+		ForEachBucketRange(bucketIndex - stencil, bucketIndex + stencil, [&](size_t start, size_t finish)
+		{
+			ranges->emplace_back(start, finish);
+		});
+
+		// Neighboring buckets are often adjacent in Morton order, so the
+		// ranges are merged as well.
+		std::sort(ranges->begin(), ranges->end());
+
+		size_t numberOfRanges = 0;
+		for (size_t r = 0; r < ranges->size(); ++r)
+		{
+			if (numberOfRanges > 0 && (*ranges)[r].first <= (*ranges)[numberOfRanges - 1].second)
+			{
+				(*ranges)[numberOfRanges - 1].second = std::max((*ranges)[numberOfRanges - 1].second, (*ranges)[r].second);
+			}
+			else
+			{
+				(*ranges)[numberOfRanges++] = (*ranges)[r];
+			}
+		}
+
+		ranges->resize(numberOfRanges);
+	}
+
+	const std::vector<size_t>& PointCompactHashGridSearcher3::SortedIndices() const
+	{
+		return m_sortedIndices;
+	}
+
+	Point3I PointCompactHashGridSearcher3::GetBucketIndex(const Vector3D& position) const
+	{
+		Point3I bucketIndex;
+
+		bucketIndex.x = ToBucketCoordinate(std::floor(position.x / m_gridSpacing));
+		bucketIndex.y = ToBucketCoordinate(std::floor(position.y / m_gridSpacing));
+		bucketIndex.z = ToBucketCoordinate(std::floor(position.z / m_gridSpacing));
+
+		return bucketIndex;
+	}
+
+	uint64_t PointCompactHashGridSearcher3::GetMortonCode(const Point3I& bucketIndex)
+	{
+		return SpreadBits(static_cast<uint64_t>(bucketIndex.x + MORTON_BIAS))
+			| (SpreadBits(static_cast<uint64_t>(bucketIndex.y + MORTON_BIAS)) << 1)
+			| (SpreadBits(static_cast<uint64_t>(bucketIndex.z + MORTON_BIAS)) << 2);
+	}
+
+	size_t PointCompactHashGridSearcher3::FindBucket(const Point3I& bucketIndex) const
+	{
+		const uint64_t key = GetMortonCode(bucketIndex);
+		const size_t mask = m_hashTable.size() - 1;
+
+		size_t slot = HashMortonCode(key) & mask;
+		while (m_hashTable[slot] != std::numeric_limits<size_t>::max())
+		{
+			if (m_bucketKeys[m_hashTable[slot]] == key)
+			{
+				return m_hashTable[slot];
+			}
+
+			slot = (slot + 1) & mask;
+		}
+
+		return std::numeric_limits<size_t>::max();
+	}
+
+	PointNeighborSearcher3Ptr PointCompactHashGridSearcher3::Clone() const
+	{
+		return std::shared_ptr<PointCompactHashGridSearcher3>(
+			new PointCompactHashGridSearcher3(*this), [](PointCompactHashGridSearcher3* obj)
+		{
+			delete obj;
+		});
+	}
+
+	PointCompactHashGridSearcher3& PointCompactHashGridSearcher3::operator=(const PointCompactHashGridSearcher3& other)
+	{
+		Set(other);
+		return *this;
+	}
+
+	void PointCompactHashGridSearcher3::Set(const PointCompactHashGridSearcher3& other)
+	{
+		m_gridSpacing = other.m_gridSpacing;
+		m_points = other.m_points;
+		m_sortedIndices = other.m_sortedIndices;
+		m_bucketKeys = other.m_bucketKeys;
+		m_bucketStarts = other.m_bucketStarts;
+		m_hashTable = other.m_hashTable;
+	}
+
+	void PointCompactHashGridSearcher3::Serialize(std::vector<uint8_t>* buffer) const
+	{
+		flatbuffers::FlatBufferBuilder builder(1024);
+
+		// Copy points in the original order
+		std::vector<fbs::Vector3D> points(m_points.size());
+		for (size_t i = 0; i < m_points.size(); ++i)
+		{
+			points[m_sortedIndices[i]] = CubbyFlowToFlatbuffers(m_points[i]);
+		}
+
+		auto fbsPoints = builder.CreateVectorOfStructs(points.data(), points.size());
+
+		// Copy the searcher
+		auto fbsSearcher = fbs::CreatePointCompactHashGridSearcher3(builder, m_gridSpacing, fbsPoints);
+
+		builder.Finish(fbsSearcher);
+
+		uint8_t *buf = builder.GetBufferPointer();
+		size_t size = builder.GetSize();
+
+		buffer->resize(size);
+		memcpy(buffer->data(), buf, size);
+	}
+
+	void PointCompactHashGridSearcher3::Deserialize(const std::vector<uint8_t>& buffer)
+	{
+		auto fbsSearcher = fbs::GetPointCompactHashGridSearcher3(buffer.data());
+
+		// Copy simple data
+		m_gridSpacing = fbsSearcher->gridSpacing();
+
+		// Copy points
+		auto fbsPoints = fbsSearcher->points();
+		std::vector<Vector3D> points(fbsPoints->size());
+		for (uint32_t i = 0; i < fbsPoints->size(); ++i)
+		{
+			points[i] = FlatbuffersToCubbyFlow(*fbsPoints->Get(i));
+		}
+
+		// Rebuild the buckets and the hash table. The build is deterministic,
+		// so they match the ones of the serialized searcher.
+		Build(ConstArrayAccessor1<Vector3D>(points.size(), points.data()));
+	}
+
+	PointCompactHashGridSearcher3::Builder PointCompactHashGridSearcher3::GetBuilder()
+	{
+		return Builder();
+	}
+
+	PointCompactHashGridSearcher3::Builder& PointCompactHashGridSearcher3::Builder::WithGridSpacing(double gridSpacing)
+	{
+		m_gridSpacing = gridSpacing;
+		return *this;
+	}
+
+	PointCompactHashGridSearcher3 PointCompactHashGridSearcher3::Builder::Build() const
+	{
+		return PointCompactHashGridSearcher3(m_gridSpacing);
+	}
+
+	PointCompactHashGridSearcher3Ptr PointCompactHashGridSearcher3::Builder::MakeShared() const
+	{
+		return std::shared_ptr<PointCompactHashGridSearcher3>(
+			new PointCompactHashGridSearcher3(m_gridSpacing), [](PointCompactHashGridSearcher3* obj)
+		{
+			delete obj;
+		});
+	}
+
+	PointNeighborSearcher3Ptr PointCompactHashGridSearcher3::Builder::BuildPointNeighborSearcher() const
+	{
+		return MakeShared();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*************************************************************************
+> File Name: PointHierarchicalHashGridSearcher3.cpp
+> Project Name: CubbyFlow
+> Purpose: Hierarchical hash grid-based 3-D point searcher for per-point radii.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/Math/MathUtils.h>
+#include <Core/Searcher/PointHierarchicalHashGridSearcher3.h>
+#include <Core/Utils/Parallel.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace CubbyFlow
+{
+	void PointHierarchicalHashGridSearcher3::Build(const ConstArrayAccessor1<Vector3D>& points, const ConstArrayAccessor1<double>& radii)
+	{
+		m_points.assign(points.begin(), points.end());
+		m_radii.assign(radii.begin(), radii.end());
+		m_levelMaxRadii.clear();
+		m_levelIndices.clear();
+		m_levelSearchers.clear();
+
+		if (m_points.empty())
+		{
+			return;
+		}
+
+		m_minRadius = *std::min_element(m_radii.begin(), m_radii.end());
+		const double maxRadius = *std::max_element(m_radii.begin(), m_radii.end());
+		assert(m_minRadius > 0.0);
+
+		const size_t numberOfLevels = static_cast<size_t>(std::floor(std::log2(maxRadius / m_minRadius))) + 1;
+		m_levelMaxRadii.assign(numberOfLevels, 0.0);
+		m_levelIndices.resize(numberOfLevels);
+
+		for (size_t i = 0; i < m_points.size(); ++i)
+		{
+			const size_t level = GetLevel(m_radii[i]);
+			m_levelMaxRadii[level] = std::max(m_levelMaxRadii[level], m_radii[i]);
+			m_levelIndices[level].push_back(i);
+		}
+
+		// The grid spacing of each level is 2x its largest radius, which is the
+		// search radius of a query between two points of that level.
+		for (size_t level = 0; level < numberOfLevels; ++level)
+		{
+			const std::vector<size_t>& indices = m_levelIndices[level];
+			const double spacing = indices.empty() ? 2.0 * m_minRadius * std::exp2(level + 1) : 2.0 * m_levelMaxRadii[level];
+
+			std::vector<Vector3D> levelPoints(indices.size());
+			for (size_t k = 0; k < indices.size(); ++k)
+			{
+				levelPoints[k] = m_points[indices[k]];
+			}
+
+			m_levelSearchers.emplace_back(spacing);
+			m_levelSearchers.back().Build(ConstArrayAccessor1<Vector3D>(levelPoints.size(), levelPoints.data()));
+		}
+	}
+
+	void PointHierarchicalHashGridSearcher3::ForEachNearbyPoint(const Vector3D& origin, double radius, const ForEachNearbyPointFunc& callback) const
+	{
+		for (size_t level = 0; level < m_levelSearchers.size(); ++level)
+		{
+			const std::vector<size_t>& indices = m_levelIndices[level];
+			if (indices.empty())
+			{
+				continue;
+			}
+
+			m_levelSearchers[level].ForEachNearbyPoint(origin, 0.5 * (radius + m_levelMaxRadii[level]),
+				[&](size_t k, const Vector3D& position)
+			{
+				const size_t j = indices[k];
+				if ((position - origin).LengthSquared() <= Square(0.5 * (radius + m_radii[j])))
+				{
+					callback(j, position);
+				}
+			});
+		}
+	}
+
+	bool PointHierarchicalHashGridSearcher3::HasNearbyPoint(const Vector3D& origin, double radius) const
+	{
+		for (size_t level = 0; level < m_levelSearchers.size(); ++level)
+		{
+			const std::vector<size_t>& indices = m_levelIndices[level];
+			if (indices.empty())
+			{
+				continue;
+			}
+
+			bool hasNearbyPoint = false;
+			m_levelSearchers[level].ForEachNearbyPoint(origin, 0.5 * (radius + m_levelMaxRadii[level]),
+				[&](size_t k, const Vector3D& position)
+			{
+				hasNearbyPoint = hasNearbyPoint ||
+					(position - origin).LengthSquared() <= Square(0.5 * (radius + m_radii[indices[k]]));
+			});
+
+			if (hasNearbyPoint)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void PointHierarchicalHashGridSearcher3::BuildNeighborLists(std::vector<std::vector<size_t>>* neighborLists) const
+	{
+		neighborLists->resize(m_points.size());
+
+		ParallelFor(ZERO_SIZE, m_points.size(), [&](size_t i)
+		{
+			std::vector<size_t>& neighbors = (*neighborLists)[i];
+			neighbors.clear();
+
+			ForEachNearbyPoint(m_points[i], m_radii[i], [&](size_t j, const Vector3D&)
+			{
+				if (i != j)
+				{
+					neighbors.push_back(j);
+				}
+			});
+		});
+	}
+
+	size_t PointHierarchicalHashGridSearcher3::GetNumberOfLevels() const
+	{
+		return m_levelSearchers.size();
+	}
+
+	size_t PointHierarchicalHashGridSearcher3::GetNumberOfPointsAt(size_t level) const
+	{
+		return m_levelIndices[level].size();
+	}
+
+	size_t PointHierarchicalHashGridSearcher3::GetLevel(double radius) const
+	{
+		if (m_levelIndices.empty() || radius <= m_minRadius)
+		{
+			return 0;
+		}
+
+		const size_t level = static_cast<size_t>(std::floor(std::log2(radius / m_minRadius)));
+		return std::min(level, m_levelIndices.size() - 1);
+	}
+}
@@ -7,6 +7,7 @@
 > Created Time: 2017/12/05
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
+#include <Core/Array/Array1.h>
 #include <Core/Searcher/PointKdTreeSearcher2.h>
 #include <Core/Utils/FlatbuffersHelper.h>
 #include <Core/Utils/Logging.h>
@@ -40,6 +41,13 @@ namespace CubbyFlow
 		m_tree.ForEachNearbyPoint(origin, radius, callback);
 	}
 
+	void PointKdTreeSearcher2::ForEachKNearestPoints(
+		const Vector2D& origin, size_t k,
+		const ForEachNearbyPointFunc& callback) const
+	{
+		m_tree.ForEachKNearestPoints(origin, k, callback);
+	}
+
 	bool PointKdTreeSearcher2::HasNearbyPoint(const Vector2D& origin, double radius) const
 	{
 		return m_tree.HasNearbyPoint(origin, radius);
@@ -78,17 +86,8 @@ namespace CubbyFlow
 
 		const auto fbsPoints = builder.CreateVectorOfStructs(points.data(), points.size());
 
-		// Copy nodes
-		std::vector<fbs::PointKdTreeSearcherNode2> nodes;
-		for (auto iter = m_tree.BeginNode(); iter != m_tree.EndNode(); ++iter)
-		{
-			nodes.emplace_back(iter->flags, iter->child, iter->item);
-		}
-
-		const auto fbsNodes = builder.CreateVectorOfStructs(nodes);
-
 		// Copy the searcher
-		const auto fbsSearcher = fbs::CreatePointKdTreeSearcher2(builder, fbsPoints, fbsNodes);
+		const auto fbsSearcher = fbs::CreatePointKdTreeSearcher2(builder, fbsPoints);
 
 		// Finish
 		builder.Finish(fbsSearcher);
@@ -104,29 +103,17 @@ namespace CubbyFlow
 	{
 		const auto fbsSearcher = fbs::GetPointKdTreeSearcher2(buffer.data());
 
-		const auto fbsPoints = fbsSearcher->points();
-		const auto fbsNodes = fbsSearcher->nodes();
-
-		m_tree.Reserve(fbsPoints->size(), fbsNodes->size());
-
 		// Copy points
-		const auto pointsIter = m_tree.begin();
+		const auto fbsPoints = fbsSearcher->points();
+		Array1<Vector2D> points(fbsPoints->size());
 		for (uint32_t i = 0; i < fbsPoints->size(); ++i)
 		{
-			pointsIter[i] = FlatbuffersToCubbyFlow(*fbsPoints->Get(i));
+			points[i] = FlatbuffersToCubbyFlow(*fbsPoints->Get(i));
 		}
 
-		// Copy nodes
-		const auto nodesIter = m_tree.BeginNode();
-		for (uint32_t i = 0; i < fbsNodes->size(); ++i)
-		{
-			const auto fbsNode = fbsNodes->Get(i);
-
-			nodesIter[i].flags = fbsNode->flags();
-			nodesIter[i].child = fbsNode->child();
-			nodesIter[i].item = fbsNode->item();
-			nodesIter[i].point = pointsIter[fbsNode->item()];
-		}
+		// Rebuild the tree. The build is deterministic, so the nodes and leaf
+		// buckets match the ones of the serialized searcher.
+		m_tree.Build(points.ConstAccessor());
 	}
 
 	PointKdTreeSearcher2::Builder PointKdTreeSearcher2::GetBuilder()
@@ -8,6 +8,7 @@
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
 #include <Core/Searcher/PointNeighborSearcher3.h>
+#include <Core/Utils/Parallel.h>
 
 namespace CubbyFlow
 {
@@ -21,6 +22,25 @@ namespace CubbyFlow
 		// Do nothing
 	}
 
+	void PointNeighborSearcher3::BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const
+	{
+		neighborLists->resize(points.size());
+
+		ParallelFor(ZERO_SIZE, points.size(), [&](size_t i)
+		{
+			std::vector<size_t>& neighbors = (*neighborLists)[i];
+			neighbors.clear();
+
+			ForEachNearbyPoint(points[i], radius, [&](size_t j, const Vector3D&)
+			{
+				if (i != j)
+				{
+					neighbors.push_back(j);
+				}
+			});
+		});
+	}
+
 	PointNeighborSearcherBuilder3::~PointNeighborSearcherBuilder3()
 	{
 		// Do nothing
@@ -16,6 +16,8 @@
 
 #include <flatbuffers/flatbuffers.h>
 
+#include <algorithm>
+
 namespace CubbyFlow
 {
 	PointParallelHashGridSearcher3::PointParallelHashGridSearcher3(const Size3& resolution, double gridSpacing) :
@@ -193,6 +195,100 @@ namespace CubbyFlow
 		return false;
 	}
 
+	void PointParallelHashGridSearcher3::BuildNeighborLists(const ConstArrayAccessor1<Vector3D>& points, double radius, std::vector<std::vector<size_t>>* neighborLists) const
+	{
+		if (radius > m_gridSpacing || points.size() != m_points.size())
+		{
+			PointNeighborSearcher3::BuildNeighborLists(points, radius, neighborLists);
+			return;
+		}
+
+		const size_t numberOfPoints = m_points.size();
+		neighborLists->resize(numberOfPoints);
+
+		if (numberOfPoints == 0)
+		{
+			return;
+		}
+
+		// Each run of equal keys in m_keys is one occupied bucket.
+		std::vector<size_t> bucketStarts;
+		bucketStarts.push_back(0);
+		for (size_t i = 1; i < numberOfPoints; ++i)
+		{
+			if (m_keys[i] != m_keys[i - 1])
+			{
+				bucketStarts.push_back(i);
+			}
+		}
+		bucketStarts.push_back(numberOfPoints);
+
+		const double queryRadiusSquared = radius * radius;
+
+		// If the radius is at most half of the grid spacing, the neighbors of a
+		// point lie in the 8 buckets around the octant of its bucket, which is
+		// what ForEachNearbyPoint visits. Otherwise the whole 27 bucket stencil
+		// has to be visited.
+		const bool useOctants = 2.0 * radius <= m_gridSpacing;
+
+		ParallelFor(ZERO_SIZE, bucketStarts.size() - 1, [&](size_t b)
+		{
+			// Merged ranges of the sorted points, cached per octant.
+			std::pair<size_t, size_t> ranges[8][27];
+			size_t numberOfRanges[8];
+			bool hasRanges[8] = { false, false, false, false, false, false, false, false };
+			Point3I bucketIndex;
+
+			for (size_t p = bucketStarts[b]; p < bucketStarts[b + 1]; ++p)
+			{
+				const Vector3D origin = m_points[p];
+
+				// Distant buckets can share a key, so the cache is dropped
+				// whenever the actual bucket changes.
+				const Point3I originIndex = GetBucketIndex(origin);
+				if (p == bucketStarts[b] || originIndex != bucketIndex)
+				{
+					bucketIndex = originIndex;
+					std::fill(hasRanges, hasRanges + 8, false);
+				}
+
+				size_t octant = 0;
+				if (useOctants)
+				{
+					octant =
+						((bucketIndex.x + 0.5f) * m_gridSpacing <= origin.x ? 4 : 0) +
+						((bucketIndex.y + 0.5f) * m_gridSpacing <= origin.y ? 2 : 0) +
+						((bucketIndex.z + 0.5f) * m_gridSpacing <= origin.z ? 1 : 0);
+				}
+
+				if (!hasRanges[octant])
+				{
+					numberOfRanges[octant] = GetNearbyRanges(origin, useOctants, ranges[octant]);
+					hasRanges[octant] = true;
+				}
+
+				const std::pair<size_t, size_t>* nearbyRanges = ranges[octant];
+				std::vector<size_t>& neighbors = (*neighborLists)[m_sortedIndices[p]];
+				neighbors.clear();
+
+				for (size_t r = 0; r < numberOfRanges[octant]; ++r)
+				{
+					for (size_t q = nearbyRanges[r].first; q < nearbyRanges[r].second; ++q)
+					{
+						const double dx = m_points[q].x - origin.x;
+						const double dy = m_points[q].y - origin.y;
+						const double dz = m_points[q].z - origin.z;
+
+						if (dx * dx + dy * dy + dz * dz <= queryRadiusSquared && q != p)
+						{
+							neighbors.push_back(m_sortedIndices[q]);
+						}
+					}
+				}
+			}
+		});
+	}
+
 	const std::vector<size_t>& PointParallelHashGridSearcher3::Keys() const
 	{
 		return m_keys;
@@ -314,6 +410,68 @@ namespace CubbyFlow
 		}
 	}
 
+	size_t PointParallelHashGridSearcher3::GetNearbyRanges(const Vector3D& position, bool octantOnly, std::pair<size_t, size_t>* ranges) const
+	{
+		size_t nearbyKeys[27];
+		size_t numberOfKeys = 0;
+
+		if (octantOnly)
+		{
+			GetNearbyKeys(position, nearbyKeys);
+			numberOfKeys = 8;
+		}
+		else
+		{
+			const Point3I bucketIndex = GetBucketIndex(position);
+
+			for (ssize_t k = -1; k <= 1; ++k)
+			{
+				for (ssize_t j = -1; j <= 1; ++j)
+				{
+					for (ssize_t i = -1; i <= 1; ++i)
+					{
+						nearbyKeys[numberOfKeys++] = GetHashKeyFromBucketIndex(bucketIndex + Point3I(i, j, k));
+					}
+				}
+			}
+		}
+
+		size_t numberOfRanges = 0;
+
+		for (size_t i = 0; i < numberOfKeys; ++i)
+		{
+			const size_t start = m_startIndexTable[nearbyKeys[i]];
+
+			// Empty bucket -- continue to next bucket
+			if (start == std::numeric_limits<size_t>::max())
+			{
+				continue;
+			}
+
+			ranges[numberOfRanges++] = std::make_pair(start, m_endIndexTable[nearbyKeys[i]]);
+		}
+
+		// Merge the ranges. Buckets next to each other along x are usually next
+		// to each other in the sorted list as well, and with a small resolution
+		// several buckets may wrap onto the same key.
+		std::sort(ranges, ranges + numberOfRanges);
+
+		size_t numberOfMergedRanges = 0;
+		for (size_t r = 0; r < numberOfRanges; ++r)
+		{
+			if (numberOfMergedRanges > 0 && ranges[r].first <= ranges[numberOfMergedRanges - 1].second)
+			{
+				ranges[numberOfMergedRanges - 1].second = std::max(ranges[numberOfMergedRanges - 1].second, ranges[r].second);
+			}
+			else
+			{
+				ranges[numberOfMergedRanges++] = ranges[r];
+			}
+		}
+
+		return numberOfMergedRanges;
+	}
+
 	PointNeighborSearcher3Ptr PointParallelHashGridSearcher3::Clone() const
 	{
 		return std::shared_ptr<PointParallelHashGridSearcher3>(
@@ -0,0 +1,289 @@
+/*************************************************************************
+> File Name: MacCormackSemiLagrangian3.cpp
+> Project Name: CubbyFlow
+> Purpose: Implementation of 3-D MacCormack semi-Lagrangian advection solver.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/SemiLagrangian/MacCormackSemiLagrangian3.h>
+#include <Core/Utils/Parallel.h>
+
+namespace CubbyFlow
+{
+	namespace
+	{
+		double ElementMin(double a, double b)
+		{
+			return std::min(a, b);
+		}
+
+		double ElementMax(double a, double b)
+		{
+			return std::max(a, b);
+		}
+
+		Vector3D ElementMin(const Vector3D& a, const Vector3D& b)
+		{
+			return Min(a, b);
+		}
+
+		Vector3D ElementMax(const Vector3D& a, const Vector3D& b)
+		{
+			return Max(a, b);
+		}
+
+		using TraceFunc = std::function<Vector3D(const Vector3D&, double)>;
+
+		//! Returns the min/max of the input values of the cell containing \p pt.
+		template <typename T>
+		void GetStencilMinMax(
+			const ConstArrayAccessor3<T>& data,
+			const Vector3D& origin,
+			const Vector3D& gridSpacing,
+			const Vector3D& pt,
+			T* minValue,
+			T* maxValue)
+		{
+			const Size3 size = data.size();
+			ssize_t i, j, k;
+			double fx, fy, fz;
+
+			GetBarycentric((pt.x - origin.x) / gridSpacing.x, 0, static_cast<ssize_t>(size.x) - 1, &i, &fx);
+			GetBarycentric((pt.y - origin.y) / gridSpacing.y, 0, static_cast<ssize_t>(size.y) - 1, &j, &fy);
+			GetBarycentric((pt.z - origin.z) / gridSpacing.z, 0, static_cast<ssize_t>(size.z) - 1, &k, &fz);
+
+			const size_t i0 = static_cast<size_t>(i);
+			const size_t j0 = static_cast<size_t>(j);
+			const size_t k0 = static_cast<size_t>(k);
+			const size_t i1 = std::min(i0 + 1, size.x - 1);
+			const size_t j1 = std::min(j0 + 1, size.y - 1);
+			const size_t k1 = std::min(k0 + 1, size.z - 1);
+
+			*minValue = data(i0, j0, k0);
+			*maxValue = data(i0, j0, k0);
+
+			for (size_t kk : { k0, k1 })
+			{
+				for (size_t jj : { j0, j1 })
+				{
+					for (size_t ii : { i0, i1 })
+					{
+						*minValue = ElementMin(*minValue, data(ii, jj, kk));
+						*maxValue = ElementMax(*maxValue, data(ii, jj, kk));
+					}
+				}
+			}
+		}
+
+		//!
+		//! Solves MacCormack advection for one data array. The input,
+		//! intermediate and output arrays share the same data layout, and
+		//! \p departures are the back-traced points of the data points.
+		//!
+		template <typename T>
+		void AdvectMacCormack(
+			const ConstArrayAccessor3<T>& input,
+			const Vector3D& origin,
+			const Vector3D& gridSpacing,
+			const std::function<T(const Vector3D&)>& inputSampler,
+			ArrayAccessor3<T> intermediate,
+			const std::function<T(const Vector3D&)>& intermediateSampler,
+			ArrayAccessor3<T> output,
+			const ConstArrayAccessor3<Vector3D>& departures,
+			const ConstArrayAccessor3<char>& isAdvected,
+			const TraceFunc& trace,
+			double dt)
+		{
+			const Size3 size = output.size();
+
+			const auto getPosition = [&](size_t i, size_t j, size_t k)
+			{
+				return origin + gridSpacing * Vector3D(
+					static_cast<double>(i), static_cast<double>(j), static_cast<double>(k));
+			};
+
+			// Semi-Lagrangian solution at the back-traced points.
+			ParallelFor(
+				ZERO_SIZE, size.x,
+				ZERO_SIZE, size.y,
+				ZERO_SIZE, size.z,
+				[&](size_t i, size_t j, size_t k)
+			{
+				if (isAdvected(i, j, k))
+				{
+					intermediate(i, j, k) = inputSampler(departures(i, j, k));
+				}
+			});
+
+			// Backward advection, correction and limiter.
+			ParallelFor(
+				ZERO_SIZE, size.x,
+				ZERO_SIZE, size.y,
+				ZERO_SIZE, size.z,
+				[&](size_t i, size_t j, size_t k)
+			{
+				if (!isAdvected(i, j, k))
+				{
+					return;
+				}
+
+				const Vector3D arrival = trace(getPosition(i, j, k), -dt);
+				const T reversed = intermediateSampler(arrival);
+				const T corrected = intermediate(i, j, k) + 0.5 * (input(i, j, k) - reversed);
+
+				T minValue, maxValue;
+				GetStencilMinMax(input, origin, gridSpacing, departures(i, j, k), &minValue, &maxValue);
+
+				output(i, j, k) = Clamp(corrected, minValue, maxValue);
+			});
+		}
+	}
+
+	MacCormackSemiLagrangian3::MacCormackSemiLagrangian3()
+	{
+		// Do nothing
+	}
+
+	MacCormackSemiLagrangian3::~MacCormackSemiLagrangian3()
+	{
+		// Do nothing
+	}
+
+	void MacCormackSemiLagrangian3::Advect(
+		const ScalarGrid3& input,
+		const VectorField3& flow,
+		double dt,
+		ScalarGrid3* output,
+		const ScalarField3& boundarySDF)
+	{
+		if (input.GetDataSize() != output->GetDataSize() || input.GetDataOrigin() != output->GetDataOrigin())
+		{
+			SemiLagrangian3::Advect(input, flow, dt, output, boundarySDF);
+			return;
+		}
+
+		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
+		const TraceFunc trace = [&](const Vector3D& pt, double t)
+		{
+			return BackTrace(flow, t, h, pt, boundarySDF);
+		};
+
+		auto backTraced = GetBackTracedPoints(flow, dt, h, output->GetDataSize(), output->GetDataOrigin(), output->GridSpacing(), boundarySDF);
+		auto intermediate = output->Clone();
+
+		AdvectMacCormack(
+			input.GetConstDataAccessor(),
+			input.GetDataOrigin(),
+			input.GridSpacing(),
+			GetScalarSamplerFunc(input),
+			intermediate->GetDataAccessor(),
+			GetScalarSamplerFunc(*intermediate),
+			output->GetDataAccessor(),
+			backTraced->points.ConstAccessor(),
+			backTraced->isAdvected.ConstAccessor(),
+			trace,
+			dt);
+	}
+
+	void MacCormackSemiLagrangian3::Advect(
+		const CollocatedVectorGrid3& input,
+		const VectorField3& flow,
+		double dt,
+		CollocatedVectorGrid3* output,
+		const ScalarField3& boundarySDF)
+	{
+		if (input.GetDataSize() != output->GetDataSize() || input.GetDataOrigin() != output->GetDataOrigin())
+		{
+			SemiLagrangian3::Advect(input, flow, dt, output, boundarySDF);
+			return;
+		}
+
+		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
+		const TraceFunc trace = [&](const Vector3D& pt, double t)
+		{
+			return BackTrace(flow, t, h, pt, boundarySDF);
+		};
+
+		auto backTraced = GetBackTracedPoints(flow, dt, h, output->GetDataSize(), output->GetDataOrigin(), output->GridSpacing(), boundarySDF);
+		auto intermediate = std::dynamic_pointer_cast<CollocatedVectorGrid3>(output->Clone());
+
+		AdvectMacCormack(
+			input.GetConstDataAccessor(),
+			input.GetDataOrigin(),
+			input.GridSpacing(),
+			GetVectorSamplerFunc(input),
+			intermediate->GetDataAccessor(),
+			GetVectorSamplerFunc(*intermediate),
+			output->GetDataAccessor(),
+			backTraced->points.ConstAccessor(),
+			backTraced->isAdvected.ConstAccessor(),
+			trace,
+			dt);
+	}
+
+	void MacCormackSemiLagrangian3::Advect(
+		const FaceCenteredGrid3& input,
+		const VectorField3& flow,
+		double dt,
+		FaceCenteredGrid3* output,
+		const ScalarField3& boundarySDF)
+	{
+		if (input.Resolution() != output->Resolution() || input.Origin() != output->Origin())
+		{
+			SemiLagrangian3::Advect(input, flow, dt, output, boundarySDF);
+			return;
+		}
+
+		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
+		const TraceFunc trace = [&](const Vector3D& pt, double t)
+		{
+			return BackTrace(flow, t, h, pt, boundarySDF);
+		};
+
+		auto intermediate = std::dynamic_pointer_cast<FaceCenteredGrid3>(output->Clone());
+		auto inputSamplerFunc = GetVectorSamplerFunc(input);
+		auto intermediateSamplerFunc = GetVectorSamplerFunc(*intermediate);
+
+		auto uBackTraced = GetBackTracedPoints(flow, dt, h, output->GetUSize(), output->GetUOrigin(), output->GridSpacing(), boundarySDF);
+		AdvectMacCormack<double>(
+			input.GetUConstAccessor(),
+			input.GetUOrigin(),
+			input.GridSpacing(),
+			[&](const Vector3D& pt) { return inputSamplerFunc(pt).x; },
+			intermediate->GetUAccessor(),
+			[&](const Vector3D& pt) { return intermediateSamplerFunc(pt).x; },
+			output->GetUAccessor(),
+			uBackTraced->points.ConstAccessor(),
+			uBackTraced->isAdvected.ConstAccessor(),
+			trace,
+			dt);
+
+		auto vBackTraced = GetBackTracedPoints(flow, dt, h, output->GetVSize(), output->GetVOrigin(), output->GridSpacing(), boundarySDF);
+		AdvectMacCormack<double>(
+			input.GetVConstAccessor(),
+			input.GetVOrigin(),
+			input.GridSpacing(),
+			[&](const Vector3D& pt) { return inputSamplerFunc(pt).y; },
+			intermediate->GetVAccessor(),
+			[&](const Vector3D& pt) { return intermediateSamplerFunc(pt).y; },
+			output->GetVAccessor(),
+			vBackTraced->points.ConstAccessor(),
+			vBackTraced->isAdvected.ConstAccessor(),
+			trace,
+			dt);
+
+		auto wBackTraced = GetBackTracedPoints(flow, dt, h, output->GetWSize(), output->GetWOrigin(), output->GridSpacing(), boundarySDF);
+		AdvectMacCormack<double>(
+			input.GetWConstAccessor(),
+			input.GetWOrigin(),
+			input.GridSpacing(),
+			[&](const Vector3D& pt) { return inputSamplerFunc(pt).z; },
+			intermediate->GetWAccessor(),
+			[&](const Vector3D& pt) { return intermediateSamplerFunc(pt).z; },
+			output->GetWAccessor(),
+			wBackTraced->points.ConstAccessor(),
+			wBackTraced->isAdvected.ConstAccessor(),
+			trace,
+			dt);
+	}
+}
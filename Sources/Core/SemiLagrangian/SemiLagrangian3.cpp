@@ -8,9 +8,13 @@
 > Copyright (c) 2018, Chan-Ho Chris Ohk
 *************************************************************************/
 #include <Core/SemiLagrangian/SemiLagrangian3.h>
+#include <Core/Utils/Parallel.h>
 
 namespace CubbyFlow
 {
+	//! Max number of data point layouts in the back-trace cache.
+	static const size_t MAX_BACK_TRACE_CACHE_SIZE = 4;
+
 	SemiLagrangian3::SemiLagrangian3()
 	{
 		// Do nothing
@@ -31,9 +35,24 @@ namespace CubbyFlow
 		auto inputSamplerFunc = GetScalarSamplerFunc(input);
 		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
 
+		auto outputDataAcc = output->GetDataAccessor();
+
+		if (m_isUsingBackTraceCache && input.GetDataSize() == output->GetDataSize() && input.GetDataOrigin() == output->GetDataOrigin())
+		{
+			auto backTraced = GetBackTracedPoints(flow, dt, h, output->GetDataSize(), output->GetDataOrigin(), output->GridSpacing(), boundarySDF);
+
+			output->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+			{
+				if (backTraced->isAdvected(i, j, k))
+				{
+					outputDataAcc(i, j, k) = inputSamplerFunc(backTraced->points(i, j, k));
+				}
+			});
+			return;
+		}
+
 		auto inputDataPos = input.GetDataPosition();
 		auto outputDataPos = output->GetDataPosition();
-		auto outputDataAcc = output->GetDataAccessor();
 
 		output->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
 		{
@@ -55,9 +74,24 @@ namespace CubbyFlow
 		auto inputSamplerFunc = GetVectorSamplerFunc(input);
 		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
 
+		auto outputDataAcc = output->GetDataAccessor();
+
+		if (m_isUsingBackTraceCache && input.GetDataSize() == output->GetDataSize() && input.GetDataOrigin() == output->GetDataOrigin())
+		{
+			auto backTraced = GetBackTracedPoints(flow, dt, h, output->GetDataSize(), output->GetDataOrigin(), output->GridSpacing(), boundarySDF);
+
+			output->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+			{
+				if (backTraced->isAdvected(i, j, k))
+				{
+					outputDataAcc(i, j, k) = inputSamplerFunc(backTraced->points(i, j, k));
+				}
+			});
+			return;
+		}
+
 		auto inputDataPos = input.GetDataPosition();
 		auto outputDataPos = output->GetDataPosition();
-		auto outputDataAcc = output->GetDataAccessor();
 
 		output->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
 		{
@@ -79,6 +113,43 @@ namespace CubbyFlow
 		auto inputSamplerFunc = GetVectorSamplerFunc(input);
 		double h = std::min(output->GridSpacing().x, output->GridSpacing().y);
 
+		if (m_isUsingBackTraceCache && input.Resolution() == output->Resolution() && input.Origin() == output->Origin())
+		{
+			auto uBackTraced = GetBackTracedPoints(flow, dt, h, output->GetUSize(), output->GetUOrigin(), output->GridSpacing(), boundarySDF);
+			auto uTargetDataAcc = output->GetUAccessor();
+
+			output->ParallelForEachUIndex([&](size_t i, size_t j, size_t k)
+			{
+				if (uBackTraced->isAdvected(i, j, k))
+				{
+					uTargetDataAcc(i, j, k) = inputSamplerFunc(uBackTraced->points(i, j, k)).x;
+				}
+			});
+
+			auto vBackTraced = GetBackTracedPoints(flow, dt, h, output->GetVSize(), output->GetVOrigin(), output->GridSpacing(), boundarySDF);
+			auto vTargetDataAcc = output->GetVAccessor();
+
+			output->ParallelForEachVIndex([&](size_t i, size_t j, size_t k)
+			{
+				if (vBackTraced->isAdvected(i, j, k))
+				{
+					vTargetDataAcc(i, j, k) = inputSamplerFunc(vBackTraced->points(i, j, k)).y;
+				}
+			});
+
+			auto wBackTraced = GetBackTracedPoints(flow, dt, h, output->GetWSize(), output->GetWOrigin(), output->GridSpacing(), boundarySDF);
+			auto wTargetDataAcc = output->GetWAccessor();
+
+			output->ParallelForEachWIndex([&](size_t i, size_t j, size_t k)
+			{
+				if (wBackTraced->isAdvected(i, j, k))
+				{
+					wTargetDataAcc(i, j, k) = inputSamplerFunc(wBackTraced->points(i, j, k)).z;
+				}
+			});
+			return;
+		}
+
 		auto uSourceDataPos = input.GetUPosition();
 		auto uTargetDataPos = output->GetUPosition();
 		auto uTargetDataAcc = output->GetUAccessor();
@@ -119,6 +190,80 @@ namespace CubbyFlow
 		});
 	}
 
+	bool SemiLagrangian3::GetIsUsingBackTraceCache() const
+	{
+		return m_isUsingBackTraceCache;
+	}
+
+	void SemiLagrangian3::SetIsUsingBackTraceCache(bool isUsing)
+	{
+		m_isUsingBackTraceCache = isUsing;
+
+		if (!m_isUsingBackTraceCache)
+		{
+			ClearBackTraceCache();
+		}
+	}
+
+	void SemiLagrangian3::ClearBackTraceCache()
+	{
+		m_backTraceCache.clear();
+	}
+
+	std::shared_ptr<const SemiLagrangian3::BackTracedPoints> SemiLagrangian3::GetBackTracedPoints(
+		const VectorField3& flow,
+		double dt,
+		double h,
+		const Size3& dataSize,
+		const Vector3D& dataOrigin,
+		const Vector3D& gridSpacing,
+		const ScalarField3& boundarySDF)
+	{
+		if (m_isUsingBackTraceCache)
+		{
+			for (const auto& entry : m_backTraceCache)
+			{
+				if (entry.flow == &flow && entry.boundarySDF == &boundarySDF && entry.dt == dt &&
+					entry.dataSize == dataSize && entry.dataOrigin == dataOrigin && entry.gridSpacing == gridSpacing)
+				{
+					return entry.points;
+				}
+			}
+		}
+
+		auto backTraced = std::make_shared<BackTracedPoints>();
+		backTraced->points.Resize(dataSize);
+		backTraced->isAdvected.Resize(dataSize, 0);
+
+		ParallelFor(
+			ZERO_SIZE, dataSize.x,
+			ZERO_SIZE, dataSize.y,
+			ZERO_SIZE, dataSize.z,
+			[&](size_t i, size_t j, size_t k)
+		{
+			const Vector3D pt = dataOrigin + gridSpacing * Vector3D(
+				static_cast<double>(i), static_cast<double>(j), static_cast<double>(k));
+
+			if (boundarySDF.Sample(pt) > 0.0)
+			{
+				backTraced->points(i, j, k) = BackTrace(flow, dt, h, pt, boundarySDF);
+				backTraced->isAdvected(i, j, k) = 1;
+			}
+		});
+
+		if (m_isUsingBackTraceCache)
+		{
+			if (m_backTraceCache.size() >= MAX_BACK_TRACE_CACHE_SIZE)
+			{
+				m_backTraceCache.pop_front();
+			}
+
+			m_backTraceCache.push_back({ &flow, &boundarySDF, dt, dataSize, dataOrigin, gridSpacing, backTraced });
+		}
+
+		return backTraced;
+	}
+
 	Vector3D SemiLagrangian3::BackTrace(
 		const VectorField3& flow,
 		double dt,
@@ -126,20 +271,21 @@ namespace CubbyFlow
 		const Vector3D& startPt,
 		const ScalarField3& boundarySDF) const
 	{
-		double remainingT = dt;
+		double remainingT = std::fabs(dt);
+		const double direction = (dt < 0.0) ? -1.0 : 1.0;
 		Vector3D pt0 = startPt;
 		Vector3D pt1 = startPt;
 
 		while (remainingT > std::numeric_limits<double>::epsilon())
 		{
 			// Adaptive time-stepping
-			Vector3D vel0 = flow.Sample(pt0);
+			Vector3D vel0 = direction * flow.Sample(pt0);
 			double numSubSteps = std::max(std::ceil(vel0.Length() * remainingT / h), 1.0);
 			dt = remainingT / numSubSteps;
 
 			// Mid-point rule
 			Vector3D midPt = pt0 - 0.5 * dt * vel0;
-			Vector3D midVel = flow.Sample(midPt);
+			Vector3D midVel = direction * flow.Sample(midPt);
 			pt1 = pt0 - dt * midVel;
 
 			// Boundary handling
@@ -50,6 +50,22 @@ namespace CubbyFlow
 		m_closedDomainBoundaryFlag = flag;
 	}
 
+	bool GridBoundaryConditionSolver3::GetIsCachingColliderSDF() const
+	{
+		return m_isCachingColliderSDF;
+	}
+
+	void GridBoundaryConditionSolver3::SetIsCachingColliderSDF(bool isCaching)
+	{
+		m_isCachingColliderSDF = isCaching;
+		InvalidateColliderSDF();
+	}
+
+	void GridBoundaryConditionSolver3::InvalidateColliderSDF()
+	{
+		// Do nothing
+	}
+
 	const Size3& GridBoundaryConditionSolver3::GetGridSize() const
 	{
 		return m_gridSize;
@@ -14,6 +14,7 @@
 #include <Core/Solver/Grid/GridFractionalSinglePhasePressureSolver3.h>
 #include <Core/Solver/Grid/GridFluidSolver3.h>
 #include <Core/Utils/Logging.h>
+#include <Core/Utils/Parallel.h>
 #include <Core/Utils/Timer.h>
 
 namespace CubbyFlow
@@ -134,6 +135,7 @@ namespace CubbyFlow
 
 			// Apply domain boundary flag
 			m_boundaryConditionSolver->SetClosedDomainBoundaryFlag(m_closedDomainBoundaryFlag);
+			m_boundaryConditionSolver->SetIsCachingColliderSDF(m_isCachingColliderSDF);
 		}
 	}
 
@@ -148,6 +150,22 @@ namespace CubbyFlow
 		m_boundaryConditionSolver->SetClosedDomainBoundaryFlag(m_closedDomainBoundaryFlag);
 	}
 
+	bool GridFluidSolver3::GetIsCachingColliderSDF() const
+	{
+		return m_isCachingColliderSDF;
+	}
+
+	void GridFluidSolver3::SetIsCachingColliderSDF(bool isCaching)
+	{
+		m_isCachingColliderSDF = isCaching;
+		m_boundaryConditionSolver->SetIsCachingColliderSDF(m_isCachingColliderSDF);
+	}
+
+	void GridFluidSolver3::InvalidateColliderSDF() const
+	{
+		m_boundaryConditionSolver->InvalidateColliderSDF();
+	}
+
 	const GridSystemData3Ptr& GridFluidSolver3::GetGridSystemData() const
 	{
 		return m_grids;
@@ -161,6 +179,61 @@ namespace CubbyFlow
 		m_grids->Resize(newSize, newGridSpacing, newGridOrigin);
 	}
 
+	void GridFluidSolver3::ResizeAndShiftGrid(const Size3& newSize, const Point3I& originOffset) const
+	{
+		m_grids->ResizeAndShift(newSize, originOffset);
+	}
+
+	bool GridFluidSolver3::GetIsUsingAutoResize() const
+	{
+		return m_isUsingAutoResize;
+	}
+
+	void GridFluidSolver3::SetIsUsingAutoResize(bool isUsing)
+	{
+		m_isUsingAutoResize = isUsing;
+	}
+
+	size_t GridFluidSolver3::GetDomainBrickSize() const
+	{
+		return m_domainBrickSize;
+	}
+
+	void GridFluidSolver3::SetDomainBrickSize(size_t brickSize)
+	{
+		m_domainBrickSize = std::max(brickSize, ONE_SIZE);
+	}
+
+	double GridFluidSolver3::GetAutoResizeThreshold() const
+	{
+		return m_autoResizeThreshold;
+	}
+
+	void GridFluidSolver3::SetAutoResizeThreshold(double threshold)
+	{
+		m_autoResizeThreshold = std::max(threshold, 0.0);
+	}
+
+	const Size3& GridFluidSolver3::GetMaxResolution() const
+	{
+		return m_maxResolution;
+	}
+
+	void GridFluidSolver3::SetMaxResolution(const Size3& maxResolution)
+	{
+		m_maxResolution = maxResolution;
+	}
+
+	const Surface3Ptr& GridFluidSolver3::GetMovingWindowTarget() const
+	{
+		return m_movingWindowTarget;
+	}
+
+	void GridFluidSolver3::SetMovingWindowTarget(const Surface3Ptr& target)
+	{
+		m_movingWindowTarget = target;
+	}
+
 	Size3 GridFluidSolver3::GetResolution() const
 	{
 		return m_grids->GetResolution();
@@ -298,7 +371,8 @@ namespace CubbyFlow
 				vel.get(),
 				*GetColliderSDF(),
 				*GetColliderVelocityField(),
-				*GetFluidSDF());
+				*GetFluidSDF(),
+				m_useCompressedLinearSys);
 			ApplyBoundaryCondition();
 		}
 	}
@@ -309,6 +383,15 @@ namespace CubbyFlow
 
 		if (m_advectionSolver != nullptr)
 		{
+			const ScalarField3Ptr boundarySDF = GetAdvectionBoundarySDF();
+
+			// The velocity has changed since the last advection.
+			auto semiLagrangian = std::dynamic_pointer_cast<SemiLagrangian3>(m_advectionSolver);
+			if (semiLagrangian != nullptr)
+			{
+				semiLagrangian->ClearBackTraceCache();
+			}
+
 			// Solve advections for custom scalar fields.
 			size_t n = m_grids->GetNumberOfAdvectableScalarData();
 
@@ -322,7 +405,7 @@ namespace CubbyFlow
 					*vel,
 					timeIntervalInSeconds,
 					grid.get(),
-					*GetColliderSDF());
+					*boundarySDF);
 				ExtrapolateIntoCollider(grid.get());
 			}
 
@@ -351,7 +434,7 @@ namespace CubbyFlow
 						*vel,
 						timeIntervalInSeconds,
 						collocated.get(),
-						*GetColliderSDF());
+						*boundarySDF);
 					ExtrapolateIntoCollider(collocated.get());
 					continue;
 				}
@@ -366,7 +449,7 @@ namespace CubbyFlow
 						*vel,
 						timeIntervalInSeconds,
 						faceCentered.get(),
-						*GetColliderSDF());
+						*boundarySDF);
 					ExtrapolateIntoCollider(faceCentered.get());
 				}
 			}
@@ -379,8 +462,13 @@ namespace CubbyFlow
 				*vel0,
 				timeIntervalInSeconds,
 				vel.get(),
-				*GetColliderSDF());
+				*boundarySDF);
 			ApplyBoundaryCondition();
+
+			if (semiLagrangian != nullptr)
+			{
+				semiLagrangian->ClearBackTraceCache();
+			}
 		}
 	}
 
@@ -389,6 +477,11 @@ namespace CubbyFlow
 		return std::make_shared<ConstantScalarField3>(-std::numeric_limits<double>::max());
 	}
 
+	ScalarField3Ptr GridFluidSolver3::GetAdvectionBoundarySDF() const
+	{
+		return GetColliderSDF();
+	}
+
 	void GridFluidSolver3::ComputeGravity(double timeIntervalInSeconds)
 	{
 		if (m_gravity.LengthSquared() > std::numeric_limits<double>::epsilon())
@@ -548,8 +641,13 @@ namespace CubbyFlow
 
 	void GridFluidSolver3::BeginAdvanceTimeStep(double timeIntervalInSeconds)
 	{
-		// Update collider and emitter
+		// Update domain
 		Timer timer;
+		UpdateDomain();
+		CUBBYFLOW_INFO << "Update domain took " << timer.DurationInSeconds() << " seconds";
+
+		// Update collider and emitter
+		timer.Reset();
 		UpdateCollider(timeIntervalInSeconds);
 		CUBBYFLOW_INFO << "Update collider took " << timer.DurationInSeconds() << " seconds";
 
@@ -581,6 +679,136 @@ namespace CubbyFlow
 		OnEndAdvanceTimeStep(timeIntervalInSeconds);
 	}
 
+	void GridFluidSolver3::UpdateDomain() const
+	{
+		const Size3 resolution = m_grids->GetResolution();
+		const Vector3D gridSpacing = m_grids->GetGridSpacing();
+		const ssize_t brickSize = static_cast<ssize_t>(m_domainBrickSize);
+
+		Size3 newResolution = resolution;
+		Point3I originOffset;
+
+		// Move the window by whole bricks toward the target.
+		if (m_movingWindowTarget != nullptr)
+		{
+			const Vector3D targetCenter = m_movingWindowTarget->BoundingBox().MidPoint();
+			const Vector3D domainCenter = m_grids->GetOrigin() + 0.5 * gridSpacing * Vector3D(
+				static_cast<double>(resolution.x),
+				static_cast<double>(resolution.y),
+				static_cast<double>(resolution.z));
+			const Vector3D cellOffset = (targetCenter - domainCenter) / gridSpacing;
+
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const ssize_t numberOfBricks = static_cast<ssize_t>(cellOffset[axis] / static_cast<double>(brickSize));
+				originOffset[axis] = numberOfBricks * brickSize;
+			}
+		}
+
+		// Grow the domain by whole bricks where the content is close to the boundary.
+		if (m_isUsingAutoResize)
+		{
+			struct IndexRange
+			{
+				Point3I lower;
+				Point3I upper;
+			};
+
+			IndexRange emptyRange;
+			emptyRange.lower = Point3I(std::numeric_limits<ssize_t>::max(), std::numeric_limits<ssize_t>::max(), std::numeric_limits<ssize_t>::max());
+			emptyRange.upper = Point3I(-1, -1, -1);
+
+			const auto merge = [](const IndexRange& a, const IndexRange& b)
+			{
+				IndexRange result;
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					result.lower[axis] = std::min(a.lower[axis], b.lower[axis]);
+					result.upper[axis] = std::max(a.upper[axis], b.upper[axis]);
+				}
+				return result;
+			};
+
+			IndexRange content = emptyRange;
+			const double threshold = m_autoResizeThreshold;
+			const ScalarField3Ptr fluidSDF = GetFluidSDF();
+
+			for (size_t n = 0; n < m_grids->GetNumberOfAdvectableScalarData(); ++n)
+			{
+				const ScalarGrid3Ptr& grid = m_grids->GetAdvectableScalarDataAt(n);
+				const auto data = grid->GetConstDataAccessor();
+
+				// The fluid SDF is non-zero nearly everywhere, so only its inside
+				// counts as content.
+				const bool isFluidSDF = grid == fluidSDF;
+				const Size3 size = data.size();
+				const ssize_t iEnd = std::min(static_cast<ssize_t>(size.x), static_cast<ssize_t>(resolution.x));
+				const ssize_t jEnd = std::min(static_cast<ssize_t>(size.y), static_cast<ssize_t>(resolution.y));
+
+				const IndexRange range = ParallelReduce(ZERO_SIZE, std::min(size.z, resolution.z), emptyRange,
+					[&](size_t kBegin, size_t kEnd, IndexRange init)
+				{
+					for (size_t k = kBegin; k < kEnd; ++k)
+					{
+						for (ssize_t j = 0; j < jEnd; ++j)
+						{
+							for (ssize_t i = 0; i < iEnd; ++i)
+							{
+								const double value = data(static_cast<size_t>(i), static_cast<size_t>(j), k);
+								if (isFluidSDF ? IsInsideSDF(value) : std::fabs(value) > threshold)
+								{
+									const Point3I index(i, j, static_cast<ssize_t>(k));
+									init = merge(init, IndexRange{ index, index });
+								}
+							}
+						}
+					}
+
+					return init;
+				}, merge);
+
+				content = merge(content, range);
+			}
+
+			if (content.upper.x >= 0)
+			{
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					// Content range in the moved window.
+					const ssize_t lower = content.lower[axis] - originOffset[axis];
+					const ssize_t upper = content.upper[axis] - originOffset[axis];
+					const ssize_t size = static_cast<ssize_t>(resolution[axis]);
+
+					ssize_t lowerGrowth = 0;
+					ssize_t upperGrowth = 0;
+					if (lower < brickSize)
+					{
+						lowerGrowth = (brickSize - lower + brickSize - 1) / brickSize * brickSize;
+					}
+					if (size - 1 - upper < brickSize)
+					{
+						upperGrowth = (brickSize - (size - 1 - upper) + brickSize - 1) / brickSize * brickSize;
+					}
+
+					const size_t maxSize = std::max(m_maxResolution[axis], resolution[axis]);
+					const ssize_t available = static_cast<ssize_t>(std::min(maxSize - resolution[axis], static_cast<size_t>(std::numeric_limits<ssize_t>::max())));
+					lowerGrowth = std::min(lowerGrowth, available);
+					upperGrowth = std::min(upperGrowth, available - lowerGrowth);
+
+					originOffset[axis] -= lowerGrowth;
+					newResolution[axis] += static_cast<size_t>(lowerGrowth + upperGrowth);
+				}
+			}
+		}
+
+		if (newResolution != resolution || originOffset != Point3I())
+		{
+			m_grids->ResizeAndShift(newResolution, originOffset);
+
+			CUBBYFLOW_INFO << "Domain updated to " << newResolution.x << " x " << newResolution.y << " x " << newResolution.z;
+		}
+	}
+
 	void GridFluidSolver3::UpdateCollider(double timeIntervalInSeconds) const
 	{
 		if (m_collider != nullptr)
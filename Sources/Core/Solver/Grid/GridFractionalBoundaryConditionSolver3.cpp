@@ -14,8 +14,14 @@
 #include <Core/Surface/SurfaceToImplicit3.h>
 #include <Core/Utils/PhysicsHelpers.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace CubbyFlow
 {
+	// Width of the band around the swept region of a moving collider in cells
+	const double COLLIDER_SDF_BAND_CELLS = 4.0;
+
 	GridFractionalBoundaryConditionSolver3::GridFractionalBoundaryConditionSolver3()
 	{
 		// Do nothing
@@ -295,6 +301,11 @@ namespace CubbyFlow
 		return m_colliderVel;
 	}
 
+	void GridFractionalBoundaryConditionSolver3::InvalidateColliderSDF()
+	{
+		m_isColliderSDFValid = false;
+	}
+
 	void GridFractionalBoundaryConditionSolver3::OnColliderUpdated(
 		const Size3& gridSize,
 		const Vector3D& gridSpacing,
@@ -305,21 +316,48 @@ namespace CubbyFlow
 			m_colliderSDF = std::make_shared<CellCenteredScalarGrid3>();
 		}
 
-		m_colliderSDF->Resize(gridSize, gridSpacing, gridOrigin);
+		if (m_colliderSDF->Resolution() != gridSize ||
+			m_colliderSDF->GridSpacing() != gridSpacing ||
+			m_colliderSDF->Origin() != gridOrigin)
+		{
+			m_colliderSDF->Resize(gridSize, gridSpacing, gridOrigin);
+			m_isColliderSDFValid = false;
+		}
 
-		if (GetCollider() != nullptr)
+		const Collider3Ptr& collider = GetCollider();
+
+		if (collider == nullptr)
 		{
-			Surface3Ptr surface = GetCollider()->GetSurface();
-			ImplicitSurface3Ptr implicitSurface = std::dynamic_pointer_cast<ImplicitSurface3>(surface);
-			if (implicitSurface == nullptr)
+			if (!m_isColliderSDFValid || m_lastCollider != nullptr)
 			{
-				implicitSurface = std::make_shared<SurfaceToImplicit3>(surface);
+				m_colliderSDF->Fill(std::numeric_limits<double>::max());
+
+				m_colliderVel = CustomVectorField3::Builder()
+					.WithFunction([](const Vector3D&)
+				{
+					return Vector3D();
+				})
+					.WithDerivativeResolution(gridSpacing.x)
+					.MakeShared();
 			}
 
-			m_colliderSDF->Fill([&](const Vector3D& pt)
+			m_colliderSurface = nullptr;
+			m_localColliderSDF = nullptr;
+			m_lastCollider = nullptr;
+			m_lastSurface = nullptr;
+			m_isColliderSDFValid = true;
+			return;
+		}
+
+		const Surface3Ptr& surface = collider->GetSurface();
+
+		if (collider != m_lastCollider || surface != m_lastSurface)
+		{
+			m_colliderSurface = std::dynamic_pointer_cast<ImplicitSurface3>(surface);
+			if (m_colliderSurface == nullptr)
 			{
-				return implicitSurface->SignedDistance(pt);
-			});
+				m_colliderSurface = std::make_shared<SurfaceToImplicit3>(surface);
+			}
 
 			m_colliderVel = CustomVectorField3::Builder()
 				.WithFunction([&](const Vector3D& x)
@@ -328,18 +366,158 @@ namespace CubbyFlow
 			})
 				.WithDerivativeResolution(gridSpacing.x)
 				.MakeShared();
+
+			m_lastCollider = collider;
+			m_lastSurface = surface;
+			m_isColliderSDFValid = false;
 		}
-		else
+
+		const Transform3& transform = surface->transform;
+		const BoundingBox3D boundingBox = surface->BoundingBox();
+		const double dmax = std::numeric_limits<double>::max();
+		const BoundingBox3D wholeRegion(Vector3D(-dmax, -dmax, -dmax), Vector3D(dmax, dmax, dmax));
+
+		if (!GetIsCachingColliderSDF())
 		{
-			m_colliderSDF->Fill(std::numeric_limits<double>::max());
+			UpdateColliderSDF(wholeRegion, false);
+			m_localColliderSDF = nullptr;
+			m_isColliderSDFValid = false;
+			return;
+		}
 
-			m_colliderVel = CustomVectorField3::Builder()
-				.WithFunction([](const Vector3D&)
+		if (!m_isColliderSDFValid)
+		{
+			UpdateColliderSDF(wholeRegion, false);
+			BuildLocalColliderSDF(gridSpacing);
+			m_staleDistance = 0.0;
+		}
+		else if (transform.GetTranslation() != m_lastTransform.GetTranslation() ||
+			!(transform.GetOrientation() == m_lastTransform.GetOrientation()))
+		{
+			if (m_localColliderSDF == nullptr)
 			{
-				return Vector3D();
-			})
-				.WithDerivativeResolution(gridSpacing.x)
-				.MakeShared();
+				UpdateColliderSDF(wholeRegion, false);
+			}
+			else
+			{
+				// Any point of the surface stays inside the cached box, so the
+				// corners bound how far the surface has moved.
+				const BoundingBox3D& localBox = m_localColliderSDF->BoundingBox();
+				double distance = 0.0;
+				for (size_t c = 0; c < 8; ++c)
+				{
+					const Vector3D corner = localBox.Corner(c);
+					distance = std::max(distance, transform.ToWorld(corner).DistanceTo(m_lastTransform.ToWorld(corner)));
+				}
+
+				// The distances outside the swept region are only refreshed once
+				// their error would exceed the band around it.
+				const double band = COLLIDER_SDF_BAND_CELLS * gridSpacing.Max();
+				m_staleDistance += distance;
+
+				if (m_staleDistance > band)
+				{
+					UpdateColliderSDF(wholeRegion, true);
+					m_staleDistance = 0.0;
+				}
+				else
+				{
+					BoundingBox3D region = m_lastBoundingBox;
+					region.Merge(boundingBox);
+					region.Expand(band);
+
+					UpdateColliderSDF(region, true);
+				}
+			}
+		}
+
+		m_lastTransform = transform;
+		m_lastBoundingBox = boundingBox;
+		m_isColliderSDFValid = true;
+	}
+
+	void GridFractionalBoundaryConditionSolver3::BuildLocalColliderSDF(const Vector3D& gridSpacing)
+	{
+		m_localColliderSDF = nullptr;
+
+		const Transform3& transform = m_lastSurface->transform;
+		const double band = COLLIDER_SDF_BAND_CELLS * gridSpacing.Max();
+		const double h = gridSpacing.Min();
+
+		BoundingBox3D localBox = transform.ToLocal(m_lastSurface->BoundingBox());
+		localBox.Expand(band);
+
+		const Vector3D extent = localBox.upperCorner - localBox.lowerCorner;
+		if (!std::isfinite(extent.x) || !std::isfinite(extent.y) || !std::isfinite(extent.z))
+		{
+			return;
+		}
+
+		const Size3 resolution(
+			static_cast<size_t>(std::ceil(extent.x / h)),
+			static_cast<size_t>(std::ceil(extent.y / h)),
+			static_cast<size_t>(std::ceil(extent.z / h)));
+
+		// A cache larger than the grid would cost more than rasterizing the grid.
+		const Size3& gridSize = m_colliderSDF->Resolution();
+		if (static_cast<double>(resolution.x) * resolution.y * resolution.z >
+			static_cast<double>(gridSize.x) * gridSize.y * gridSize.z)
+		{
+			return;
 		}
+
+		m_localColliderSDF = std::make_shared<CellCenteredScalarGrid3>(resolution, Vector3D(h, h, h), localBox.lowerCorner);
+		m_localColliderSDF->Fill([&](const Vector3D& pt)
+		{
+			return m_colliderSurface->SignedDistance(transform.ToWorld(pt));
+		}, ExecutionPolicy::Parallel);
+	}
+
+	double GridFractionalBoundaryConditionSolver3::SampleLocalColliderSDF(const Vector3D& pt) const
+	{
+		// Beyond the cached data points, the distance is evaluated exactly.
+		const Size3& resolution = m_localColliderSDF->Resolution();
+		const Vector3D lower = m_localColliderSDF->GetDataOrigin();
+		const Vector3D upper = lower + m_localColliderSDF->GridSpacing() * Vector3D(
+			static_cast<double>(resolution.x - 1),
+			static_cast<double>(resolution.y - 1),
+			static_cast<double>(resolution.z - 1));
+		const Vector3D localPt = m_lastSurface->transform.ToLocal(pt);
+
+		if (BoundingBox3D(lower, upper).Contains(localPt))
+		{
+			return m_localColliderSDF->Sample(localPt);
+		}
+
+		return m_colliderSurface->SignedDistance(pt);
+	}
+
+	void GridFractionalBoundaryConditionSolver3::UpdateColliderSDF(const BoundingBox3D& region, bool isUsingLocalSDF)
+	{
+		auto sdf = m_colliderSDF->GetDataAccessor();
+		auto pos = m_colliderSDF->GetDataPosition();
+		const Size3 size = m_colliderSDF->GetDataSize();
+		const Vector3D& h = m_colliderSDF->GridSpacing();
+		const Vector3D origin = m_colliderSDF->GetDataOrigin();
+
+		const auto toIndex = [](double x, size_t n)
+		{
+			return static_cast<size_t>(std::clamp(x, 0.0, static_cast<double>(n)));
+		};
+
+		const Vector3D lower = (region.lowerCorner - origin) / h;
+		const Vector3D upper = (region.upperCorner - origin) / h;
+
+		ParallelFor(
+			toIndex(std::floor(lower.x), size.x), toIndex(std::ceil(upper.x) + 1.0, size.x),
+			toIndex(std::floor(lower.y), size.y), toIndex(std::ceil(upper.y) + 1.0, size.y),
+			toIndex(std::floor(lower.z), size.z), toIndex(std::ceil(upper.z) + 1.0, size.z),
+			[&](size_t i, size_t j, size_t k)
+		{
+			const Vector3D pt = pos(i, j, k);
+			sdf(i, j, k) = isUsingLocalSDF
+				? SampleLocalColliderSDF(pt)
+				: m_colliderSurface->SignedDistance(pt);
+		});
 	}
 }
\ No newline at end of file
@@ -27,7 +27,8 @@ namespace CubbyFlow
 
 	namespace
 	{
-		void Restrict(const Array3<float>& finer, Array3<float>* coarser)
+		template <typename T>
+		void Restrict(const Array3<T>& finer, Array3<T>* coarser)
 		{
 			// --*--|--*--|--*--|--*--
 			//  1/8   3/8   3/8   1/8
@@ -130,9 +131,9 @@ namespace CubbyFlow
 
 		void BuildSingleSystem(FDMMatrix3* A, FDMVector3* b,
 			const Array3<float>& fluidSDF,
-			const Array3<float>& uWeights,
-			const Array3<float>& vWeights,
-			const Array3<float>& wWeights,
+			const Array3<FixedPoint16>& uWeights,
+			const Array3<FixedPoint16>& vWeights,
+			const Array3<FixedPoint16>& wWeights,
 			std::function<Vector3D(const Vector3D&)> boundaryVel,
 			const FaceCenteredGrid3& input)
 		{
@@ -326,9 +327,9 @@ namespace CubbyFlow
 
 		void BuildSingleSystem(MatrixCSRD* A, VectorND* x, VectorND* b,
 			const Array3<float>& fluidSDF,
-			const Array3<float>& uWeights,
-			const Array3<float>& vWeights,
-			const Array3<float>& wWeights,
+			const Array3<FixedPoint16>& uWeights,
+			const Array3<FixedPoint16>& vWeights,
+			const Array3<FixedPoint16>& wWeights,
 			std::function<Vector3D(const Vector3D&)> boundaryVel,
 			const FaceCenteredGrid3& input)
 		{
@@ -7,9 +7,13 @@
 > Created Time: 2017/08/18
 > Copyright (c) 2018, Dongmin Kim
 *************************************************************************/
+#include <Core/Field/CustomScalarField3.h>
 #include <Core/Grid/CellCenteredScalarGrid3.h>
 #include <Core/Solver/Grid/GridSmokeSolver3.h>
 
+#include <array>
+#include <vector>
+
 namespace CubbyFlow
 {
 	GridSmokeSolver3::GridSmokeSolver3() :
@@ -94,6 +98,53 @@ namespace CubbyFlow
 		m_temperatureDecayFactor = std::clamp(newValue, 0.0, 1.0);
 	}
 
+	bool GridSmokeSolver3::GetIsUsingActiveRegion() const
+	{
+		return m_isUsingActiveRegion;
+	}
+
+	void GridSmokeSolver3::SetIsUsingActiveRegion(bool isUsing)
+	{
+		m_isUsingActiveRegion = isUsing;
+	}
+
+	size_t GridSmokeSolver3::GetActiveRegionBrickSize() const
+	{
+		return m_activeRegionBrickSize;
+	}
+
+	void GridSmokeSolver3::SetActiveRegionBrickSize(size_t newSize)
+	{
+		m_activeRegionBrickSize = std::max(newSize, static_cast<size_t>(1));
+	}
+
+	double GridSmokeSolver3::GetActiveRegionThreshold() const
+	{
+		return m_activeRegionThreshold;
+	}
+
+	void GridSmokeSolver3::SetActiveRegionThreshold(double newValue)
+	{
+		m_activeRegionThreshold = std::max(newValue, 0.0);
+	}
+
+	size_t GridSmokeSolver3::GetNumberOfActiveCells() const
+	{
+		if (!m_isUsingActiveRegion)
+		{
+			const Size3 resolution = GetGridSystemData()->GetResolution();
+			return resolution.x * resolution.y * resolution.z;
+		}
+
+		size_t numberOfActiveCells = 0;
+		ForEachActiveIndex(Size3(), [&](size_t, size_t, size_t)
+		{
+			++numberOfActiveCells;
+		}, ExecutionPolicy::Serial);
+
+		return numberOfActiveCells;
+	}
+
 	ScalarGrid3Ptr GridSmokeSolver3::GetSmokeDensity() const
 	{
 		return GetGridSystemData()->GetAdvectableScalarDataAt(m_smokeDensityDataID);
@@ -104,6 +155,14 @@ namespace CubbyFlow
 		return GetGridSystemData()->GetAdvectableScalarDataAt(m_temperatureDataID);
 	}
 
+	void GridSmokeSolver3::OnBeginAdvanceTimeStep(double timeIntervalInSeconds)
+	{
+		if (m_isUsingActiveRegion)
+		{
+			UpdateActiveRegion(timeIntervalInSeconds);
+		}
+	}
+
 	void GridSmokeSolver3::OnEndAdvanceTimeStep(double timeIntervalInSeconds)
 	{
 		ComputeDiffusion(timeIntervalInSeconds);
@@ -114,6 +173,37 @@ namespace CubbyFlow
 		ComputeBuoyancyForce(timeIntervalInSeconds);
 	}
 
+	ScalarField3Ptr GridSmokeSolver3::GetFluidSDF() const
+	{
+		if (m_isUsingActiveRegion && m_activeRegionSDF != nullptr)
+		{
+			return m_activeRegionSDF;
+		}
+
+		return GridFluidSolver3::GetFluidSDF();
+	}
+
+	ScalarField3Ptr GridSmokeSolver3::GetAdvectionBoundarySDF() const
+	{
+		ScalarField3Ptr colliderSDF = GetColliderSDF();
+
+		if (!m_isUsingActiveRegion || m_activeRegionSDF == nullptr)
+		{
+			return colliderSDF;
+		}
+
+		// The cells outside the active region are treated as a boundary, so they
+		// keep their values.
+		CellCenteredScalarGrid3Ptr activeRegionSDF = m_activeRegionSDF;
+
+		return CustomScalarField3::Builder()
+			.WithFunction([colliderSDF, activeRegionSDF](const Vector3D& x)
+		{
+			return std::min(colliderSDF->Sample(x), -activeRegionSDF->Sample(x));
+		})
+			.MakeShared();
+	}
+
 	void GridSmokeSolver3::ComputeDiffusion(double timeIntervalInSeconds)
 	{
 		if (GetDiffusionSolver() != nullptr)
@@ -128,13 +218,14 @@ namespace CubbyFlow
 					m_smokeDiffusionCoefficient,
 					timeIntervalInSeconds,
 					den.get(),
-					*GetColliderSDF());
+					*GetColliderSDF(),
+					*GetFluidSDF());
 				ExtrapolateIntoCollider(den.get());
 			}
 
 			if (m_temperatureDiffusionCoefficient > std::numeric_limits<double>::epsilon())
 			{
-				auto temp = GetSmokeDensity();
+				auto temp = GetTemperature();
 				const auto temp0 = std::dynamic_pointer_cast<CellCenteredScalarGrid3>(temp->Clone());
 
 				GetDiffusionSolver()->Solve(
@@ -142,19 +233,17 @@ namespace CubbyFlow
 					m_temperatureDiffusionCoefficient,
 					timeIntervalInSeconds,
 					temp.get(),
-					*GetColliderSDF());
+					*GetColliderSDF(),
+					*GetFluidSDF());
 				ExtrapolateIntoCollider(temp.get());
 			}
 		}
 
 		auto den = GetSmokeDensity();
-		den->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
-		{
-			(*den)(i, j, k) *= 1.0 - m_smokeDecayFactor;
-		});
 		auto temp = GetTemperature();
-		temp->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+		ForEachActiveIndex(Size3(), [&](size_t i, size_t j, size_t k)
 		{
+			(*den)(i, j, k) *= 1.0 - m_smokeDecayFactor;
 			(*temp)(i, j, k) *= 1.0 - m_temperatureDecayFactor;
 		});
 	}
@@ -176,11 +265,12 @@ namespace CubbyFlow
 			auto den = GetSmokeDensity();
 			auto temp = GetTemperature();
 
+			// The temperature outside the active region is negligible.
 			double tAmb = 0.0;
-			temp->ForEachCellIndex([&](size_t i, size_t j, size_t k)
+			ForEachActiveIndex(Size3(), [&](size_t i, size_t j, size_t k)
 			{
 				tAmb += (*temp)(i, j, k);
-			});
+			}, ExecutionPolicy::Serial);
 
 			tAmb /= static_cast<double>(temp->Resolution().x * temp->Resolution().y * temp->Resolution().z);
 
@@ -191,38 +281,48 @@ namespace CubbyFlow
 			auto vPos = vel->GetVPosition();
 			auto wPos = vel->GetWPosition();
 
+			// Density and temperature share the layout, so both are sampled with
+			// the same interpolation weights.
+			const std::vector<const ScalarGrid3*> fields = { den.get(), temp.get() };
+
 			if (std::abs(up.x) > std::numeric_limits<double>::epsilon())
 			{
-				vel->ParallelForEachUIndex([&](size_t i, size_t j, size_t k)
+				ForEachActiveIndex(Size3(1, 0, 0), [&](size_t i, size_t j, size_t k)
 				{
-					Vector3D pt = uPos(i, j, k);
+					std::array<double, 2> values;
+					den->SampleMultiple(uPos(i, j, k), fields, ArrayAccessor1<double>(values.size(), values.data()));
+
 					double fBuoy =
-						m_buoyancySmokeDensityFactor * den->Sample(pt) +
-						m_buoyancyTemperatureFactor * (temp->Sample(pt) - tAmb);
+						m_buoyancySmokeDensityFactor * values[0] +
+						m_buoyancyTemperatureFactor * (values[1] - tAmb);
 					u(i, j, k) += timeIntervalInSeconds * fBuoy * up.x;
 				});
 			}
 
 			if (std::abs(up.y) > std::numeric_limits<double>::epsilon())
 			{
-				vel->ParallelForEachVIndex([&](size_t i, size_t j, size_t k)
+				ForEachActiveIndex(Size3(0, 1, 0), [&](size_t i, size_t j, size_t k)
 				{
-					Vector3D pt = vPos(i, j, k);
+					std::array<double, 2> values;
+					den->SampleMultiple(vPos(i, j, k), fields, ArrayAccessor1<double>(values.size(), values.data()));
+
 					double fBuoy =
-						m_buoyancySmokeDensityFactor * den->Sample(pt) +
-						m_buoyancyTemperatureFactor * (temp->Sample(pt) - tAmb);
+						m_buoyancySmokeDensityFactor * values[0] +
+						m_buoyancyTemperatureFactor * (values[1] - tAmb);
 					v(i, j, k) += timeIntervalInSeconds * fBuoy * up.y;
 				});
 			}
 
 			if (std::abs(up.z) > std::numeric_limits<double>::epsilon())
 			{
-				vel->ParallelForEachWIndex([&](size_t i, size_t j, size_t k)
+				ForEachActiveIndex(Size3(0, 0, 1), [&](size_t i, size_t j, size_t k)
 				{
-					Vector3D pt = wPos(i, j, k);
+					std::array<double, 2> values;
+					den->SampleMultiple(wPos(i, j, k), fields, ArrayAccessor1<double>(values.size(), values.data()));
+
 					double fBuoy =
-						m_buoyancySmokeDensityFactor * den->Sample(pt) +
-						m_buoyancyTemperatureFactor * (temp->Sample(pt) - tAmb);
+						m_buoyancySmokeDensityFactor * values[0] +
+						m_buoyancyTemperatureFactor * (values[1] - tAmb);
 					w(i, j, k) += timeIntervalInSeconds * fBuoy * up.z;
 				});
 			}
@@ -231,6 +331,208 @@ namespace CubbyFlow
 		}
 	}
 
+	void GridSmokeSolver3::UpdateActiveRegion(double timeIntervalInSeconds)
+	{
+		const auto grids = GetGridSystemData();
+		const Size3 resolution = grids->GetResolution();
+		const size_t brickSize = m_activeRegionBrickSize;
+		const Size3 brickResolution(
+			(resolution.x + brickSize - 1) / brickSize,
+			(resolution.y + brickSize - 1) / brickSize,
+			(resolution.z + brickSize - 1) / brickSize);
+
+		auto den = GetSmokeDensity()->GetConstDataAccessor();
+		auto temp = GetTemperature()->GetConstDataAccessor();
+		auto vel = grids->GetVelocity();
+		auto u = vel->GetUConstAccessor();
+		auto v = vel->GetVConstAccessor();
+		auto w = vel->GetWConstAccessor();
+
+		const auto forEachCellInBrick = [&](size_t bi, size_t bj, size_t bk, const std::function<bool(size_t, size_t, size_t)>& func)
+		{
+			const size_t iEnd = std::min((bi + 1) * brickSize, resolution.x);
+			const size_t jEnd = std::min((bj + 1) * brickSize, resolution.y);
+			const size_t kEnd = std::min((bk + 1) * brickSize, resolution.z);
+
+			for (size_t k = bk * brickSize; k < kEnd; ++k)
+			{
+				for (size_t j = bj * brickSize; j < jEnd; ++j)
+				{
+					for (size_t i = bi * brickSize; i < iEnd; ++i)
+					{
+						if (func(i, j, k))
+						{
+							return true;
+						}
+					}
+				}
+			}
+
+			return false;
+		};
+
+		// The smoke activates the bricks it occupies.
+		Array3<char> isActive(brickResolution, 0);
+		ParallelFor(
+			ZERO_SIZE, brickResolution.x,
+			ZERO_SIZE, brickResolution.y,
+			ZERO_SIZE, brickResolution.z,
+			[&](size_t bi, size_t bj, size_t bk)
+		{
+			isActive(bi, bj, bk) = forEachCellInBrick(bi, bj, bk, [&](size_t i, size_t j, size_t k)
+			{
+				return std::fabs(den(i, j, k)) > m_activeRegionThreshold ||
+					std::fabs(temp(i, j, k)) > m_activeRegionThreshold;
+			});
+		});
+
+		// Dilate the active bricks by the distance the flow travels in this
+		// time-step plus a cell, one axis at a time.
+		const double dilationInCells = std::ceil(GetCFL(timeIntervalInSeconds)) + 1.0;
+		const size_t dilation = static_cast<size_t>(std::ceil(dilationInCells / static_cast<double>(brickSize)));
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			Array3<char> dilated(brickResolution, 0);
+			ParallelFor(
+				ZERO_SIZE, brickResolution.x,
+				ZERO_SIZE, brickResolution.y,
+				ZERO_SIZE, brickResolution.z,
+				[&](size_t bi, size_t bj, size_t bk)
+			{
+				Point3UI index(bi, bj, bk);
+				const size_t center = index[axis];
+				const size_t begin = center - std::min(center, dilation);
+				const size_t end = std::min(center + dilation + 1, brickResolution[axis]);
+
+				for (size_t n = begin; n < end; ++n)
+				{
+					index[axis] = n;
+					if (isActive(index))
+					{
+						dilated(bi, bj, bk) = 1;
+						return;
+					}
+				}
+			});
+
+			isActive.Swap(dilated);
+		}
+
+		// The bricks which are still moving stay active until the flow settles.
+		// They are not dilated, since the pressure solve spreads the velocity
+		// into every active brick.
+		if (m_activeBricks.size() == brickResolution)
+		{
+			ParallelFor(
+				ZERO_SIZE, brickResolution.x,
+				ZERO_SIZE, brickResolution.y,
+				ZERO_SIZE, brickResolution.z,
+				[&](size_t bi, size_t bj, size_t bk)
+			{
+				if (isActive(bi, bj, bk) || !m_activeBricks(bi, bj, bk))
+				{
+					return;
+				}
+
+				isActive(bi, bj, bk) = forEachCellInBrick(bi, bj, bk, [&](size_t i, size_t j, size_t k)
+				{
+					return std::fabs(u(i, j, k)) > m_activeRegionThreshold ||
+						std::fabs(u(i + 1, j, k)) > m_activeRegionThreshold ||
+						std::fabs(v(i, j, k)) > m_activeRegionThreshold ||
+						std::fabs(v(i, j + 1, k)) > m_activeRegionThreshold ||
+						std::fabs(w(i, j, k)) > m_activeRegionThreshold ||
+						std::fabs(w(i, j, k + 1)) > m_activeRegionThreshold;
+				});
+			});
+		}
+
+		m_activeBricks.Swap(isActive);
+		m_activeBrickList.clear();
+		m_activeBricks.ForEachIndex([&](size_t bi, size_t bj, size_t bk)
+		{
+			if (m_activeBricks(bi, bj, bk))
+			{
+				m_activeBrickList.emplace_back(bi, bj, bk);
+			}
+		});
+
+		if (m_activeRegionSDF == nullptr)
+		{
+			m_activeRegionSDF = std::make_shared<CellCenteredScalarGrid3>();
+		}
+
+		// The interface lies on the faces between the active and inactive cells.
+		const double halfSpacing = 0.5 * grids->GetGridSpacing().Min();
+		m_activeRegionSDF->Resize(resolution, grids->GetGridSpacing(), grids->GetOrigin());
+
+		auto sdf = m_activeRegionSDF->GetDataAccessor();
+		ParallelFor(
+			ZERO_SIZE, resolution.x,
+			ZERO_SIZE, resolution.y,
+			ZERO_SIZE, resolution.z,
+			[&](size_t i, size_t j, size_t k)
+		{
+			sdf(i, j, k) = m_activeBricks(i / brickSize, j / brickSize, k / brickSize) ? -halfSpacing : halfSpacing;
+		});
+	}
+
+	void GridSmokeSolver3::ForEachActiveIndex(
+		const Size3& faceDirection,
+		const std::function<void(size_t, size_t, size_t)>& func,
+		ExecutionPolicy policy) const
+	{
+		const Size3 resolution = GetGridSystemData()->GetResolution();
+
+		if (!m_isUsingActiveRegion || m_activeBricks.size() == Size3())
+		{
+			ParallelFor(
+				ZERO_SIZE, resolution.x + faceDirection.x,
+				ZERO_SIZE, resolution.y + faceDirection.y,
+				ZERO_SIZE, resolution.z + faceDirection.z,
+				func, policy);
+			return;
+		}
+
+		const size_t brickSize = m_activeRegionBrickSize;
+		const Size3 brickResolution = m_activeBricks.size();
+
+		ParallelFor(ZERO_SIZE, m_activeBrickList.size(), [&](size_t n)
+		{
+			const Point3UI& brick = m_activeBrickList[n];
+			Point3UI begin, end;
+
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				begin[axis] = brick[axis] * brickSize;
+				end[axis] = std::min(begin[axis] + brickSize, resolution[axis]);
+
+				// The last face is visited by the next brick if that is active.
+				if (faceDirection[axis] > 0)
+				{
+					Point3UI next = brick;
+					++next[axis];
+
+					if (next[axis] == brickResolution[axis] || !m_activeBricks(next))
+					{
+						++end[axis];
+					}
+				}
+			}
+
+			for (size_t k = begin.z; k < end.z; ++k)
+			{
+				for (size_t j = begin.y; j < end.y; ++j)
+				{
+					for (size_t i = begin.x; i < end.x; ++i)
+					{
+						func(i, j, k);
+					}
+				}
+			}
+		}, policy);
+	}
+
 	GridSmokeSolver3::Builder GridSmokeSolver3::GetBuilder()
 	{
 		return Builder();
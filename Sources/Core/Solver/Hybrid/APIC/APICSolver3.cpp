@@ -78,7 +78,7 @@ namespace CubbyFlow
             flow->GridSpacing(),
             flow->GetWOrigin());
 
-        for (size_t i = 0; i < numberOfParticles; ++i)
+        ParallelForEachParticleInSlabs([&](size_t i)
         {
             std::array<Point3UI, 8> indices;
             std::array<double, 8> weights;
@@ -127,7 +127,7 @@ namespace CubbyFlow
                 wWeight(indices[j]) += weights[j];
                 m_wMarkers(indices[j]) = 1;
             }
-        }
+        });
 
         uWeight.ParallelForEachIndex([&](size_t i, size_t j, size_t k)
         {
@@ -150,6 +150,8 @@ namespace CubbyFlow
                 w(i, j, k) /= wWeight(i, j, k);
             }
         });
+
+        FillNarrowBandInterior();
     }
 
     void APICSolver3::TransferFromGridsToParticles()
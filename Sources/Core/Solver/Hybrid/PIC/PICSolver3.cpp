@@ -9,7 +9,11 @@
 *************************************************************************/
 #include <Core/Array/ArrayUtils.h>
 #include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/LevelSet/LevelSetUtils.h>
+#include <Core/PointsToImplicit/PointSplatter3.h>
+#include <Core/SemiLagrangian/SemiLagrangian3.h>
 #include <Core/Solver/Hybrid/PIC/PICSolver3.h>
+#include <Core/Solver/LevelSet/FMMLevelSetSolver3.h>
 #include <Core/Utils/Logging.h>
 #include <Core/Utils/Timer.h>
 
@@ -58,6 +62,74 @@ namespace CubbyFlow
 		newEmitter->SetTarget(m_particles);
 	}
 
+	bool PICSolver3::GetIsUsingNarrowBand() const
+	{
+		return m_isUsingNarrowBand;
+	}
+
+	void PICSolver3::SetIsUsingNarrowBand(bool isUsing)
+	{
+		m_isUsingNarrowBand = isUsing;
+
+		if (m_isUsingNarrowBand && m_levelSetID == std::numeric_limits<size_t>::max())
+		{
+			auto grids = GetGridSystemData();
+			m_levelSetID = grids->AddScalarData(std::make_shared<CellCenteredScalarGrid3::Builder>(), std::numeric_limits<double>::max());
+			m_interiorVelocityID = grids->AddVectorData(std::make_shared<FaceCenteredGrid3::Builder>());
+		}
+	}
+
+	double PICSolver3::GetNarrowBandWidth() const
+	{
+		return m_narrowBandWidth;
+	}
+
+	void PICSolver3::SetNarrowBandWidth(double width)
+	{
+		m_narrowBandWidth = std::max(width, 1.0);
+	}
+
+	ScalarGrid3Ptr PICSolver3::GetLevelSet() const
+	{
+		if (m_levelSetID == std::numeric_limits<size_t>::max())
+		{
+			return nullptr;
+		}
+
+		return GetGridSystemData()->GetScalarDataAt(m_levelSetID);
+	}
+
+	bool PICSolver3::GetIsUsingReseeding() const
+	{
+		return m_isUsingReseeding;
+	}
+
+	void PICSolver3::SetIsUsingReseeding(bool isUsing)
+	{
+		m_isUsingReseeding = isUsing;
+	}
+
+	size_t PICSolver3::GetMinParticlesPerCell() const
+	{
+		return m_minParticlesPerCell;
+	}
+
+	void PICSolver3::SetMinParticlesPerCell(size_t count)
+	{
+		m_minParticlesPerCell = count;
+		m_maxParticlesPerCell = std::max(m_maxParticlesPerCell, count);
+	}
+
+	size_t PICSolver3::GetMaxParticlesPerCell() const
+	{
+		return m_maxParticlesPerCell;
+	}
+
+	void PICSolver3::SetMaxParticlesPerCell(size_t count)
+	{
+		m_maxParticlesPerCell = std::max(count, m_minParticlesPerCell);
+	}
+
 	void PICSolver3::OnInitialize()
 	{
 		GridFluidSolver3::OnInitialize();
@@ -91,6 +163,22 @@ namespace CubbyFlow
 		CUBBYFLOW_INFO << "BuildSignedDistanceField took "
 			<< timer.DurationInSeconds() << " seconds";
 
+		if (m_isUsingNarrowBand)
+		{
+			timer.Reset();
+			UpdateNarrowBandParticles();
+			CUBBYFLOW_INFO << "UpdateNarrowBandParticles took "
+				<< timer.DurationInSeconds() << " seconds";
+		}
+
+		if (m_isUsingReseeding)
+		{
+			timer.Reset();
+			ReseedParticles();
+			CUBBYFLOW_INFO << "ReseedParticles took "
+				<< timer.DurationInSeconds() << " seconds";
+		}
+
 		timer.Reset();
 		ExtrapolateVelocityToAir();
 		CUBBYFLOW_INFO << "ExtrapolateVelocityToAir took "
@@ -117,6 +205,14 @@ namespace CubbyFlow
 		MoveParticles(timeIntervalInSeconds);
 		CUBBYFLOW_INFO << "MoveParticles took "
 			<< timer.DurationInSeconds() << " seconds";
+
+		if (m_isUsingNarrowBand)
+		{
+			timer.Reset();
+			AdvectNarrowBand(timeIntervalInSeconds);
+			CUBBYFLOW_INFO << "AdvectNarrowBand took "
+				<< timer.DurationInSeconds() << " seconds";
+		}
 	}
 
 	ScalarField3Ptr PICSolver3::GetFluidSDF() const
@@ -129,7 +225,6 @@ namespace CubbyFlow
 		auto flow = GetGridSystemData()->GetVelocity();
 		auto positions = m_particles->GetPositions();
 		auto velocities = m_particles->GetVelocities();
-		size_t numberOfParticles = m_particles->GetNumberOfParticles();
 
 		// Clear velocity to zero
 		flow->Fill(Vector3D());
@@ -159,7 +254,7 @@ namespace CubbyFlow
 			flow->GetWConstAccessor(),
 			flow->GridSpacing(),
 			flow->GetWOrigin());
-		for (size_t i = 0; i < numberOfParticles; ++i)
+		ParallelForEachParticleInSlabs([&](size_t i)
 		{
 			std::array<Point3UI, 8> indices;
 			std::array<double, 8> weights;
@@ -187,7 +282,7 @@ namespace CubbyFlow
 				wWeight(indices[j]) += weights[j];
 				m_wMarkers(indices[j]) = 1;
 			}
-		}
+		});
 
 		uWeight.ParallelForEachIndex([&](size_t i, size_t j, size_t k)
 		{
@@ -210,6 +305,103 @@ namespace CubbyFlow
 				w(i, j, k) /= wWeight(i, j, k);
 			}
 		});
+
+		FillNarrowBandInterior();
+	}
+
+	void PICSolver3::FillNarrowBandInterior()
+	{
+		if (!m_isUsingNarrowBand)
+		{
+			return;
+		}
+
+		auto grids = GetGridSystemData();
+		auto flow = grids->GetVelocity();
+		auto levelSet = GetLevelSet();
+		auto interior = std::dynamic_pointer_cast<FaceCenteredGrid3>(grids->GetVectorDataAt(m_interiorVelocityID));
+
+		auto u = flow->GetUAccessor();
+		auto v = flow->GetVAccessor();
+		auto w = flow->GetWAccessor();
+		auto uPos = flow->GetUPosition();
+		auto vPos = flow->GetVPosition();
+		auto wPos = flow->GetWPosition();
+
+		flow->ParallelForEachUIndex([&](size_t i, size_t j, size_t k)
+		{
+			if (!m_uMarkers(i, j, k) && IsInsideSDF(levelSet->Sample(uPos(i, j, k))))
+			{
+				u(i, j, k) = interior->GetU(i, j, k);
+				m_uMarkers(i, j, k) = 1;
+			}
+		});
+		flow->ParallelForEachVIndex([&](size_t i, size_t j, size_t k)
+		{
+			if (!m_vMarkers(i, j, k) && IsInsideSDF(levelSet->Sample(vPos(i, j, k))))
+			{
+				v(i, j, k) = interior->GetV(i, j, k);
+				m_vMarkers(i, j, k) = 1;
+			}
+		});
+		flow->ParallelForEachWIndex([&](size_t i, size_t j, size_t k)
+		{
+			if (!m_wMarkers(i, j, k) && IsInsideSDF(levelSet->Sample(wPos(i, j, k))))
+			{
+				w(i, j, k) = interior->GetW(i, j, k);
+				m_wMarkers(i, j, k) = 1;
+			}
+		});
+	}
+
+	void PICSolver3::ParallelForEachParticleInSlabs(const std::function<void(size_t)>& func) const
+	{
+		auto flow = GetGridSystemData()->GetVelocity();
+		auto positions = m_particles->GetPositions();
+		const size_t numberOfParticles = m_particles->GetNumberOfParticles();
+		const size_t resolutionZ = flow->Resolution().z;
+		const double h = flow->GridSpacing().z;
+		const double originZ = flow->Origin().z;
+		const size_t numberOfSlabs = (resolutionZ + 1) / 2;
+
+		// Counting sort of the particles by slab, keeping the index order
+		std::vector<size_t> slabs(numberOfParticles);
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			const double k = std::floor((positions[i].z - originZ) / h);
+			slabs[i] = static_cast<size_t>(std::clamp(k, 0.0, static_cast<double>(resolutionZ - 1))) / 2;
+		});
+
+		std::vector<size_t> slabStarts(numberOfSlabs + 1, 0);
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			++slabStarts[slabs[i] + 1];
+		}
+
+		for (size_t s = 0; s < numberOfSlabs; ++s)
+		{
+			slabStarts[s + 1] += slabStarts[s];
+		}
+
+		std::vector<size_t> sortedIndices(numberOfParticles);
+		std::vector<size_t> cursors(slabStarts.begin(), slabStarts.end() - 1);
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			sortedIndices[cursors[slabs[i]]++] = i;
+		}
+
+		for (size_t parity = 0; parity < 2; ++parity)
+		{
+			ParallelFor(ZERO_SIZE, (numberOfSlabs + 1 - parity) / 2, [&](size_t n)
+			{
+				const size_t slab = 2 * n + parity;
+
+				for (size_t idx = slabStarts[slab]; idx < slabStarts[slab + 1]; ++idx)
+				{
+					func(sortedIndices[idx]);
+				}
+			});
+		}
 	}
 
 	void PICSolver3::TransferFromGridsToParticles()
@@ -316,28 +508,319 @@ namespace CubbyFlow
 	void PICSolver3::BuildSignedDistanceField()
 	{
 		auto sdf = GetSignedDistanceField();
-		auto sdfPos = sdf->GetDataPosition();
 		double maxH = std::max({ sdf->GridSpacing().x, sdf->GridSpacing().y, sdf->GridSpacing().z });
 		double radius = 1.2 * maxH / std::sqrt(2.0);
 		double sdfBandRadius = 2.0 * radius;
 
-		m_particles->BuildNeighborSearcher(2 * radius);
-		auto searcher = m_particles->GetNeighborSearcher();
-		sdf->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+		// Each particle only lowers the distance of the cells within the band
+		// radius, so the cells far from any particle are filled just once.
+		sdf->Fill(sdfBandRadius - radius);
+
+		auto sdfAcc = sdf->GetDataAccessor();
+		PointSplatter3 splatter(sdf->GetDataSize(), sdf->GridSpacing(), sdf->GetDataOrigin());
+		splatter.Build(m_particles->GetPositions(), sdfBandRadius);
+		splatter.Splat(sdfBandRadius * sdfBandRadius,
+			[&](double& minDistSquared, size_t, const Vector3D&, double distanceSquared)
+		{
+			minDistSquared = std::min(minDistSquared, distanceSquared);
+		},
+			[&](size_t i, size_t j, size_t k, double minDistSquared)
 		{
-			Vector3D pt = sdfPos(i, j, k);
-			double minDist = sdfBandRadius;
+			sdfAcc(i, j, k) = std::sqrt(minDistSquared) - radius;
+		});
 
-			searcher->ForEachNearbyPoint(pt, sdfBandRadius, [&](size_t, const Vector3D& x)
+		if (m_isUsingNarrowBand)
+		{
+			// Combine the particles with the deep interior of the level set.
+			auto levelSet = GetLevelSet();
+			const double bandWidth = m_narrowBandWidth * maxH;
+			const double maxDistance = bandWidth + 2.0 * maxH;
+
+			sdf->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
 			{
-				minDist = std::min(minDist, pt.DistanceTo(x));
+				if ((*levelSet)(i, j, k) < -bandWidth)
+				{
+					(*sdf)(i, j, k) = std::min((*sdf)(i, j, k), (*levelSet)(i, j, k));
+				}
 			});
-			(*sdf)(i, j, k) = minDist - radius;
-		});
+
+			// Only the cells next to the surface keep their values, so the
+			// reinitialization stops at the max distance, and the rest is
+			// clamped to it.
+			const Size3 size = sdf->GetDataSize();
+			auto levelSetAcc = levelSet->GetDataAccessor();
+			levelSet->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+			{
+				const double phi = (*sdf)(i, j, k);
+				const bool isInside = IsInsideSDF(phi);
+				const bool isNearSurface =
+					(i > 0 && IsInsideSDF((*sdf)(i - 1, j, k)) != isInside) ||
+					(i + 1 < size.x && IsInsideSDF((*sdf)(i + 1, j, k)) != isInside) ||
+					(j > 0 && IsInsideSDF((*sdf)(i, j - 1, k)) != isInside) ||
+					(j + 1 < size.y && IsInsideSDF((*sdf)(i, j + 1, k)) != isInside) ||
+					(k > 0 && IsInsideSDF((*sdf)(i, j, k - 1)) != isInside) ||
+					(k + 1 < size.z && IsInsideSDF((*sdf)(i, j, k + 1)) != isInside);
+
+				levelSetAcc(i, j, k) = isNearSurface ? phi : (isInside ? -maxDistance : maxDistance);
+			});
+
+			auto clamped = levelSet->Clone();
+			FMMLevelSetSolver3().Reinitialize(*clamped, maxDistance, levelSet.get());
+
+			levelSet->ParallelForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+			{
+				levelSetAcc(i, j, k) = std::clamp(levelSetAcc(i, j, k), -maxDistance, maxDistance);
+				(*sdf)(i, j, k) = levelSetAcc(i, j, k);
+			});
+		}
 
 		ExtrapolateIntoCollider(sdf.get());
 	}
 
+	void PICSolver3::UpdateNarrowBandParticles()
+	{
+		auto flow = GetGridSystemData()->GetVelocity();
+		auto levelSet = GetLevelSet();
+		const Vector3D h = levelSet->GridSpacing();
+		const Vector3D origin = levelSet->Origin();
+		const Size3 resolution = levelSet->Resolution();
+		const double maxH = std::max({ h.x, h.y, h.z });
+		const double bandWidth = m_narrowBandWidth * maxH;
+
+		// Delete the particles deeper than the band.
+		size_t numberOfParticles = m_particles->GetNumberOfParticles();
+		auto positions = m_particles->GetPositions();
+
+		Array1<char> isRemoved(numberOfParticles);
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			isRemoved[i] = levelSet->Sample(positions[i]) < -bandWidth ? 1 : 0;
+		});
+		m_particles->RemoveParticles(isRemoved.ConstAccessor());
+
+		// Mark the cells with particles.
+		numberOfParticles = m_particles->GetNumberOfParticles();
+		positions = m_particles->GetPositions();
+
+		Array3<char> hasParticles(resolution, 0);
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			const Vector3D idx = (positions[i] - origin) / h;
+			const ssize_t ci = static_cast<ssize_t>(std::floor(idx.x));
+			const ssize_t cj = static_cast<ssize_t>(std::floor(idx.y));
+			const ssize_t ck = static_cast<ssize_t>(std::floor(idx.z));
+
+			if (ci >= 0 && cj >= 0 && ck >= 0 &&
+				static_cast<size_t>(ci) < resolution.x &&
+				static_cast<size_t>(cj) < resolution.y &&
+				static_cast<size_t>(ck) < resolution.z)
+			{
+				hasParticles(static_cast<size_t>(ci), static_cast<size_t>(cj), static_cast<size_t>(ck)) = 1;
+			}
+		}
+
+		// Seed the band cells without particles, such as the cells left by the
+		// interior moving down. The cells next to the surface are skipped.
+		auto colliderSDF = GetColliderSDF();
+		std::uniform_real_distribution<> jitter(0.0, 0.5);
+		Array1<Vector3D> newPositions;
+		Array1<Vector3D> newVelocities;
+
+		hasParticles.ForEachIndex([&](size_t i, size_t j, size_t k)
+		{
+			const double phi = (*levelSet)(i, j, k);
+			if (hasParticles(i, j, k) || phi >= -maxH || phi < -bandWidth)
+			{
+				return;
+			}
+
+			for (int n = 0; n < 8; ++n)
+			{
+				const Vector3D offset(
+					0.5 * (n & 1) + jitter(m_narrowBandRng),
+					0.5 * ((n >> 1) & 1) + jitter(m_narrowBandRng),
+					0.5 * ((n >> 2) & 1) + jitter(m_narrowBandRng));
+				const Vector3D pt = origin + h * (Vector3D(
+					static_cast<double>(i), static_cast<double>(j), static_cast<double>(k)) + offset);
+
+				if (!IsInsideSDF(colliderSDF->Sample(pt)))
+				{
+					newPositions.Append(pt);
+					newVelocities.Append(flow->Sample(pt));
+				}
+			}
+		});
+
+		m_particles->AddParticles(newPositions.ConstAccessor(), newVelocities.ConstAccessor());
+	}
+
+	void PICSolver3::AdvectNarrowBand(double timeIntervalInSeconds) const
+	{
+		auto advectionSolver = GetAdvectionSolver();
+		if (advectionSolver == nullptr)
+		{
+			return;
+		}
+
+		auto grids = GetGridSystemData();
+		auto flow = grids->GetVelocity();
+		auto levelSet = GetLevelSet();
+		auto interior = std::dynamic_pointer_cast<FaceCenteredGrid3>(grids->GetVectorDataAt(m_interiorVelocityID));
+		const ScalarField3Ptr boundarySDF = GetColliderSDF();
+
+		// The velocity has changed since the last advection.
+		auto semiLagrangian = std::dynamic_pointer_cast<SemiLagrangian3>(advectionSolver);
+		if (semiLagrangian != nullptr)
+		{
+			semiLagrangian->ClearBackTraceCache();
+		}
+
+		auto levelSet0 = levelSet->Clone();
+		advectionSolver->Advect(*levelSet0, *flow, timeIntervalInSeconds, levelSet.get(), *boundarySDF);
+		advectionSolver->Advect(*flow, *flow, timeIntervalInSeconds, interior.get(), *boundarySDF);
+
+		if (semiLagrangian != nullptr)
+		{
+			semiLagrangian->ClearBackTraceCache();
+		}
+	}
+
+	void PICSolver3::ReseedParticles()
+	{
+		auto flow = GetGridSystemData()->GetVelocity();
+		auto sdf = GetSignedDistanceField();
+		auto colliderSDF = GetColliderSDF();
+		const Vector3D h = sdf->GridSpacing();
+		const Vector3D origin = sdf->Origin();
+		const Size3 resolution = sdf->Resolution();
+		const size_t numberOfCells = resolution.x * resolution.y * resolution.z;
+
+		size_t numberOfParticles = m_particles->GetNumberOfParticles();
+		auto positions = m_particles->GetPositions();
+
+		// Cell of each particle, or numberOfCells if it is out of the domain.
+		Array1<size_t> cellIndices(numberOfParticles);
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			const Vector3D idx = (positions[i] - origin) / h;
+			const ssize_t ci = static_cast<ssize_t>(std::floor(idx.x));
+			const ssize_t cj = static_cast<ssize_t>(std::floor(idx.y));
+			const ssize_t ck = static_cast<ssize_t>(std::floor(idx.z));
+
+			if (ci >= 0 && cj >= 0 && ck >= 0 &&
+				static_cast<size_t>(ci) < resolution.x &&
+				static_cast<size_t>(cj) < resolution.y &&
+				static_cast<size_t>(ck) < resolution.z)
+			{
+				cellIndices[i] = static_cast<size_t>(ci) +
+					resolution.x * (static_cast<size_t>(cj) + resolution.y * static_cast<size_t>(ck));
+			}
+			else
+			{
+				cellIndices[i] = numberOfCells;
+			}
+		});
+
+		// Count the particles in index order, so a crowded cell always keeps
+		// its first max particles.
+		Array3<size_t> counts(resolution, 0);
+		Array1<char> isRemoved(numberOfParticles, 0);
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			const size_t c = cellIndices[i];
+			if (c == numberOfCells)
+			{
+				continue;
+			}
+
+			if (counts[c] < m_maxParticlesPerCell)
+			{
+				++counts[c];
+			}
+			else
+			{
+				isRemoved[i] = 1;
+			}
+		}
+
+		m_particles->RemoveParticles(isRemoved.ConstAccessor());
+
+		// With the narrow band, the liquid deeper than the band is left without
+		// particles.
+		const ScalarGrid3Ptr levelSet = m_isUsingNarrowBand ? GetLevelSet() : nullptr;
+		const double bandWidth = m_narrowBandWidth * std::max({ h.x, h.y, h.z });
+		const auto isUnderSampled = [&](size_t i, size_t j, size_t k)
+		{
+			return IsInsideSDF((*sdf)(i, j, k)) && counts(i, j, k) < m_minParticlesPerCell &&
+				(levelSet == nullptr || (*levelSet)(i, j, k) >= -bandWidth);
+		};
+
+		// Offsets of the new particles per under-sampled fluid cell
+		Array3<size_t> offsets(resolution, 0);
+		size_t numberOfCandidates = 0;
+		counts.ForEachIndex([&](size_t i, size_t j, size_t k)
+		{
+			offsets(i, j, k) = numberOfCandidates;
+			if (isUnderSampled(i, j, k))
+			{
+				numberOfCandidates += m_minParticlesPerCell - counts(i, j, k);
+			}
+		});
+
+		if (numberOfCandidates == 0)
+		{
+			return;
+		}
+
+		// Candidates are jittered with a per-cell random sequence, so the
+		// seeding is reproducible regardless of the thread schedule.
+		Array1<Vector3D> newPositions(numberOfCandidates);
+		Array1<Vector3D> newVelocities(numberOfCandidates);
+		Array1<char> isRejected(numberOfCandidates, 1);
+		const unsigned int step = m_reseedingStep++;
+
+		counts.ParallelForEachIndex([&](size_t i, size_t j, size_t k)
+		{
+			if (!isUnderSampled(i, j, k))
+			{
+				return;
+			}
+
+			std::minstd_rand rng(static_cast<unsigned int>(counts.Accessor().Index(i, j, k)) * 2654435761u + step);
+			std::uniform_real_distribution<> d(0.0, 1.0);
+
+			const size_t offset = offsets(i, j, k);
+			for (size_t n = 0; n < m_minParticlesPerCell - counts(i, j, k); ++n)
+			{
+				const Vector3D pt = origin + h * Vector3D(
+					static_cast<double>(i) + d(rng),
+					static_cast<double>(j) + d(rng),
+					static_cast<double>(k) + d(rng));
+
+				if (IsInsideSDF(sdf->Sample(pt)) && !IsInsideSDF(colliderSDF->Sample(pt)) &&
+					(levelSet == nullptr || levelSet->Sample(pt) >= -bandWidth))
+				{
+					newPositions[offset + n] = pt;
+					newVelocities[offset + n] = flow->Sample(pt);
+					isRejected[offset + n] = 0;
+				}
+			}
+		});
+
+		Array1<Vector3D> acceptedPositions;
+		Array1<Vector3D> acceptedVelocities;
+		for (size_t i = 0; i < numberOfCandidates; ++i)
+		{
+			if (!isRejected[i])
+			{
+				acceptedPositions.Append(newPositions[i]);
+				acceptedVelocities.Append(newVelocities[i]);
+			}
+		}
+
+		m_particles->AddParticles(acceptedPositions.ConstAccessor(), acceptedVelocities.ConstAccessor());
+	}
+
 	void PICSolver3::UpdateParticleEmitter(double timeIntervalInSeconds) const
 	{
 		if (m_particleEmitter != nullptr)
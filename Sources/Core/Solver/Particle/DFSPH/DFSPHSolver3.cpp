@@ -0,0 +1,469 @@
+/*************************************************************************
+> File Name: DFSPHSolver3.cpp
+> Project Name: CubbyFlow
+> Purpose: 3-D DFSPH solver.
+> Created Time: 2026/10/17
+> Copyright (c) 2018, Chan-Ho Chris Ohk
+*************************************************************************/
+#include <Core/Solver/Particle/DFSPH/DFSPHSolver3.h>
+#include <Core/SPH/SPHStdKernel3.h>
+#include <Core/Utils/Logging.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace CubbyFlow
+{
+	// Courant number of the CFL condition
+	const double CFL_FACTOR = 0.4;
+
+	// Fraction of the previous stiffness applied by the warm start
+	const double WARM_START_SCALE = 0.5;
+
+	// Particles with fewer neighbors than this fraction of a full neighborhood
+	// are at the surface, where the divergence is not corrected
+	const double MIN_DIVERGENCE_NEIGHBOR_RATIO = 0.6;
+
+	// Denominators below this value are treated as isolated particles
+	const double MIN_FACTOR_DENOMINATOR = 1e-6;
+
+	DFSPHSolver3::DFSPHSolver3()
+	{
+		// Do nothing
+	}
+
+	DFSPHSolver3::DFSPHSolver3(double targetDensity, double targetSpacing, double relativeKernelRadius) :
+		SPHSolver3(targetDensity, targetSpacing, relativeKernelRadius)
+	{
+		// Do nothing
+	}
+
+	DFSPHSolver3::~DFSPHSolver3()
+	{
+		// Do nothing
+	}
+
+	double DFSPHSolver3::GetMaxDensityErrorRatio() const
+	{
+		return m_maxDensityErrorRatio;
+	}
+
+	void DFSPHSolver3::SetMaxDensityErrorRatio(double ratio)
+	{
+		m_maxDensityErrorRatio = std::max(ratio, 0.0);
+	}
+
+	double DFSPHSolver3::GetMaxDivergenceErrorRatio() const
+	{
+		return m_maxDivergenceErrorRatio;
+	}
+
+	void DFSPHSolver3::SetMaxDivergenceErrorRatio(double ratio)
+	{
+		m_maxDivergenceErrorRatio = std::max(ratio, 0.0);
+	}
+
+	unsigned int DFSPHSolver3::GetMaxNumberOfIterations() const
+	{
+		return m_maxNumberOfIterations;
+	}
+
+	void DFSPHSolver3::SetMaxNumberOfIterations(unsigned int n)
+	{
+		m_maxNumberOfIterations = n;
+	}
+
+	bool DFSPHSolver3::GetIsUsingWarmStart() const
+	{
+		return m_isUsingWarmStart;
+	}
+
+	void DFSPHSolver3::SetIsUsingWarmStart(bool isUsing)
+	{
+		m_isUsingWarmStart = isUsing;
+	}
+
+	unsigned int DFSPHSolver3::GetLastNumberOfDensityIterations() const
+	{
+		return m_lastNumberOfDensityIterations;
+	}
+
+	unsigned int DFSPHSolver3::GetLastNumberOfDivergenceIterations() const
+	{
+		return m_lastNumberOfDivergenceIterations;
+	}
+
+	unsigned int DFSPHSolver3::GetNumberOfSubTimeSteps(double timeIntervalInSeconds) const
+	{
+		auto particles = GetSPHSystemData();
+		size_t numberOfParticles = particles->GetNumberOfParticles();
+		auto v = particles->GetVelocities();
+
+		double maxSpeed = 0.0;
+
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			maxSpeed = std::max(maxSpeed, v[i].Length());
+		}
+
+		if (maxSpeed <= 0.0)
+		{
+			return 1;
+		}
+
+		double desiredTimeStep = GetTimeStepLimitScale() * CFL_FACTOR * particles->GetTargetSpacing() / maxSpeed;
+
+		return std::max(1u, static_cast<unsigned int>(std::ceil(timeIntervalInSeconds / desiredTimeStep)));
+	}
+
+	void DFSPHSolver3::AccumulatePressureForce(double timeIntervalInSeconds)
+	{
+		auto particles = GetSPHSystemData();
+		const size_t numberOfParticles = particles->GetNumberOfParticles();
+		const double mass = particles->GetMass();
+
+		auto v = particles->GetVelocities();
+		auto f = particles->GetForces();
+
+		// Predict velocity with the non-pressure forces
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			m_tempVelocities[i] = v[i] + timeIntervalInSeconds / mass * f[i];
+		});
+
+		CorrectDensityError(timeIntervalInSeconds);
+
+		// Replace the forces with the ones reaching the corrected velocity
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			f[i] = mass * (m_tempVelocities[i] - v[i]) / timeIntervalInSeconds;
+		});
+	}
+
+	bool DFSPHSolver3::IsCellTilingActive() const
+	{
+		return false;
+	}
+
+	void DFSPHSolver3::OnBeginAdvanceTimeStep(double timeStepInSeconds)
+	{
+		auto particles = GetSPHSystemData();
+
+		if (particles->GetIsUsingAdaptiveKernel())
+		{
+			throw std::invalid_argument("DFSPH requires a single kernel radius, but the adaptive kernel is enabled.");
+		}
+
+		SPHSolver3::OnBeginAdvanceTimeStep(timeStepInSeconds);
+
+		// Allocate temp buffers, and the new particles start without stiffness
+		size_t numberOfParticles = particles->GetNumberOfParticles();
+		m_factors.Resize(numberOfParticles);
+		m_divergenceFactors.Resize(numberOfParticles);
+		m_stiffnesses.Resize(numberOfParticles);
+		m_densityStiffnesses.Resize(numberOfParticles, 0.0);
+		m_divergenceStiffnesses.Resize(numberOfParticles, 0.0);
+		m_tempPositions.Resize(numberOfParticles);
+		m_tempVelocities.Resize(numberOfParticles);
+
+		ComputeFactors();
+
+		// The divergence solver of the previous time step runs here, after the
+		// neighbor lists and densities of the advected particles are updated.
+		CorrectDivergence(timeStepInSeconds);
+	}
+
+	void DFSPHSolver3::ComputeFactors()
+	{
+		auto particles = GetSPHSystemData();
+		const size_t numberOfParticles = particles->GetNumberOfParticles();
+		const double mass = particles->GetMass();
+		const auto& neighborLists = particles->GetNeighborLists();
+		auto x = particles->GetPositions();
+
+		const SPHSpikyKernel3 kernel(particles->GetKernelRadius());
+
+		// Number of particles within the kernel radius in a full neighborhood
+		const double fullNumberOfNeighbors = 4.0 / 3.0 * PI_DOUBLE * Cubic(kernel.h / particles->GetTargetSpacing());
+		const double minNumberOfNeighbors = MIN_DIVERGENCE_NEIGHBOR_RATIO * fullNumberOfNeighbors;
+
+		m_gradientOffsets.Resize(numberOfParticles + 1);
+		m_gradientOffsets[0] = 0;
+		for (size_t i = 0; i < numberOfParticles; ++i)
+		{
+			m_gradientOffsets[i + 1] = m_gradientOffsets[i] + neighborLists[i].size();
+		}
+
+		m_gradients.Resize(m_gradientOffsets[numberOfParticles]);
+
+		// The positions do not change until the next time step, so the kernel
+		// gradients are evaluated once and reused by every solver iteration.
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			const auto& neighbors = neighborLists[i];
+			Vector3D* gradients = m_gradients.data() + m_gradientOffsets[i];
+
+			Vector3D sumOfGradients;
+			double sumOfSquaredGradients = 0.0;
+			size_t numberOfNeighbors = 0;
+
+			for (size_t n = 0; n < neighbors.size(); ++n)
+			{
+				const size_t j = neighbors[n];
+				const double dist = x[i].DistanceTo(x[j]);
+
+				gradients[n] = (dist > 0.0) ? mass * kernel.Gradient(dist, (x[j] - x[i]) / dist) : Vector3D();
+				numberOfNeighbors += (dist < kernel.h) ? 1 : 0;
+				sumOfGradients += gradients[n];
+				sumOfSquaredGradients += gradients[n].LengthSquared();
+			}
+
+			const double denominator = sumOfGradients.LengthSquared() + sumOfSquaredGradients;
+			m_factors[i] = (denominator > MIN_FACTOR_DENOMINATOR) ? 1.0 / denominator : 0.0;
+			m_divergenceFactors[i] = (numberOfNeighbors >= minNumberOfNeighbors) ? m_factors[i] : 0.0;
+		});
+	}
+
+	void DFSPHSolver3::CorrectDivergence(double timeStepInSeconds)
+	{
+		auto particles = GetSPHSystemData();
+		const size_t numberOfParticles = particles->GetNumberOfParticles();
+		const double targetDensity = particles->GetTargetDensity();
+		const double negativePressureScale = GetNegativePressureScale();
+
+		auto v = particles->GetVelocities();
+
+		// Only the compressed particles are warm-started, and the stiffness is
+		// halved so that a stale value is not applied at full strength.
+		if (m_isUsingWarmStart)
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				if (ComputeDensityChangeRate(i, v) > 0.0)
+				{
+					m_divergenceStiffnesses[i] *= WARM_START_SCALE;
+				}
+				else
+				{
+					m_divergenceStiffnesses[i] = 0.0;
+				}
+
+				m_stiffnesses[i] = m_divergenceStiffnesses[i] / timeStepInSeconds;
+			});
+
+			ApplyStiffnesses(timeStepInSeconds, m_stiffnesses.ConstAccessor(), v);
+		}
+		else
+		{
+			m_divergenceStiffnesses.Set(0.0);
+		}
+
+		Array1<double> errors(numberOfParticles, 0.0);
+		double averageErrorRatio = 0.0;
+		unsigned int numberOfIterations = 0;
+
+		while (numberOfIterations < m_maxNumberOfIterations)
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				double densityChangeRate = ComputeDensityChangeRate(i, v);
+				if (densityChangeRate < 0.0)
+				{
+					densityChangeRate *= negativePressureScale;
+				}
+
+				m_stiffnesses[i] = densityChangeRate / timeStepInSeconds * m_divergenceFactors[i];
+				m_divergenceStiffnesses[i] += densityChangeRate * m_divergenceFactors[i];
+				errors[i] = densityChangeRate;
+			});
+
+			ApplyStiffnesses(timeStepInSeconds, m_stiffnesses.ConstAccessor(), v);
+			++numberOfIterations;
+
+			double sumOfErrors = 0.0;
+			for (size_t i = 0; i < numberOfParticles; ++i)
+			{
+				sumOfErrors += errors[i];
+			}
+
+			averageErrorRatio = (numberOfParticles > 0)
+				? timeStepInSeconds * sumOfErrors / (numberOfParticles * targetDensity) : 0.0;
+
+			if (averageErrorRatio <= m_maxDivergenceErrorRatio)
+			{
+				break;
+			}
+		}
+
+		m_lastNumberOfDivergenceIterations = numberOfIterations;
+
+		CUBBYFLOW_INFO << "Number of divergence solver iterations: " << numberOfIterations;
+		CUBBYFLOW_INFO << "Average divergence error ratio: " << averageErrorRatio;
+	}
+
+	void DFSPHSolver3::CorrectDensityError(double timeStepInSeconds)
+	{
+		auto particles = GetSPHSystemData();
+		const size_t numberOfParticles = particles->GetNumberOfParticles();
+		const double targetDensity = particles->GetTargetDensity();
+		const double negativePressureScale = GetNegativePressureScale();
+		const double invTimeStepSquared = 1.0 / Square(timeStepInSeconds);
+
+		auto x = particles->GetPositions();
+		auto d = particles->GetDensities();
+		auto p = particles->GetPressures();
+
+		// The colliders stop the predicted motion before the density is
+		// predicted, so the particles next to them are not compressed later.
+		const auto resolveCollision = [&]()
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				m_tempPositions[i] = x[i] + timeStepInSeconds * m_tempVelocities[i];
+			});
+
+			ResolveCollision(m_tempPositions, m_tempVelocities);
+		};
+
+		resolveCollision();
+
+		if (m_isUsingWarmStart)
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				if (d[i] + timeStepInSeconds * ComputeDensityChangeRate(i, m_tempVelocities.ConstAccessor()) > targetDensity)
+				{
+					m_densityStiffnesses[i] *= WARM_START_SCALE;
+				}
+				else
+				{
+					m_densityStiffnesses[i] = 0.0;
+				}
+
+				m_stiffnesses[i] = m_densityStiffnesses[i] * invTimeStepSquared;
+			});
+
+			ApplyStiffnesses(timeStepInSeconds, m_stiffnesses.ConstAccessor(), m_tempVelocities.Accessor());
+		}
+		else
+		{
+			m_densityStiffnesses.Set(0.0);
+		}
+
+		Array1<double> errors(numberOfParticles, 0.0);
+		double averageErrorRatio = 0.0;
+		unsigned int numberOfIterations = 0;
+
+		// At least two iterations are taken, since the first one mostly
+		// measures the error left by the warm start.
+		while (numberOfIterations < m_maxNumberOfIterations)
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				const double predictedDensity = d[i] + timeStepInSeconds * ComputeDensityChangeRate(i, m_tempVelocities.ConstAccessor());
+
+				double densityError = predictedDensity - targetDensity;
+				if (densityError < 0.0)
+				{
+					densityError *= negativePressureScale;
+				}
+
+				m_stiffnesses[i] = densityError * invTimeStepSquared * m_factors[i];
+				m_densityStiffnesses[i] += densityError * m_factors[i];
+				errors[i] = densityError;
+			});
+
+			ApplyStiffnesses(timeStepInSeconds, m_stiffnesses.ConstAccessor(), m_tempVelocities.Accessor());
+			resolveCollision();
+			++numberOfIterations;
+
+			double sumOfErrors = 0.0;
+			for (size_t i = 0; i < numberOfParticles; ++i)
+			{
+				sumOfErrors += errors[i];
+			}
+
+			averageErrorRatio = (numberOfParticles > 0) ? sumOfErrors / (numberOfParticles * targetDensity) : 0.0;
+
+			if (averageErrorRatio <= m_maxDensityErrorRatio && numberOfIterations >= 2)
+			{
+				break;
+			}
+		}
+
+		// The stiffness is p_i / rho_i^2, which gives the pressure for output
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			p[i] = m_densityStiffnesses[i] * invTimeStepSquared * d[i] * d[i];
+		});
+
+		m_lastNumberOfDensityIterations = numberOfIterations;
+
+		CUBBYFLOW_INFO << "Number of density solver iterations: " << numberOfIterations;
+		CUBBYFLOW_INFO << "Average density error ratio: " << averageErrorRatio;
+
+		if (averageErrorRatio > m_maxDensityErrorRatio)
+		{
+			CUBBYFLOW_WARN << "Average density error ratio is greater than the threshold!";
+			CUBBYFLOW_WARN << "Ratio: " << averageErrorRatio
+				<< " Threshold: " << m_maxDensityErrorRatio;
+		}
+	}
+
+	double DFSPHSolver3::ComputeDensityChangeRate(size_t i, const ConstArrayAccessor1<Vector3D>& velocities) const
+	{
+		const auto& neighbors = GetSPHSystemData()->GetNeighborLists()[i];
+		const Vector3D* gradients = m_gradients.data() + m_gradientOffsets[i];
+
+		double densityChangeRate = 0.0;
+
+		for (size_t n = 0; n < neighbors.size(); ++n)
+		{
+			densityChangeRate += gradients[n].Dot(velocities[i] - velocities[neighbors[n]]);
+		}
+
+		return densityChangeRate;
+	}
+
+	void DFSPHSolver3::ApplyStiffnesses(double timeStepInSeconds, const ConstArrayAccessor1<double>& stiffnesses, ArrayAccessor1<Vector3D> velocities) const
+	{
+		auto particles = GetSPHSystemData();
+		const size_t numberOfParticles = particles->GetNumberOfParticles();
+		const auto& neighborLists = particles->GetNeighborLists();
+
+		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		{
+			const auto& neighbors = neighborLists[i];
+			const Vector3D* gradients = m_gradients.data() + m_gradientOffsets[i];
+
+			Vector3D sum;
+
+			for (size_t n = 0; n < neighbors.size(); ++n)
+			{
+				sum += (stiffnesses[i] + stiffnesses[neighbors[n]]) * gradients[n];
+			}
+
+			velocities[i] -= timeStepInSeconds * sum;
+		});
+	}
+
+	DFSPHSolver3::Builder DFSPHSolver3::GetBuilder()
+	{
+		return Builder();
+	}
+
+	DFSPHSolver3 DFSPHSolver3::Builder::Build() const
+	{
+		return DFSPHSolver3(m_targetDensity, m_targetSpacing, m_relativeKernelRadius);
+	}
+
+	DFSPHSolver3Ptr DFSPHSolver3::Builder::MakeShared() const
+	{
+		return std::shared_ptr<DFSPHSolver3>(
+			new DFSPHSolver3(m_targetDensity, m_targetSpacing, m_relativeKernelRadius),
+			[](DFSPHSolver3* obj)
+		{
+			delete obj;
+		});
+	}
+}
@@ -60,6 +60,7 @@ namespace CubbyFlow
 		const double delta = ComputeDelta(timeIntervalInSeconds);
 		const double targetDensity = particles->GetTargetDensity();
 		const double mass = particles->GetMass();
+		const bool isUsingAdaptiveKernel = particles->GetIsUsingAdaptiveKernel();
 
 		auto p = particles->GetPressures();
 		auto d = particles->GetDensities();
@@ -90,7 +91,8 @@ namespace CubbyFlow
 			// Predict velocity and position
 			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
 			{
-				m_tempVelocities[i] = v[i] + timeIntervalInSeconds / mass * (f[i] + m_pressureForces[i]);
+				const double mi = isUsingAdaptiveKernel ? particles->GetMassAt(i) : mass;
+				m_tempVelocities[i] = v[i] + timeIntervalInSeconds / mi * (f[i] + m_pressureForces[i]);
 				m_tempPositions[i] = x[i] + timeIntervalInSeconds * m_tempVelocities[i];
 			});
 
@@ -98,19 +100,8 @@ namespace CubbyFlow
 			ResolveCollision(m_tempPositions, m_tempVelocities);
 
 			// Compute pressure from density error
-			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			const auto updatePressure = [&](size_t i, double density)
 			{
-				double weightSum = 0.0;
-				const auto& neighbors = particles->GetNeighborLists()[i];
-
-				for (size_t j : neighbors)
-				{
-					double dist = m_tempPositions[j].DistanceTo(m_tempPositions[i]);
-					weightSum += kernel(dist);
-				}
-				weightSum += kernel(0);
-
-				double density = mass * weightSum;
 				double densityError = (density - targetDensity);
 				double pressure = delta * densityError;
 
@@ -123,7 +114,77 @@ namespace CubbyFlow
 				p[i] += pressure;
 				ds[i] = density;
 				m_densityErrors[i] = densityError;
-			});
+			};
+
+			if (IsCellTilingActive())
+			{
+				ForEachParticleTile(m_tempPositions.ConstAccessor(), [&](ParticleTile& tile)
+				{
+					for (size_t i : tile.particles)
+					{
+						tile.CollectNeighbors(i, m_tempPositions[i], kernel.h2);
+
+						const size_t numberOfNeighbors = tile.neighbors.size();
+						tile.kernelValues.resize(numberOfNeighbors);
+						kernel.BatchValuesFromSquared(tile.distancesSquared.data(), tile.kernelValues.data(), numberOfNeighbors);
+
+						double weightSum = kernel(0);
+						for (size_t n = 0; n < numberOfNeighbors; ++n)
+						{
+							weightSum += tile.kernelValues[n];
+						}
+
+						updatePressure(i, mass * weightSum);
+					}
+				});
+			}
+			else if (isUsingAdaptiveKernel)
+			{
+				// Same per-pair kernel and per-particle mass as
+				// SPHSystemData3::UpdateDensities.
+				ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+				{
+					const double hi = particles->GetSmoothingLengthAt(i);
+					double density = particles->GetMassAt(i) * SPHStdKernel3(hi)(0.0);
+
+					for (size_t j : particles->GetNeighborLists()[i])
+					{
+						const SPHStdKernel3 kernelIJ(0.5 * (hi + particles->GetSmoothingLengthAt(j)));
+						density += particles->GetMassAt(j) * kernelIJ(m_tempPositions[i].DistanceTo(m_tempPositions[j]));
+					}
+
+					updatePressure(i, density);
+				});
+			}
+			else
+			{
+				ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+				{
+					double weightSum = 0.0;
+					const auto& neighbors = particles->GetNeighborLists()[i];
+					double distancesSquared[SPH_KERNEL_BATCH_SIZE];
+					double values[SPH_KERNEL_BATCH_SIZE];
+
+					for (size_t begin = 0; begin < neighbors.size(); begin += SPH_KERNEL_BATCH_SIZE)
+					{
+						const size_t count = std::min(SPH_KERNEL_BATCH_SIZE, neighbors.size() - begin);
+						for (size_t c = 0; c < count; ++c)
+						{
+							distancesSquared[c] = m_tempPositions[neighbors[begin + c]].DistanceSquaredTo(m_tempPositions[i]);
+						}
+
+						kernel.BatchValuesFromSquared(distancesSquared, values, count);
+						for (size_t c = 0; c < count; ++c)
+						{
+							weightSum += values[c];
+						}
+					}
+
+					weightSum += kernel(0);
+
+					updatePressure(i, mass * weightSum);
+				});
+			}
 
 			// Compute pressure gradient force
 			m_pressureForces.Set(Vector3D());
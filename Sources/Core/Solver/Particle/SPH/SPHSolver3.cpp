@@ -99,6 +99,26 @@ namespace CubbyFlow
 		m_timeStepLimitScale = std::max(newScale, 0.0);
 	}
 
+	double SPHSolver3::GetNeighborListSkin() const
+	{
+		return m_neighborListSkin;
+	}
+
+	void SPHSolver3::SetNeighborListSkin(double newSkin)
+	{
+		m_neighborListSkin = std::max(newSkin, 0.0);
+	}
+
+	bool SPHSolver3::GetIsUsingCellTiling() const
+	{
+		return m_isUsingCellTiling;
+	}
+
+	void SPHSolver3::SetIsUsingCellTiling(bool isUsing)
+	{
+		m_isUsingCellTiling = isUsing;
+	}
+
 	SPHSystemData3Ptr SPHSolver3::GetSPHSystemData() const
 	{
 		return std::dynamic_pointer_cast<SPHSystemData3>(GetParticleSystemData());
@@ -110,8 +130,21 @@ namespace CubbyFlow
 		size_t numberOfParticles = particles->GetNumberOfParticles();
 		auto f = particles->GetForces();
 
-		const double kernelRadius = particles->GetKernelRadius();
-		const double mass = particles->GetMass();
+		double kernelRadius = particles->GetKernelRadius();
+		double mass = particles->GetMass();
+
+		// The smallest particles limit the time step.
+		if (particles->GetIsUsingAdaptiveKernel())
+		{
+			for (size_t i = 0; i < numberOfParticles; ++i)
+			{
+				if (particles->GetSmoothingLengthAt(i) < kernelRadius)
+				{
+					kernelRadius = particles->GetSmoothingLengthAt(i);
+					mass = particles->GetMassAt(i);
+				}
+			}
+		}
 
 		double maxForceMagnitude = 0.0;
 
@@ -138,12 +171,8 @@ namespace CubbyFlow
 	{
 		UNUSED_VARIABLE(timeStepInSeconds);
 
-		auto particles = GetSPHSystemData();
-
 		Timer timer;
-		particles->BuildNeighborSearcher();
-		particles->BuildNeighborLists();
-		particles->UpdateDensities();
+		UpdateNeighborListsAndDensities();
 
 		CUBBYFLOW_INFO << "Building neighbor lists and updating densities took "
 			<< timer.DurationInSeconds()
@@ -219,17 +248,99 @@ namespace CubbyFlow
 		const double massSquared = Square(particles->GetMass());
 		const SPHSpikyKernel3 kernel(particles->GetKernelRadius());
 
+		if (IsCellTilingActive())
+		{
+			ForEachParticleTile(positions, [&](ParticleTile& tile)
+			{
+				tile.candidateValues.resize(tile.candidates.size());
+				for (size_t c = 0; c < tile.candidates.size(); ++c)
+				{
+					const size_t j = tile.candidates[c];
+					tile.candidateValues[c] = pressures[j] / (densities[j] * densities[j]);
+				}
+
+				for (size_t i : tile.particles)
+				{
+					tile.CollectNeighbors(i, positions[i], kernel.h2);
+
+					const size_t numberOfNeighbors = tile.neighbors.size();
+					tile.distances.resize(numberOfNeighbors);
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						tile.distances[n] = std::sqrt(tile.distancesSquared[n]);
+					}
+
+					tile.kernelValues.resize(numberOfNeighbors);
+					kernel.BatchFirstDerivatives(tile.distances.data(), tile.kernelValues.data(), numberOfNeighbors);
+
+					const double pressureTerm = pressures[i] / (densities[i] * densities[i]);
+					Vector3D force;
+
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						const double dist = tile.distances[n];
+						if (dist > 0.0)
+						{
+							const size_t c = tile.neighbors[n];
+							Vector3D dir = (tile.candidatePositions[c] - positions[i]) / dist;
+							force -= massSquared * (pressureTerm + tile.candidateValues[c]) * (-tile.kernelValues[n] * dir);
+						}
+					}
+
+					pressureForces[i] += force;
+				}
+			});
+			return;
+		}
+
+		if (particles->GetIsUsingAdaptiveKernel())
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				const double hi = particles->GetSmoothingLengthAt(i);
+				const double mi = particles->GetMassAt(i);
+
+				const auto& neighbors = particles->GetNeighborLists()[i];
+				for (size_t j : neighbors)
+				{
+					double dist = positions[i].DistanceTo(positions[j]);
+					if (dist > 0.0)
+					{
+						const SPHSpikyKernel3 kernelIJ(0.5 * (hi + particles->GetSmoothingLengthAt(j)));
+						Vector3D dir = (positions[j] - positions[i]) / dist;
+						pressureForces[i] -= mi * particles->GetMassAt(j) * (pressures[i] / (densities[i] * densities[i])
+							+ pressures[j] / (densities[j] * densities[j])) * kernelIJ.Gradient(dist, dir);
+					}
+				}
+			});
+			return;
+		}
+
 		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
 		{
 			const auto& neighbors = particles->GetNeighborLists()[i];
-			for (size_t j : neighbors)
+			double distances[SPH_KERNEL_BATCH_SIZE];
+			double derivatives[SPH_KERNEL_BATCH_SIZE];
+
+			for (size_t begin = 0; begin < neighbors.size(); begin += SPH_KERNEL_BATCH_SIZE)
 			{
-				double dist = positions[i].DistanceTo(positions[j]);
-				if (dist > 0.0)
+				const size_t count = std::min(SPH_KERNEL_BATCH_SIZE, neighbors.size() - begin);
+				for (size_t c = 0; c < count; ++c)
 				{
-					Vector3D dir = (positions[j] - positions[i]) / dist;
-					pressureForces[i] -= massSquared * (pressures[i] / (densities[i] * densities[i])
-						+ pressures[j] / (densities[j] * densities[j])) * kernel.Gradient(dist, dir);
+					distances[c] = positions[i].DistanceTo(positions[neighbors[begin + c]]);
+				}
+
+				kernel.BatchFirstDerivatives(distances, derivatives, count);
+
+				for (size_t c = 0; c < count; ++c)
+				{
+					const size_t j = neighbors[begin + c];
+					if (distances[c] > 0.0)
+					{
+						Vector3D dir = (positions[j] - positions[i]) / distances[c];
+						pressureForces[i] -= massSquared * (pressures[i] / (densities[i] * densities[i])
+							+ pressures[j] / (densities[j] * densities[j])) * (-derivatives[c] * dir);
+					}
 				}
 			}
 		});
@@ -247,14 +358,85 @@ namespace CubbyFlow
 		const double massSquared = Square(particles->GetMass());
 		const SPHSpikyKernel3 kernel(particles->GetKernelRadius());
 
+		if (IsCellTilingActive())
+		{
+			ForEachParticleTile(x, [&](ParticleTile& tile)
+			{
+				tile.candidateValues.resize(tile.candidates.size());
+				tile.candidateVectors.resize(tile.candidates.size());
+				for (size_t c = 0; c < tile.candidates.size(); ++c)
+				{
+					tile.candidateValues[c] = d[tile.candidates[c]];
+					tile.candidateVectors[c] = v[tile.candidates[c]];
+				}
+
+				for (size_t i : tile.particles)
+				{
+					tile.CollectNeighbors(i, x[i], kernel.h2);
+
+					const size_t numberOfNeighbors = tile.neighbors.size();
+					tile.distances.resize(numberOfNeighbors);
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						tile.distances[n] = std::sqrt(tile.distancesSquared[n]);
+					}
+
+					tile.kernelValues.resize(numberOfNeighbors);
+					kernel.BatchSecondDerivatives(tile.distances.data(), tile.kernelValues.data(), numberOfNeighbors);
+
+					Vector3D force;
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						const size_t c = tile.neighbors[n];
+						force += GetViscosityCoefficient() * massSquared * (tile.candidateVectors[c] - v[i]) / tile.candidateValues[c] * tile.kernelValues[n];
+					}
+
+					f[i] += force;
+				}
+			});
+			return;
+		}
+
+		if (particles->GetIsUsingAdaptiveKernel())
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				const double hi = particles->GetSmoothingLengthAt(i);
+				const double mi = particles->GetMassAt(i);
+
+				const auto& neighbors = particles->GetNeighborLists()[i];
+				for (size_t j : neighbors)
+				{
+					double dist = x[i].DistanceTo(x[j]);
+					const SPHSpikyKernel3 kernelIJ(0.5 * (hi + particles->GetSmoothingLengthAt(j)));
+
+					f[i] += GetViscosityCoefficient() * mi * particles->GetMassAt(j) * (v[j] - v[i]) / d[j] * kernelIJ.SecondDerivative(dist);
+				}
+			});
+			return;
+		}
+
 		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
 		{
 			const auto& neighbors = particles->GetNeighborLists()[i];
-			for (size_t j : neighbors)
+			double distances[SPH_KERNEL_BATCH_SIZE];
+			double derivatives[SPH_KERNEL_BATCH_SIZE];
+
+			for (size_t begin = 0; begin < neighbors.size(); begin += SPH_KERNEL_BATCH_SIZE)
 			{
-				double dist = x[i].DistanceTo(x[j]);
+				const size_t count = std::min(SPH_KERNEL_BATCH_SIZE, neighbors.size() - begin);
+				for (size_t c = 0; c < count; ++c)
+				{
+					distances[c] = x[i].DistanceTo(x[neighbors[begin + c]]);
+				}
+
+				kernel.BatchSecondDerivatives(distances, derivatives, count);
 
-				f[i] += GetViscosityCoefficient() * massSquared * (v[j] - v[i]) / d[j] * kernel.SecondDerivative(dist);
+				for (size_t c = 0; c < count; ++c)
+				{
+					const size_t j = neighbors[begin + c];
+					f[i] += GetViscosityCoefficient() * massSquared * (v[j] - v[i]) / d[j] * derivatives[c];
+				}
 			}
 		});
 	}
@@ -269,42 +451,265 @@ namespace CubbyFlow
 
 		const double mass = particles->GetMass();
 		const SPHSpikyKernel3 kernel(particles->GetKernelRadius());
+		const bool isUsingAdaptiveKernel = particles->GetIsUsingAdaptiveKernel();
 
 		Array1<Vector3D> smoothedVelocities(numberOfParticles);
 
+		if (IsCellTilingActive())
+		{
+			ForEachParticleTile(x, [&](ParticleTile& tile)
+			{
+				tile.candidateValues.resize(tile.candidates.size());
+				tile.candidateVectors.resize(tile.candidates.size());
+				for (size_t c = 0; c < tile.candidates.size(); ++c)
+				{
+					tile.candidateValues[c] = mass / d[tile.candidates[c]];
+					tile.candidateVectors[c] = v[tile.candidates[c]];
+				}
+
+				for (size_t i : tile.particles)
+				{
+					tile.CollectNeighbors(i, x[i], kernel.h2);
+
+					const size_t numberOfNeighbors = tile.neighbors.size();
+					tile.distances.resize(numberOfNeighbors);
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						tile.distances[n] = std::sqrt(tile.distancesSquared[n]);
+					}
+
+					tile.kernelValues.resize(numberOfNeighbors);
+					kernel.BatchValues(tile.distances.data(), tile.kernelValues.data(), numberOfNeighbors);
+
+					double weightSum = mass / d[i];
+					Vector3D smoothedVelocity = weightSum * v[i];
+
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						const size_t c = tile.neighbors[n];
+						const double wj = tile.candidateValues[c] * tile.kernelValues[n];
+						weightSum += wj;
+						smoothedVelocity += wj * tile.candidateVectors[c];
+					}
+
+					if (weightSum > 0.0)
+					{
+						smoothedVelocity /= weightSum;
+					}
+
+					smoothedVelocities[i] = smoothedVelocity;
+				}
+			});
+		}
+		else
+		{
+			ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+			{
+				double weightSum = 0.0;
+				Vector3D smoothedVelocity;
+
+				const auto& neighbors = particles->GetNeighborLists()[i];
+				for (size_t j : neighbors)
+				{
+					double dist = x[i].DistanceTo(x[j]);
+					double wj;
+
+					if (isUsingAdaptiveKernel)
+					{
+						const SPHSpikyKernel3 kernelIJ(0.5 * (particles->GetSmoothingLengthAt(i) + particles->GetSmoothingLengthAt(j)));
+						wj = particles->GetMassAt(j) / d[j] * kernelIJ(dist);
+					}
+					else
+					{
+						wj = mass / d[j] * kernel(dist);
+					}
+
+					weightSum += wj;
+					smoothedVelocity += wj * v[j];
+				}
+
+				double wi = (isUsingAdaptiveKernel ? particles->GetMassAt(i) : mass) / d[i];
+				weightSum += wi;
+				smoothedVelocity += wi * v[i];
+
+				if (weightSum > 0.0)
+				{
+					smoothedVelocity /= weightSum;
+				}
+
+				smoothedVelocities[i] = smoothedVelocity;
+			});
+		}
+
+		double factor = timeStepInSeconds * m_pseudoViscosityCoefficient;
+		factor = std::clamp(factor, 0.0, 1.0);
+
 		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
 		{
-			double weightSum = 0.0;
-			Vector3D smoothedVelocity;
+			v[i] = Lerp(v[i], smoothedVelocities[i], factor);
+		});
+	}
 
-			const auto& neighbors = particles->GetNeighborLists()[i];
-			for (size_t j : neighbors)
+	void SPHSolver3::UpdateNeighborListsAndDensities()
+	{
+		auto particles = GetSPHSystemData();
+
+		if (IsCellTilingActive())
+		{
+			auto x = particles->GetPositions();
+			auto d = particles->GetDensities();
+			const double mass = particles->GetMass();
+			const SPHStdKernel3 kernel(particles->GetKernelRadius());
+
+			// The grid is only recreated when the kernel radius changes, so its
+			// buffers are reused from step to step.
+			if (m_tileGrid == nullptr || m_tileGrid->GetGridSpacing() != particles->GetKernelRadius())
 			{
-				double dist = x[i].DistanceTo(x[j]);
-				double wj = mass / d[j] * kernel(dist);
-				weightSum += wj;
-				smoothedVelocity += wj * v[j];
+				m_tileGrid = std::make_shared<PointCompactHashGridSearcher3>(particles->GetKernelRadius());
 			}
+			m_tileGrid->Build(x);
 
-			double wi = mass / d[i];
-			weightSum += wi;
-			smoothedVelocity += wi * v[i];
+			ForEachParticleTile(x, [&](ParticleTile& tile)
+			{
+				for (size_t i : tile.particles)
+				{
+					tile.CollectNeighbors(i, x[i], kernel.h2);
+
+					const size_t numberOfNeighbors = tile.neighbors.size();
+					tile.kernelValues.resize(numberOfNeighbors);
+					kernel.BatchValuesFromSquared(tile.distancesSquared.data(), tile.kernelValues.data(), numberOfNeighbors);
+
+					double sum = kernel(0.0);
+					for (size_t n = 0; n < numberOfNeighbors; ++n)
+					{
+						sum += tile.kernelValues[n];
+					}
+
+					d[i] = mass * sum;
+				}
+			});
+			return;
+		}
+
+		// The skin assumes a single kernel radius, so adaptive kernels always
+		// rebuild the hierarchical grid and the symmetric lists.
+		if (m_neighborListSkin <= 0.0 || particles->GetIsUsingAdaptiveKernel())
+		{
+			m_neighborListRadius = 0.0;
+
+			particles->BuildNeighborSearcher();
+			particles->BuildNeighborLists();
+			particles->UpdateDensities();
+			return;
+		}
 
-			if (weightSum > 0.0)
+		if (IsNeighborListOutdated())
+		{
+			m_neighborListRadius = particles->GetKernelRadius() + m_neighborListSkin;
+
+			particles->BuildNeighborSearcher(m_neighborListRadius);
+			particles->BuildNeighborLists(m_neighborListRadius);
+
+			auto x = particles->GetPositions();
+			m_neighborListPositions.Resize(x.size());
+			ParallelFor(ZERO_SIZE, x.size(), [&](size_t i)
 			{
-				smoothedVelocity /= weightSum;
+				m_neighborListPositions[i] = x[i];
+			});
+
+			CUBBYFLOW_INFO << "Rebuilt neighbor lists with skin " << m_neighborListSkin;
+		}
+
+		particles->UpdateDensitiesFromNeighborLists();
+	}
+
+	void SPHSolver3::ParticleTile::CollectNeighbors(size_t index, const Vector3D& origin, double radiusSquared)
+	{
+		neighbors.clear();
+		distancesSquared.clear();
+
+		for (size_t c = 0; c < candidates.size(); ++c)
+		{
+			const double distanceSquared = candidatePositions[c].DistanceSquaredTo(origin);
+			if (distanceSquared <= radiusSquared && candidates[c] != index)
+			{
+				neighbors.push_back(c);
+				distancesSquared.push_back(distanceSquared);
 			}
+		}
+	}
+
+	bool SPHSolver3::IsCellTilingActive() const
+	{
+		return m_isUsingCellTiling && !GetSPHSystemData()->GetIsUsingAdaptiveKernel();
+	}
+
+	void SPHSolver3::ForEachParticleTile(const ConstArrayAccessor1<Vector3D>& positions, const std::function<void(ParticleTile&)>& func) const
+	{
+		const PointCompactHashGridSearcher3& grid = *m_tileGrid;
+		const std::vector<size_t>& sortedIndices = grid.SortedIndices();
+
+		// Each range of cells reuses one tile, so the buffers only grow until
+		// they fit the most crowded cell.
+		ParallelRangeFor(ZERO_SIZE, grid.GetNumberOfOccupiedBuckets(), [&](size_t begin, size_t end)
+		{
+			ParticleTile tile;
+			std::vector<std::pair<size_t, size_t>> ranges;
+
+			for (size_t b = begin; b < end; ++b)
+			{
+				const auto range = grid.GetBucketRange(b);
+				tile.particles.assign(sortedIndices.begin() + range.first, sortedIndices.begin() + range.second);
+
+				grid.GetNearbyBucketRanges(b, 1, &ranges);
+
+				tile.candidates.clear();
+				for (const auto& nearbyRange : ranges)
+				{
+					tile.candidates.insert(tile.candidates.end(),
+						sortedIndices.begin() + nearbyRange.first, sortedIndices.begin() + nearbyRange.second);
+				}
+
+				tile.candidatePositions.resize(tile.candidates.size());
+				for (size_t c = 0; c < tile.candidates.size(); ++c)
+				{
+					tile.candidatePositions[c] = positions[tile.candidates[c]];
+				}
 
-			smoothedVelocities[i] = smoothedVelocity;
+				func(tile);
+			}
 		});
+	}
 
-		double factor = timeStepInSeconds * m_pseudoViscosityCoefficient;
-		factor = std::clamp(factor, 0.0, 1.0);
+	bool SPHSolver3::IsNeighborListOutdated() const
+	{
+		auto particles = GetSPHSystemData();
+		auto x = particles->GetPositions();
 
-		ParallelFor(ZERO_SIZE, numberOfParticles, [&](size_t i)
+		if (m_neighborListRadius != particles->GetKernelRadius() + m_neighborListSkin ||
+			m_neighborListPositions.size() != x.size() ||
+			particles->GetNeighborLists().size() != x.size())
 		{
-			v[i] = Lerp(v[i], smoothedVelocities[i], factor);
+			return true;
+		}
+
+		// A pair can only come within the kernel radius once the sum of the
+		// two displacements exceeds the skin.
+		const double maxDisplacementSquared = ParallelReduce(ZERO_SIZE, x.size(), 0.0,
+			[&](size_t begin, size_t end, double result)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				result = std::max(result, x[i].DistanceSquaredTo(m_neighborListPositions[i]));
+			}
+
+			return result;
+		}, [](double a, double b)
+		{
+			return std::max(a, b);
 		});
+
+		return 4.0 * maxDisplacementSquared > Square(m_neighborListSkin);
 	}
 
 	SPHSolver3::Builder SPHSolver3::GetBuilder()
@@ -17,6 +17,7 @@
 #include <Core/Grid/VertexCenteredScalarGrid3.h>
 #include <Core/Grid/VertexCenteredVectorGrid2.h>
 #include <Core/Grid/VertexCenteredVectorGrid3.h>
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
 #include <Core/Searcher/PointHashGridSearcher2.h>
 #include <Core/Searcher/PointHashGridSearcher3.h>
 #include <Core/Searcher/PointKdTreeSearcher2.h>
@@ -90,6 +91,8 @@ namespace CubbyFlow
 
 			REGISTER_POINT_NEIGHBOR_SEARCHER2_BUILDER(PointKdTreeSearcher2)
 			REGISTER_POINT_NEIGHBOR_SEARCHER3_BUILDER(PointKdTreeSearcher3)
+
+			REGISTER_POINT_NEIGHBOR_SEARCHER3_BUILDER(PointCompactHashGridSearcher3)
 		}
 	};
 
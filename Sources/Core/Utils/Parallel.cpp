@@ -16,10 +16,38 @@
 #include <omp.h>
 #endif
 
+#if defined(__linux__) && (defined(CUBBYFLOW_TASKING_CPP11THREAD) || defined(CUBBYFLOW_TASKING_OPENMP))
+#define CUBBYFLOW_THREAD_AFFINITY
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <memory>
 #include <thread>
+#include <vector>
 
 static unsigned int MAX_NUMBER_OF_THREADS = std::thread::hardware_concurrency();
+static bool IS_DETERMINISTIC = false;
+static bool IS_USING_THREAD_AFFINITY = false;
+
+#if defined(CUBBYFLOW_THREAD_AFFINITY)
+// CPUs the process was allowed to run on before any thread was pinned.
+static cpu_set_t ALLOWED_CPU_SET;
+static std::vector<int> ALLOWED_CPUS;
+
+static void PinCurrentThread(unsigned int slot)
+{
+	if (ALLOWED_CPUS.empty())
+	{
+		return;
+	}
+
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(ALLOWED_CPUS[slot % ALLOWED_CPUS.size()], &cpuSet);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+}
+#endif
 
 namespace CubbyFlow
 {
@@ -47,4 +75,77 @@ namespace CubbyFlow
 	{
 		return MAX_NUMBER_OF_THREADS;
 	}
+
+	void SetIsDeterministic(bool isDeterministic)
+	{
+		IS_DETERMINISTIC = isDeterministic;
+	}
+
+	bool GetIsDeterministic()
+	{
+		return IS_DETERMINISTIC;
+	}
+
+	void SetIsUsingThreadAffinity(bool isUsing)
+	{
+#if defined(CUBBYFLOW_THREAD_AFFINITY)
+		if (isUsing && !IS_USING_THREAD_AFFINITY)
+		{
+			CPU_ZERO(&ALLOWED_CPU_SET);
+			ALLOWED_CPUS.clear();
+
+			if (sched_getaffinity(0, sizeof(cpu_set_t), &ALLOWED_CPU_SET) == 0)
+			{
+				for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+				{
+					if (CPU_ISSET(cpu, &ALLOWED_CPU_SET))
+					{
+						ALLOWED_CPUS.push_back(cpu);
+					}
+				}
+			}
+		}
+
+#if defined(CUBBYFLOW_TASKING_OPENMP)
+		// OpenMP keeps its threads alive, so they are pinned once here.
+		if (isUsing != IS_USING_THREAD_AFFINITY && !ALLOWED_CPUS.empty())
+		{
+#pragma omp parallel
+			{
+				if (isUsing)
+				{
+					PinCurrentThread(static_cast<unsigned int>(omp_get_thread_num()));
+				}
+				else
+				{
+					pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &ALLOWED_CPU_SET);
+				}
+			}
+		}
+#endif
+#endif
+		IS_USING_THREAD_AFFINITY = isUsing;
+	}
+
+	bool GetIsUsingThreadAffinity()
+	{
+		return IS_USING_THREAD_AFFINITY;
+	}
+
+	namespace Internal
+	{
+		void BindCurrentThread(unsigned int slot)
+		{
+#if defined(CUBBYFLOW_THREAD_AFFINITY) && defined(CUBBYFLOW_TASKING_CPP11THREAD)
+			// The C++11 thread tasking system starts fresh threads for every
+			// loop, so each of them is pinned before it runs its slice.
+			if (IS_USING_THREAD_AFFINITY)
+			{
+				PinCurrentThread(slot);
+			}
+#else
+			(void)slot;
+#endif
+		}
+	}
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "MemPerfTestsUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <Core/Animation/Frame.h>
+#include <Core/Array/ArrayAllocator.h>
+#include <Core/Emitter/VolumeParticleEmitter3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/PointGenerator/GridPointGenerator3.h>
+#include <Core/Solver/Hybrid/FLIP/FLIPSolver3.h>
+
+#include <iostream>
+
+using namespace CubbyFlow;
+
+namespace
+{
+    void RunSolverSteps(bool isPooling)
+    {
+        const size_t n = 100;
+
+        ArrayMemoryPool::SetIsPooling(isPooling);
+
+        auto solver = FLIPSolver3::Builder()
+            .WithResolution({ n, n, n })
+            .MakeShared();
+
+        // Dam-breaking column of a quarter of the width and three quarters
+        // of the height of the domain.
+        const auto grids = solver->GetGridSystemData();
+        const double dx = grids->GetGridSpacing().x;
+        const BoundingBox3D domain = grids->GetBoundingBox();
+
+        auto column = Box3::Builder()
+            .WithLowerCorner(domain.lowerCorner)
+            .WithUpperCorner(domain.lowerCorner + Vector3D(0.25 * domain.GetWidth(), 0.75 * domain.GetHeight(), domain.GetDepth()))
+            .MakeShared();
+
+        auto emitter = VolumeParticleEmitter3::Builder()
+            .WithSurface(column)
+            .WithSpacing(0.5 * dx)
+            .WithMaxRegion(domain)
+            .WithIsOneShot(true)
+            .MakeShared();
+        emitter->SetPointGenerator(std::make_shared<GridPointGenerator3>());
+        solver->SetParticleEmitter(emitter);
+
+        const size_t mem0 = GetCurrentRSS();
+        const size_t faults0 = GetMinorPageFaults();
+
+        for (Frame frame(0, 0.01); frame.index < 5; ++frame)
+        {
+            solver->Update(frame);
+        }
+
+        const size_t mem1 = GetCurrentRSS();
+        const size_t faults1 = GetMinorPageFaults();
+
+        const auto msg = MakeReadableByteSize(mem1 > mem0 ? mem1 - mem0 : 0);
+
+        std::cout << "Pooling: " << (isPooling ? "on" : "off") << '\n';
+        PrintMemReport(msg.first, msg.second);
+        std::cout << "Minor page faults: " << faults1 - faults0 << '\n';
+    }
+}
+
+TEST(ArrayAllocator, SolverSteps)
+{
+    const bool oldIsPooling = ArrayMemoryPool::GetIsPooling();
+
+    RunSolverSteps(false);
+    RunSolverSteps(true);
+
+    ArrayMemoryPool::SetIsPooling(oldIsPooling);
+}
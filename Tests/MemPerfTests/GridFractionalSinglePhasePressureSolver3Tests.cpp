@@ -2,16 +2,21 @@
 
 #include "gtest/gtest.h"
 
+#include <Core/Array/Array3.h>
 #include <Core/Grid/FaceCenteredGrid3.h>
 #include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/Math/FixedPoint.h>
 #include <Core/Solver/Grid/GridFractionalSinglePhasePressureSolver3.h>
 
 using namespace CubbyFlow;
 
 namespace
 {
-    void RunExperiment(size_t n, double height, bool compressed)
+    // Returns the RSS taken by the grids and the solver right after the solve.
+    size_t RunExperiment(size_t n, double height, bool compressed)
     {
+        const size_t mem0 = GetCurrentRSS();
+
         FaceCenteredGrid3 vel(n, n, n);
         CellCenteredScalarGrid3 fluidSDF(n, n, n);
 
@@ -45,6 +50,30 @@ namespace
             ConstantScalarField3(std::numeric_limits<double>::max()),
             ConstantVectorField3({ 0, 0, 0 }),
             fluidSDF, compressed);
+
+        return GetCurrentRSS() - mem0;
+    }
+
+    // Allocates and fills the u, v and w face weights of an n^3 grid in the
+    // given storage type, and returns the RSS they take.
+    template <typename T>
+    size_t RunWeightExperiment(size_t n)
+    {
+        const size_t mem0 = GetCurrentRSS();
+
+        Array3<T> uWeights(Size3(n + 1, n, n));
+        Array3<T> vWeights(Size3(n, n + 1, n));
+        Array3<T> wWeights(Size3(n, n, n + 1));
+
+        for (Array3<T>* weights : { &uWeights, &vWeights, &wWeights })
+        {
+            weights->ParallelForEachIndex([&](size_t i, size_t j, size_t k)
+            {
+                (*weights)(i, j, k) = static_cast<float>(j < n / 2 ? 1.0 : 0.5);
+            });
+        }
+
+        return GetCurrentRSS() - mem0;
     }
 }
 
@@ -98,4 +127,23 @@ TEST(GridFractionalSinglePhasePressureSolver3, FreeSurfaceCompressed)
     const auto msg = MakeReadableByteSize(mem1 - mem0);
 
     PrintMemReport(msg.first, msg.second);
+}
+
+TEST(GridFractionalSinglePhasePressureSolver3, WeightStorage)
+{
+    // The weights were stored as float before FixedPoint16, so the saving is
+    // measured against float, and put in proportion with a whole solve.
+    const size_t solveBytes = RunExperiment(128, 1.0, false);
+    const size_t fixedPointBytes = RunWeightExperiment<FixedPoint16>(128);
+    const size_t floatBytes = RunWeightExperiment<float>(128);
+
+    const auto solveMsg = MakeReadableByteSize(solveBytes);
+    const auto fixedPointMsg = MakeReadableByteSize(fixedPointBytes);
+    const auto floatMsg = MakeReadableByteSize(floatBytes);
+
+    PrintMemReport(solveMsg.first, solveMsg.second + " (solve with FixedPoint16 weights)");
+    PrintMemReport(fixedPointMsg.first, fixedPointMsg.second + " (FixedPoint16 weights)");
+    PrintMemReport(floatMsg.first, floatMsg.second + " (float weights)");
+
+    EXPECT_LT(fixedPointBytes, floatBytes);
 }
\ No newline at end of file
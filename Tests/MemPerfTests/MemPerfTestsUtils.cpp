@@ -1,5 +1,9 @@
 #include "MemPerfTestsUtils.h"
 
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
 #include <iostream>
 #include <string>
 #include <utility>
@@ -9,6 +13,17 @@ void PrintMemReport(double memUsage, const std::string& memMessage)
     std::cout << "Mem usage: " << memUsage << ' ' << memMessage << '\n';
 }
 
+size_t GetMinorPageFaults()
+{
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_minflt);
+#endif
+}
+
 std::pair<double, std::string> MakeReadableByteSize(size_t bytes)
 {
     double s = static_cast<double>(bytes);
@@ -9,6 +9,8 @@ void PrintMemReport(double memUsage, const std::string& memMessage);
 
 size_t GetCurrentRSS();
 
+size_t GetMinorPageFaults();
+
 std::pair<double, std::string> MakeReadableByteSize(size_t bytes);
 
 #endif
\ No newline at end of file
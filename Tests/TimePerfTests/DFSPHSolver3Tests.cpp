@@ -0,0 +1,141 @@
+#include "benchmark/benchmark.h"
+
+#include <Core/Collider/RigidBodyCollider3.h>
+#include <Core/Emitter/VolumeParticleEmitter3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/Solver/Particle/DFSPH/DFSPHSolver3.h>
+#include <Core/Solver/Particle/PCISPH/PCISPHSolver3.h>
+
+#include <memory>
+
+using CubbyFlow::BoundingBox3D;
+using CubbyFlow::Box3;
+using CubbyFlow::Frame;
+using CubbyFlow::RigidBodyCollider3;
+using CubbyFlow::SPHSolver3;
+using CubbyFlow::Vector3D;
+
+// Dam-breaking scene shared by the incompressible SPH solvers. Each
+// iteration simulates the same 0.25 seconds, so the measured time is a
+// quarter of the wall-time per simulated second. The argument is the max
+// density error ratio in thousandths, set identically on both solvers since
+// their defaults differ. The max density ratio over the run is reported, so
+// both solvers can be compared at the compressibility they actually reached.
+class DFSPHSolver3 : public ::benchmark::Fixture
+{
+protected:
+	static constexpr int NUMBER_OF_FRAMES = 15;
+
+	template <typename Solver>
+	static void SetUpScene(Solver* solver, double targetSpacing, double maxDensityErrorRatio)
+	{
+		solver->SetMaxDensityErrorRatio(maxDensityErrorRatio);
+
+		auto particles = solver->GetSPHSystemData();
+		particles->SetTargetDensity(1000.0);
+		particles->SetTargetSpacing(targetSpacing);
+
+		auto box = Box3::Builder()
+			.WithLowerCorner({ 0, 0, 0 })
+			.WithUpperCorner({ 0.4, 0.6, 0.4 })
+			.MakeShared();
+
+		BoundingBox3D sourceBound(Vector3D(), Vector3D(1, 1, 1));
+		sourceBound.Expand(-targetSpacing);
+
+		auto emitter = CubbyFlow::VolumeParticleEmitter3::Builder()
+			.WithSurface(box)
+			.WithMaxRegion(sourceBound)
+			.WithSpacing(targetSpacing)
+			.WithJitter(0.0)
+			.MakeShared();
+		solver->SetEmitter(emitter);
+
+		auto domain = Box3::Builder()
+			.WithLowerCorner({ 0, 0, 0 })
+			.WithUpperCorner({ 1, 1, 1 })
+			.WithIsNormalFlipped(true)
+			.MakeShared();
+		solver->SetCollider(RigidBodyCollider3::Builder().WithSurface(domain).MakeShared());
+	}
+
+	static void Simulate(SPHSolver3* solver, benchmark::State& state)
+	{
+		double maxDensityRatio = 0.0;
+
+		for (Frame frame(0, 1.0 / 60.0); frame.index < NUMBER_OF_FRAMES; ++frame)
+		{
+			solver->Update(frame);
+
+			auto particles = solver->GetSPHSystemData();
+			auto densities = particles->GetDensities();
+			for (size_t i = 0; i < densities.size(); ++i)
+			{
+				maxDensityRatio = std::max(maxDensityRatio, densities[i] / particles->GetTargetDensity());
+			}
+		}
+
+		state.counters["MaxDensityRatio"] = maxDensityRatio;
+		state.counters["Particles"] = static_cast<double>(solver->GetSPHSystemData()->GetNumberOfParticles());
+	}
+};
+
+BENCHMARK_DEFINE_F(DFSPHSolver3, DamBreaking)(benchmark::State& state)
+{
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		CubbyFlow::DFSPHSolver3 solver;
+		SetUpScene(&solver, 0.04, state.range(0) / 1000.0);
+		state.ResumeTiming();
+
+		Simulate(&solver, state);
+	}
+}
+
+BENCHMARK_REGISTER_F(DFSPHSolver3, DamBreaking)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Arg(1)
+->Arg(10);
+
+BENCHMARK_DEFINE_F(DFSPHSolver3, PCISPHDamBreaking)(benchmark::State& state)
+{
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		CubbyFlow::PCISPHSolver3 solver;
+		SetUpScene(&solver, 0.04, state.range(0) / 1000.0);
+		state.ResumeTiming();
+
+		Simulate(&solver, state);
+	}
+}
+
+BENCHMARK_REGISTER_F(DFSPHSolver3, PCISPHDamBreaking)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Arg(1)
+->Arg(10);
+
+// Same scene at the DFSPH default density error, with warm start off (0) and
+// on (1).
+BENCHMARK_DEFINE_F(DFSPHSolver3, WarmStart)(benchmark::State& state)
+{
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		CubbyFlow::DFSPHSolver3 solver;
+		solver.SetIsUsingWarmStart(state.range(0) != 0);
+		SetUpScene(&solver, 0.04, 0.001);
+		state.ResumeTiming();
+
+		Simulate(&solver, state);
+	}
+}
+
+BENCHMARK_REGISTER_F(DFSPHSolver3, WarmStart)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Arg(0)
+->Arg(1);
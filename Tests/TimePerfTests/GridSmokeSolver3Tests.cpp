@@ -0,0 +1,37 @@
+#include "TimePerfTestsUtils.h"
+
+#include <Core/Solver/Grid/GridSmokeSolver3.h>
+
+#include <memory>
+
+using CubbyFlow::Size3;
+using CubbyFlow::Vector3D;
+
+// Smoke plume on a resolution x 2 resolution x resolution grid.
+class GridSmokeSolver3 : public ::benchmark::Fixture
+{
+protected:
+	static constexpr int NUMBER_OF_FRAMES = 2;
+};
+
+BENCHMARK_DEFINE_F(GridSmokeSolver3, SmokePlume)(benchmark::State& state)
+{
+	const auto resolution = static_cast<size_t>(state.range(0));
+
+	BenchmarkSolverSteps(state, [&]()
+	{
+		auto solver = std::make_shared<GridStageTimer<CubbyFlow::GridSmokeSolver3>>(
+			Size3(resolution, 2 * resolution, resolution),
+			Vector3D(1.0, 1.0, 1.0) / static_cast<double>(resolution),
+			Vector3D());
+		SetUpSmokePlume(solver.get());
+		return solver;
+	}, NUMBER_OF_FRAMES);
+
+	state.counters["Cells"] = static_cast<double>(2 * resolution * resolution * resolution);
+}
+
+BENCHMARK_REGISTER_F(GridSmokeSolver3, SmokePlume)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Apply([](benchmark::internal::Benchmark* benchmark) { ApplyStrongScaling(benchmark, { 32, 64 }); });
@@ -0,0 +1,67 @@
+#include "TimePerfTestsUtils.h"
+
+#include <Core/Solver/Hybrid/APIC/APICSolver3.h>
+#include <Core/Solver/Hybrid/FLIP/FLIPSolver3.h>
+#include <Core/Solver/Hybrid/PIC/PICSolver3.h>
+
+#include <memory>
+
+using CubbyFlow::Size3;
+using CubbyFlow::Vector3D;
+
+// Dam-breaking scene on a resolution x 2 resolution x resolution grid, run
+// with each of the PIC-type solvers. The Particles counter is the number of
+// particles at the end of the last iteration.
+class HybridSolver3 : public ::benchmark::Fixture
+{
+protected:
+	static constexpr int NUMBER_OF_FRAMES = 2;
+
+	template <typename Solver>
+	static void Simulate(benchmark::State& state)
+	{
+		const auto resolution = static_cast<size_t>(state.range(0));
+
+		const auto solver = BenchmarkSolverSteps(state, [&]()
+		{
+			auto solver = std::make_shared<HybridStageTimer<Solver>>(
+				Size3(resolution, 2 * resolution, resolution),
+				Vector3D(1.0, 1.0, 1.0) / static_cast<double>(resolution),
+				Vector3D());
+			SetUpDamBreaking(solver.get());
+			return solver;
+		}, NUMBER_OF_FRAMES);
+
+		state.counters["Particles"] = static_cast<double>(solver->GetParticleSystemData()->GetNumberOfParticles());
+	}
+};
+
+BENCHMARK_DEFINE_F(HybridSolver3, PICDamBreaking)(benchmark::State& state)
+{
+	Simulate<CubbyFlow::PICSolver3>(state);
+}
+
+BENCHMARK_REGISTER_F(HybridSolver3, PICDamBreaking)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Apply([](benchmark::internal::Benchmark* benchmark) { ApplyStrongScaling(benchmark, { 32, 64 }); });
+
+BENCHMARK_DEFINE_F(HybridSolver3, FLIPDamBreaking)(benchmark::State& state)
+{
+	Simulate<CubbyFlow::FLIPSolver3>(state);
+}
+
+BENCHMARK_REGISTER_F(HybridSolver3, FLIPDamBreaking)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Apply([](benchmark::internal::Benchmark* benchmark) { ApplyStrongScaling(benchmark, { 32, 64 }); });
+
+BENCHMARK_DEFINE_F(HybridSolver3, APICDamBreaking)(benchmark::State& state)
+{
+	Simulate<CubbyFlow::APICSolver3>(state);
+}
+
+BENCHMARK_REGISTER_F(HybridSolver3, APICDamBreaking)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Apply([](benchmark::internal::Benchmark* benchmark) { ApplyStrongScaling(benchmark, { 32, 64 }); });
@@ -44,4 +44,16 @@ BENCHMARK_DEFINE_F(MatrixMxN, MVM)(benchmark::State& state)
     }
 }
 
-BENCHMARK_REGISTER_F(MatrixMxN, MVM)->Arg(1 << 8)->Arg(1 << 10)->Arg(1 << 12);
\ No newline at end of file
+BENCHMARK_REGISTER_F(MatrixMxN, MVM)->Arg(1 << 8)->Arg(1 << 10)->Arg(1 << 12);
+
+BENCHMARK_DEFINE_F(MatrixMxN, MMM)(benchmark::State& state)
+{
+    CubbyFlow::MatrixMxND result;
+
+    while (state.KeepRunning())
+    {
+        result = mat * mat;
+    }
+}
+
+BENCHMARK_REGISTER_F(MatrixMxN, MMM)->Arg(1 << 8)->Arg(1 << 10);
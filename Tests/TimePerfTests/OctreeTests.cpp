@@ -22,6 +22,8 @@ public:
 	std::mt19937 rng{ 0 };
 	std::uniform_real_distribution<> dist{ 0.0, 1.0 };
 	TriangleMesh3 triMesh;
+	std::vector<Triangle3> triangles;
+	BoundingBox3D bound;
 	CubbyFlow::Octree<Triangle3> queryEngine;
 
 	void SetUp(const ::benchmark::State&) 
@@ -34,8 +36,8 @@ public:
 			file.close();
 		}
 
-		std::vector<Triangle3> triangles;
-		BoundingBox3D bound;
+		triangles.clear();
+		bound.Reset();
 		for (size_t i = 0; i < triMesh.NumberOfTriangles(); ++i)
 		{
 			auto tri = triMesh.Triangle(i);
@@ -43,13 +45,7 @@ public:
 			bound.Merge(tri.BoundingBox());
 		}
 
-		const auto triBoxTestFunc = [](const Triangle3& tri, const BoundingBox3D& box)
-		{
-			// TODO: Implement actual intersecting test
-			return tri.BoundingBox().Overlaps(box);
-		};
-
-		queryEngine.Build(triangles, bound, triBoxTestFunc, 6);
+		queryEngine.Build(triangles, bound, TriBoxTestFunc, 6);
 	}
 
 	Vector3D MakeVec()
@@ -57,6 +53,12 @@ public:
 		return Vector3D(dist(rng), dist(rng), dist(rng));
 	}
 
+	static bool TriBoxTestFunc(const Triangle3& tri, const BoundingBox3D& box)
+	{
+		// TODO: Implement actual intersecting test
+		return tri.BoundingBox().Overlaps(box);
+	}
+
 	static double DistanceFunc(const Triangle3& tri, const Vector3D& pt)
 	{
 		return tri.ClosestDistance(pt);
@@ -86,4 +88,39 @@ BENCHMARK_DEFINE_F(Octree, RayIntersects)(benchmark::State& state)
 	}
 }
 
-BENCHMARK_REGISTER_F(Octree, RayIntersects);
\ No newline at end of file
+BENCHMARK_REGISTER_F(Octree, RayIntersects);
+
+BENCHMARK_DEFINE_F(Octree, Build)(benchmark::State& state)
+{
+	while (state.KeepRunning())
+	{
+		queryEngine.Build(triangles, bound, TriBoxTestFunc, 6);
+	}
+}
+
+BENCHMARK_REGISTER_F(Octree, Build);
+
+BENCHMARK_DEFINE_F(Octree, BuildPoints)(benchmark::State& state)
+{
+	const size_t numberOfPoints = static_cast<size_t>(state.range(0));
+	std::vector<Vector3D> points;
+
+	for (size_t i = 0; i < numberOfPoints; ++i)
+	{
+		points.push_back(MakeVec());
+	}
+
+	const auto pointBoxTestFunc = [](const Vector3D& pt, const BoundingBox3D& box)
+	{
+		return box.Contains(pt);
+	};
+
+	CubbyFlow::Octree<Vector3D> pointOctree;
+
+	while (state.KeepRunning())
+	{
+		pointOctree.Build(points, BoundingBox3D(Vector3D(), Vector3D(1, 1, 1)), pointBoxTestFunc, 7);
+	}
+}
+
+BENCHMARK_REGISTER_F(Octree, BuildPoints)->Arg(1 << 14)->Arg(1 << 18);
\ No newline at end of file
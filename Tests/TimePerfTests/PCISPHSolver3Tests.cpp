@@ -0,0 +1,33 @@
+#include "TimePerfTestsUtils.h"
+
+#include <Core/Solver/Particle/PCISPH/PCISPHSolver3.h>
+
+#include <memory>
+
+// Water-drop scene in a 1 x 2 x 1 box. The resolution is the number of
+// particles per unit length.
+class PCISPHSolver3 : public ::benchmark::Fixture
+{
+protected:
+	static constexpr int NUMBER_OF_FRAMES = 2;
+};
+
+BENCHMARK_DEFINE_F(PCISPHSolver3, WaterDrop)(benchmark::State& state)
+{
+	const double targetSpacing = 1.0 / static_cast<double>(state.range(0));
+
+	const auto solver = BenchmarkSolverSteps(state, [&]()
+	{
+		auto solver = std::make_shared<SPHStageTimer<CubbyFlow::PCISPHSolver3>>();
+		solver->SetPseudoViscosityCoefficient(0.0);
+		SetUpWaterDrop(solver.get(), targetSpacing);
+		return solver;
+	}, NUMBER_OF_FRAMES);
+
+	state.counters["Particles"] = static_cast<double>(solver->GetSPHSystemData()->GetNumberOfParticles());
+}
+
+BENCHMARK_REGISTER_F(PCISPHSolver3, WaterDrop)
+->UseRealTime()
+->Unit(benchmark::kMillisecond)
+->Apply([](benchmark::internal::Benchmark* benchmark) { ApplyStrongScaling(benchmark, { 20, 30 }); });
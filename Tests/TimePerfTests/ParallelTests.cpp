@@ -1,5 +1,7 @@
 #include "benchmark/benchmark.h"
 
+#include <Core/Array/Array3.h>
+#include <Core/Array/ArrayAllocator.h>
 #include <Core/Utils/Constants.h>
 #include <Core/Utils/Parallel.h>
 
@@ -89,4 +91,93 @@ BENCHMARK_REGISTER_F(Parallel, ParallelRangeFor)
 ->Args({ 1 << 24, 1 })
 ->Args({ 1 << 24, 2 })
 ->Args({ 1 << 24, 4 })
-->Args({ 1 << 24, 8 });
\ No newline at end of file
+->Args({ 1 << 24, 8 });
+
+BENCHMARK_DEFINE_F(Parallel, ParallelReduce)(benchmark::State& state)
+{
+    const unsigned int oldNumThreads = CubbyFlow::GetMaxNumberOfThreads();
+    const bool oldIsDeterministic = CubbyFlow::GetIsDeterministic();
+    CubbyFlow::SetMaxNumberOfThreads(numThreads);
+    CubbyFlow::SetIsDeterministic(state.range(2) != 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = d(rng);
+        b[i] = d(rng);
+    }
+
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(CubbyFlow::ParallelReduce(CubbyFlow::ZERO_SIZE, n, 0.0,
+            [this](size_t iBegin, size_t iEnd, double init)
+        {
+            double result = init;
+
+            for (size_t i = iBegin; i < iEnd; ++i)
+            {
+                result += a[i] * b[i];
+            }
+
+            return result;
+        }, std::plus<double>()));
+    }
+
+    CubbyFlow::SetIsDeterministic(oldIsDeterministic);
+    CubbyFlow::SetMaxNumberOfThreads(oldNumThreads);
+}
+
+BENCHMARK_REGISTER_F(Parallel, ParallelReduce)
+->UseRealTime()
+->Args({ 1 << 16, 1, 0 })
+->Args({ 1 << 16, 1, 1 })
+->Args({ 1 << 16, 8, 0 })
+->Args({ 1 << 16, 8, 1 })
+->Args({ 1 << 24, 1, 0 })
+->Args({ 1 << 24, 1, 1 })
+->Args({ 1 << 24, 8, 0 })
+->Args({ 1 << 24, 8, 1 });
+
+static void Stencil3(benchmark::State& state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    const unsigned int oldNumThreads = CubbyFlow::GetMaxNumberOfThreads();
+    const bool oldIsUsingThreadAffinity = CubbyFlow::GetIsUsingThreadAffinity();
+    CubbyFlow::SetMaxNumberOfThreads(static_cast<unsigned int>(state.range(1)));
+    CubbyFlow::SetIsUsingThreadAffinity(state.range(2) != 0);
+
+    // Fresh blocks, so the pages are first touched with the current setting
+    CubbyFlow::ArrayMemoryPool::Clear();
+
+    {
+        CubbyFlow::Array3<double> u(n, n, n, 1.0);
+        CubbyFlow::Array3<double> v(n, n, n, 0.0);
+
+        while (state.KeepRunning())
+        {
+            CubbyFlow::ParallelFor(
+                CubbyFlow::ONE_SIZE, n - 1,
+                CubbyFlow::ONE_SIZE, n - 1,
+                CubbyFlow::ONE_SIZE, n - 1,
+                [&](size_t i, size_t j, size_t k)
+            {
+                v(i, j, k) = u(i - 1, j, k) + u(i + 1, j, k) + u(i, j - 1, k) + u(i, j + 1, k)
+                    + u(i, j, k - 1) + u(i, j, k + 1) - 6.0 * u(i, j, k);
+            });
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * 2 * n * n * n * sizeof(double));
+    }
+
+    CubbyFlow::ArrayMemoryPool::Clear();
+    CubbyFlow::SetIsUsingThreadAffinity(oldIsUsingThreadAffinity);
+    CubbyFlow::SetMaxNumberOfThreads(oldNumThreads);
+}
+
+BENCHMARK(Stencil3)
+->UseRealTime()
+->Args({ 1 << 8, 8, 0 })
+->Args({ 1 << 8, 8, 1 })
+->Args({ 1 << 9, 8, 0 })
+->Args({ 1 << 9, 8, 1 })
+->Args({ 1 << 9, 32, 0 })
+->Args({ 1 << 9, 32, 1 });
@@ -0,0 +1,116 @@
+#include "benchmark/benchmark.h"
+
+#include <Core/Array/Array1.h>
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
+#include <Core/Searcher/PointParallelHashGridSearcher3.h>
+#include <Core/Vector/Vector3.h>
+
+#include <random>
+#include <vector>
+
+using CubbyFlow::Array1;
+using CubbyFlow::Vector3D;
+
+class PointCompactHashGridSearcher3 : public ::benchmark::Fixture
+{
+protected:
+    std::mt19937 rng{ 0 };
+    std::uniform_real_distribution<> dist{ 0.0, 1.0 };
+    Array1<Vector3D> points;
+
+    void SetUp(const ::benchmark::State& state)
+    {
+        int64_t N = state.range(0);
+
+        points.Clear();
+        for (int64_t i = 0; i < N; ++i)
+        {
+            points.Append(MakeVec());
+        }
+    }
+
+    Vector3D MakeVec()
+    {
+        return Vector3D(dist(rng), dist(rng), dist(rng));
+    }
+
+    // A few dense splashes far away from each other in a huge domain.
+    void MakeSparsePoints(int64_t N)
+    {
+        points.Clear();
+        for (int64_t i = 0; i < N; ++i)
+        {
+            const double offset = 100.0 * static_cast<double>(i % 8);
+            points.Append(MakeVec() * 0.5 + Vector3D(offset, -offset, offset));
+        }
+    }
+};
+
+BENCHMARK_DEFINE_F(PointCompactHashGridSearcher3, Build)(benchmark::State& state)
+{
+    while (state.KeepRunning())
+    {
+        CubbyFlow::PointCompactHashGridSearcher3 grid(1.0 / 64.0);
+        grid.Build(points);
+    }
+}
+
+BENCHMARK_REGISTER_F(PointCompactHashGridSearcher3, Build)
+->Arg(1 << 5)
+->Arg(1 << 10)
+->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointCompactHashGridSearcher3, ForEachNearbyPoints)(benchmark::State& state)
+{
+    CubbyFlow::PointCompactHashGridSearcher3 grid(1.0 / 64.0);
+    grid.Build(points);
+
+    size_t cnt = 0;
+    while (state.KeepRunning())
+    {
+        grid.ForEachNearbyPoint(MakeVec(), 1.0 / 128.0,
+            [&](size_t, const Vector3D&)
+        {
+            ++cnt;
+        });
+    }
+}
+
+BENCHMARK_REGISTER_F(PointCompactHashGridSearcher3, ForEachNearbyPoints)
+->Arg(1 << 5)
+->Arg(1 << 10)
+->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointCompactHashGridSearcher3, BuildNeighborListsSparse)(benchmark::State& state)
+{
+    MakeSparsePoints(state.range(0));
+
+    std::vector<std::vector<size_t>> neighborLists;
+    while (state.KeepRunning())
+    {
+        CubbyFlow::PointCompactHashGridSearcher3 grid(1.0 / 64.0);
+        grid.Build(points);
+        grid.BuildNeighborLists(points, 1.0 / 128.0, &neighborLists);
+    }
+}
+
+BENCHMARK_REGISTER_F(PointCompactHashGridSearcher3, BuildNeighborListsSparse)
+->Arg(1 << 10)
+->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointCompactHashGridSearcher3, BuildNeighborListsSparseParallelHashGrid)(benchmark::State& state)
+{
+    MakeSparsePoints(state.range(0));
+
+    std::vector<std::vector<size_t>> neighborLists;
+    while (state.KeepRunning())
+    {
+        CubbyFlow::PointParallelHashGridSearcher3 grid(64, 64, 64, 1.0 / 64.0);
+        grid.Build(points);
+        grid.BuildNeighborLists(points, 1.0 / 128.0, &neighborLists);
+    }
+}
+
+BENCHMARK_REGISTER_F(PointCompactHashGridSearcher3, BuildNeighborListsSparseParallelHashGrid)
+->Arg(1 << 10)
+->Arg(1 << 20);
\ No newline at end of file
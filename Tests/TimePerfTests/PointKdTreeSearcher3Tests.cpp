@@ -64,6 +64,27 @@ BENCHMARK_DEFINE_F(PointKdTreeSearcher3, ForEachNearbyPoints)(benchmark::State&
 }
 
 BENCHMARK_REGISTER_F(PointKdTreeSearcher3, ForEachNearbyPoints)
+    ->Arg(1 << 5)
+    ->Arg(1 << 10)
+    ->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointKdTreeSearcher3, ForEachKNearestPoints)(benchmark::State& state)
+{
+    CubbyFlow::PointKdTreeSearcher3 tree;
+    tree.Build(points);
+
+    size_t cnt = 0;
+    while (state.KeepRunning())
+    {
+        tree.ForEachKNearestPoints(MakeVec(), 16,
+            [&](size_t, const Vector3D&)
+        {
+            ++cnt;
+        });
+    }
+}
+
+BENCHMARK_REGISTER_F(PointKdTreeSearcher3, ForEachKNearestPoints)
     ->Arg(1 << 5)
     ->Arg(1 << 10)
     ->Arg(1 << 20);
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <Core/Vector/Vector3.h>
 
 #include <random>
+#include <vector>
 
 using CubbyFlow::Array1;
 using CubbyFlow::Vector3D;
@@ -66,4 +67,49 @@ BENCHMARK_DEFINE_F(PointParallelHashGridSearcher3, ForEachNearbyPoints)(benchmar
 BENCHMARK_REGISTER_F(PointParallelHashGridSearcher3, ForEachNearbyPoints)
 ->Arg(1 << 5)
 ->Arg(1 << 10)
+->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointParallelHashGridSearcher3, BuildNeighborLists)(benchmark::State& state)
+{
+    CubbyFlow::PointParallelHashGridSearcher3 grid(64, 64, 64, 1.0 / 64.0);
+    grid.Build(points);
+
+    std::vector<std::vector<size_t>> neighborLists;
+    while (state.KeepRunning())
+    {
+        grid.BuildNeighborLists(points, 1.0 / 128.0, &neighborLists);
+    }
+}
+
+BENCHMARK_REGISTER_F(PointParallelHashGridSearcher3, BuildNeighborLists)
+->Arg(1 << 5)
+->Arg(1 << 10)
+->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(PointParallelHashGridSearcher3, ForEachNearbyPointsPerPoint)(benchmark::State& state)
+{
+    CubbyFlow::PointParallelHashGridSearcher3 grid(64, 64, 64, 1.0 / 64.0);
+    grid.Build(points);
+
+    std::vector<std::vector<size_t>> neighborLists(points.size());
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            neighborLists[i].clear();
+            grid.ForEachNearbyPoint(points[i], 1.0 / 128.0,
+                [&](size_t j, const Vector3D&)
+            {
+                if (i != j)
+                {
+                    neighborLists[i].push_back(j);
+                }
+            });
+        }
+    }
+}
+
+BENCHMARK_REGISTER_F(PointParallelHashGridSearcher3, ForEachNearbyPointsPerPoint)
+->Arg(1 << 5)
+->Arg(1 << 10)
 ->Arg(1 << 20);
\ No newline at end of file
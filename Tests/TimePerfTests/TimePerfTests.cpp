@@ -6,6 +6,8 @@
 
 int main(int argc, char** argv)
 {
+    // Results can be recorded for regression tracking with
+    // --benchmark_out=<file> --benchmark_out_format=json.
     ::benchmark::Initialize(&argc, argv);
 
     if (::benchmark::ReportUnrecognizedArguments(argc, argv))
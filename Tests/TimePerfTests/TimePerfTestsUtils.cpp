@@ -0,0 +1,154 @@
+#include "TimePerfTestsUtils.h"
+
+#include <Core/Collider/RigidBodyCollider3.h>
+#include <Core/Emitter/VolumeGridEmitter3.h>
+#include <Core/Emitter/VolumeParticleEmitter3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/Geometry/Plane3.h>
+#include <Core/Geometry/Sphere3.h>
+#include <Core/PointGenerator/GridPointGenerator3.h>
+#include <Core/Surface/ImplicitSurfaceSet3.h>
+
+#include <memory>
+
+using namespace CubbyFlow;
+
+void StageTimes::Accumulate(const StageTimes& other)
+{
+	for (const auto& stage : other.m_seconds)
+	{
+		m_seconds[stage.first] += stage.second;
+	}
+}
+
+void StageTimes::Clear()
+{
+	m_seconds.clear();
+}
+
+void StageTimes::SetCounters(benchmark::State& state) const
+{
+	const double iterations = state.iterations() > 0 ? static_cast<double>(state.iterations()) : 1.0;
+
+	for (const auto& stage : m_seconds)
+	{
+		state.counters[stage.first] = stage.second / iterations;
+	}
+}
+
+void ApplyStrongScaling(benchmark::internal::Benchmark* benchmark, std::initializer_list<int> resolutions)
+{
+	for (int resolution : resolutions)
+	{
+		for (int numThreads : { 1, 2, 4, 8 })
+		{
+			benchmark->Args({ resolution, numThreads });
+		}
+	}
+}
+
+namespace
+{
+	Surface3Ptr MakeDamBreakingColumn(const BoundingBox3D& domain)
+	{
+		return Box3::Builder()
+			.WithLowerCorner(domain.lowerCorner)
+			.WithUpperCorner(domain.lowerCorner + Vector3D(0.25 * domain.GetWidth(), 0.75 * domain.GetHeight(), domain.GetDepth()))
+			.MakeShared();
+	}
+}
+
+void SetUpDamBreaking(PICSolver3* solver)
+{
+	const auto grids = solver->GetGridSystemData();
+	const double dx = grids->GetGridSpacing().x;
+	const BoundingBox3D domain = grids->GetBoundingBox();
+
+	auto emitter = VolumeParticleEmitter3::Builder()
+		.WithSurface(MakeDamBreakingColumn(domain))
+		.WithSpacing(0.5 * dx)
+		.WithMaxRegion(domain)
+		.WithIsOneShot(true)
+		.MakeShared();
+	emitter->SetPointGenerator(std::make_shared<GridPointGenerator3>());
+
+	solver->SetParticleEmitter(emitter);
+}
+
+void SetUpDamBreaking(LevelSetLiquidSolver3* solver)
+{
+	const BoundingBox3D domain = solver->GetGridSystemData()->GetBoundingBox();
+
+	auto emitter = VolumeGridEmitter3::Builder()
+		.WithSourceRegion(MakeDamBreakingColumn(domain))
+		.MakeShared();
+
+	solver->SetEmitter(emitter);
+	emitter->AddSignedDistanceTarget(solver->GetSignedDistanceField());
+}
+
+void SetUpSmokePlume(GridSmokeSolver3* solver)
+{
+	const BoundingBox3D domain = solver->GetGridSystemData()->GetBoundingBox();
+
+	const auto source = Box3::Builder()
+		.WithLowerCorner({ 0.45, -1, 0.45 })
+		.WithUpperCorner({ 0.55, 0.05, 0.55 })
+		.MakeShared();
+
+	auto emitter = VolumeGridEmitter3::Builder()
+		.WithSourceRegion(source)
+		.WithIsOneShot(false)
+		.MakeShared();
+
+	solver->SetEmitter(emitter);
+	emitter->AddStepFunctionTarget(solver->GetSmokeDensity(), 0, 1);
+	emitter->AddStepFunctionTarget(solver->GetTemperature(), 0, 1);
+
+	const auto sphere = Sphere3::Builder()
+		.WithCenter({ 0.5, 0.3, 0.5 })
+		.WithRadius(0.075 * domain.GetWidth())
+		.MakeShared();
+
+	solver->SetCollider(RigidBodyCollider3::Builder().WithSurface(sphere).MakeShared());
+}
+
+void SetUpWaterDrop(SPHSolver3* solver, double targetSpacing)
+{
+	const BoundingBox3D domain(Vector3D(), Vector3D(1, 2, 1));
+
+	auto particles = solver->GetSPHSystemData();
+	particles->SetTargetDensity(1000.0);
+	particles->SetTargetSpacing(targetSpacing);
+
+	BoundingBox3D sourceBound(domain);
+	sourceBound.Expand(-targetSpacing);
+
+	const auto plane = Plane3::Builder()
+		.WithNormal({ 0, 1, 0 })
+		.WithPoint({ 0, 0.25 * domain.GetHeight(), 0 })
+		.MakeShared();
+
+	const auto sphere = Sphere3::Builder()
+		.WithCenter(domain.MidPoint())
+		.WithRadius(0.15 * domain.GetWidth())
+		.MakeShared();
+
+	const auto surfaceSet = ImplicitSurfaceSet3::Builder()
+		.WithExplicitSurfaces({ plane, sphere })
+		.MakeShared();
+
+	auto emitter = VolumeParticleEmitter3::Builder()
+		.WithSurface(surfaceSet)
+		.WithSpacing(targetSpacing)
+		.WithMaxRegion(sourceBound)
+		.WithIsOneShot(true)
+		.MakeShared();
+	solver->SetEmitter(emitter);
+
+	const auto box = Box3::Builder()
+		.WithIsNormalFlipped(true)
+		.WithBoundingBox(domain)
+		.MakeShared();
+	solver->SetCollider(RigidBodyCollider3::Builder().WithSurface(box).MakeShared());
+}
@@ -0,0 +1,205 @@
+#ifndef TIME_PERF_TESTS_UTILS_H
+#define TIME_PERF_TESTS_UTILS_H
+
+#include "benchmark/benchmark.h"
+
+#include <Core/Animation/Frame.h>
+#include <Core/Solver/Grid/GridSmokeSolver3.h>
+#include <Core/Solver/Hybrid/PIC/PICSolver3.h>
+#include <Core/Solver/LevelSet/LevelSetLiquidSolver3.h>
+#include <Core/Solver/Particle/SPH/SPHSolver3.h>
+#include <Core/Utils/Parallel.h>
+#include <Core/Utils/Timer.h>
+
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+
+// Accumulated wall-time of each stage of the solver steps.
+class StageTimes
+{
+public:
+	template <typename Function>
+	void Measure(const std::string& stage, const Function& function)
+	{
+		CubbyFlow::Timer timer;
+		function();
+		m_seconds[stage] += timer.DurationInSeconds();
+	}
+
+	void Accumulate(const StageTimes& other);
+
+	void Clear();
+
+	// Reports each stage as a counter in seconds per benchmark iteration.
+	void SetCounters(benchmark::State& state) const;
+
+private:
+	std::map<std::string, double> m_seconds;
+};
+
+// Grid fluid solver that measures the stages of GridFluidSolver3's step.
+template <typename Solver>
+class GridStageTimer : public Solver
+{
+public:
+	using Solver::Solver;
+
+	StageTimes& GetStageTimes()
+	{
+		return m_stageTimes;
+	}
+
+protected:
+	void OnBeginAdvanceTimeStep(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("BeginStep", [&]() { Solver::OnBeginAdvanceTimeStep(timeIntervalInSeconds); });
+	}
+
+	void OnEndAdvanceTimeStep(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("EndStep", [&]() { Solver::OnEndAdvanceTimeStep(timeIntervalInSeconds); });
+	}
+
+	void ComputeExternalForces(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("ExternalForces", [&]() { Solver::ComputeExternalForces(timeIntervalInSeconds); });
+	}
+
+	void ComputeViscosity(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("Viscosity", [&]() { Solver::ComputeViscosity(timeIntervalInSeconds); });
+	}
+
+	void ComputePressure(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("Pressure", [&]() { Solver::ComputePressure(timeIntervalInSeconds); });
+	}
+
+	void ComputeAdvection(double timeIntervalInSeconds) override
+	{
+		m_stageTimes.Measure("Advection", [&]() { Solver::ComputeAdvection(timeIntervalInSeconds); });
+	}
+
+	StageTimes m_stageTimes;
+};
+
+// PIC-type solver that also measures the transfers, which run inside the
+// BeginStep (P2G) and Advection (G2P, MoveParticles) stages.
+template <typename Solver>
+class HybridStageTimer final : public GridStageTimer<Solver>
+{
+public:
+	using GridStageTimer<Solver>::GridStageTimer;
+
+protected:
+	void TransferFromParticlesToGrids() override
+	{
+		this->m_stageTimes.Measure("P2G", [&]() { Solver::TransferFromParticlesToGrids(); });
+	}
+
+	void TransferFromGridsToParticles() override
+	{
+		this->m_stageTimes.Measure("G2P", [&]() { Solver::TransferFromGridsToParticles(); });
+	}
+
+	void MoveParticles(double timeIntervalInSeconds) override
+	{
+		this->m_stageTimes.Measure("MoveParticles", [&]() { Solver::MoveParticles(timeIntervalInSeconds); });
+	}
+};
+
+// SPH solver that measures the stages of ParticleSystemSolver3's sub-step.
+template <typename Solver>
+class SPHStageTimer final : public Solver
+{
+public:
+	using Solver::Solver;
+
+	StageTimes& GetStageTimes()
+	{
+		return m_stageTimes;
+	}
+
+protected:
+	void OnBeginAdvanceTimeStep(double timeStepInSeconds) override
+	{
+		m_stageTimes.Measure("BeginStep", [&]() { Solver::OnBeginAdvanceTimeStep(timeStepInSeconds); });
+	}
+
+	void OnEndAdvanceTimeStep(double timeStepInSeconds) override
+	{
+		m_stageTimes.Measure("EndStep", [&]() { Solver::OnEndAdvanceTimeStep(timeStepInSeconds); });
+	}
+
+	void AccumulateNonPressureForces(double timeStepInSeconds) override
+	{
+		m_stageTimes.Measure("NonPressureForces", [&]() { Solver::AccumulateNonPressureForces(timeStepInSeconds); });
+	}
+
+	void AccumulatePressureForce(double timeStepInSeconds) override
+	{
+		m_stageTimes.Measure("PressureForce", [&]() { Solver::AccumulatePressureForce(timeStepInSeconds); });
+	}
+
+private:
+	StageTimes m_stageTimes;
+};
+
+// Builds a solver with \p makeSolver and runs the first frame, which emits
+// the scene, untimed. Then measures \p numberOfFrames frames at 60 fps with
+// state.range(1) threads and reports the per-stage times. Returns the solver
+// of the last iteration, so the caller can report the scene size.
+template <typename MakeSolver>
+auto BenchmarkSolverSteps(benchmark::State& state, const MakeSolver& makeSolver, int numberOfFrames)
+{
+	const unsigned int oldNumThreads = CubbyFlow::GetMaxNumberOfThreads();
+	CubbyFlow::SetMaxNumberOfThreads(static_cast<unsigned int>(state.range(1)));
+
+	decltype(makeSolver()) lastSolver;
+	StageTimes stageTimes;
+
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		auto solver = makeSolver();
+		CubbyFlow::Frame frame(0, 1.0 / 60.0);
+		solver->Update(frame);
+		solver->GetStageTimes().Clear();
+		state.ResumeTiming();
+
+		for (++frame; frame.index <= numberOfFrames; ++frame)
+		{
+			solver->Update(frame);
+		}
+
+		state.PauseTiming();
+		stageTimes.Accumulate(solver->GetStageTimes());
+		lastSolver = std::move(solver);
+		state.ResumeTiming();
+	}
+
+	stageTimes.SetCounters(state);
+	CubbyFlow::SetMaxNumberOfThreads(oldNumThreads);
+
+	return lastSolver;
+}
+
+// Registers a strong-scaling sweep: every resolution with 1, 2, 4 and 8
+// threads, passed as { resolution, threads }.
+void ApplyStrongScaling(benchmark::internal::Benchmark* benchmark, std::initializer_list<int> resolutions);
+
+// Liquid column in the corner of the domain, emitted as particles.
+void SetUpDamBreaking(CubbyFlow::PICSolver3* solver);
+
+// Liquid column in the corner of the domain, emitted as a level set.
+void SetUpDamBreaking(CubbyFlow::LevelSetLiquidSolver3* solver);
+
+// Hot smoke rising from a source at the bottom around a sphere.
+void SetUpSmokePlume(CubbyFlow::GridSmokeSolver3* solver);
+
+// Sphere of water dropping into a pool in a 1 x 2 x 1 box.
+void SetUpWaterDrop(CubbyFlow::SPHSolver3* solver, double targetSpacing);
+
+#endif
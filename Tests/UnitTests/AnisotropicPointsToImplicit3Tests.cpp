@@ -0,0 +1,50 @@
+#include "pch.h"
+
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/PointsToImplicit/AnisotropicPointsToImplicit3.h>
+
+using namespace CubbyFlow;
+
+TEST(AnisotropicPointsToImplicit3, GatherEquivalence)
+{
+	const double kernelRadius = 0.1;
+	const double cutOffDensity = 0.5;
+
+	// Points further apart than the kernel support have an isotropic kernel
+	// at their own position, so the gathered density of a data point x is
+	// the sum of (1 - |x - x_i|^2 / h^2)^3 over the points within h.
+	Array1<Vector3D> points;
+	for (size_t k = 0; k < 3; ++k)
+	{
+		for (size_t j = 0; j < 3; ++j)
+		{
+			for (size_t i = 0; i < 3; ++i)
+			{
+				points.Append(Vector3D(0.2 + 0.29 * i, 0.21 + 0.29 * j, 0.22 + 0.29 * k));
+			}
+		}
+	}
+
+	CellCenteredScalarGrid3 output(Size3(24, 24, 24), Vector3D(1.0 / 24, 1.0 / 24, 1.0 / 24));
+	AnisotropicPointsToImplicit3 converter(kernelRadius, cutOffDensity, 0.5, 25, false);
+	converter.Convert(points.ConstAccessor(), &output);
+
+	const auto pos = output.GetDataPosition();
+
+	output.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		const Vector3D x = pos(i, j, k);
+
+		double sum = 0.0;
+		for (size_t p = 0; p < points.size(); ++p)
+		{
+			const double distanceSquared = x.DistanceSquaredTo(points[p]) / Square(kernelRadius);
+			if (distanceSquared < 1.0)
+			{
+				sum += Cubic(1.0 - distanceSquared);
+			}
+		}
+
+		EXPECT_NEAR(cutOffDensity - sum, output(i, j, k), 1e-10);
+	});
+}
@@ -183,6 +183,40 @@ TEST(Array3, ResizeMethod)
 	}
 }
 
+TEST(Array3, ParallelResize)
+{
+	Array3<double> arr1(50, 40, 40);
+	ASSERT_LE(ARRAY_PARALLEL_INIT_MIN_SIZE, arr1.size().x * arr1.size().y * arr1.size().z);
+	arr1.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		arr1(i, j, k) = static_cast<double>(i + 100 * j + 10000 * k);
+	});
+
+	arr1.Resize(Size3(60, 30, 45), -1.0);
+	EXPECT_EQ(60u, arr1.Width());
+	EXPECT_EQ(30u, arr1.Height());
+	EXPECT_EQ(45u, arr1.Depth());
+	arr1.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		if (i < 50 && k < 40)
+		{
+			EXPECT_DOUBLE_EQ(static_cast<double>(i + 100 * j + 10000 * k), arr1(i, j, k));
+		}
+		else
+		{
+			EXPECT_DOUBLE_EQ(-1.0, arr1(i, j, k));
+		}
+	});
+
+	Array3<double> arr2(3, 4, 5, 7.0);
+	arr2.Set(arr1);
+	EXPECT_EQ(arr1.size(), arr2.size());
+	for (size_t i = 0; i < 60 * 30 * 45; ++i)
+	{
+		EXPECT_DOUBLE_EQ(arr1[i], arr2[i]);
+	}
+}
+
 TEST(Array3, Iterators)
 {
 	Array3<float> arr1(
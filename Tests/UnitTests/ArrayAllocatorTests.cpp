@@ -0,0 +1,91 @@
+#include "pch.h"
+
+#include <Core/Array/Array1.h>
+#include <Core/Array/Array3.h>
+#include <Core/Array/ArrayAllocator.h>
+
+#include <cstdint>
+
+using namespace CubbyFlow;
+
+TEST(ArrayAllocator, Alignment)
+{
+	Array1<char> arr1(3, 'a');
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(arr1.data()) % ARRAY_ALIGNMENT);
+
+	Array3<double> arr2(130, 130, 130, 1.0);
+	EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(arr2.data()) % ARRAY_POOL_BLOCK_ALIGNMENT);
+	EXPECT_DOUBLE_EQ(1.0, arr2(129, 129, 129));
+}
+
+TEST(ArrayAllocator, Recycling)
+{
+	// Pooling is opt-in.
+	const bool oldIsPooling = ArrayMemoryPool::GetIsPooling();
+	EXPECT_FALSE(oldIsPooling);
+	EXPECT_EQ(size_t(512) << 20, ArrayMemoryPool::GetMaxPooledBytes());
+
+	ArrayMemoryPool::SetIsPooling(true);
+	ArrayMemoryPool::Clear();
+
+	const size_t numberOfFreshBlocks = ArrayMemoryPool::GetNumberOfFreshBlocks();
+	const size_t numberOfRecycledBlocks = ArrayMemoryPool::GetNumberOfRecycledBlocks();
+
+	const double* firstData;
+	{
+		Array3<double> arr(100, 100, 100, 2.0);
+		firstData = arr.data();
+	}
+	EXPECT_EQ(numberOfFreshBlocks + 1, ArrayMemoryPool::GetNumberOfFreshBlocks());
+	EXPECT_LT(0u, ArrayMemoryPool::GetPooledBytes());
+
+	// A slightly smaller array falls into the same size class.
+	{
+		Array3<double> arr(99, 100, 100, 3.0);
+		EXPECT_EQ(firstData, arr.data());
+		EXPECT_DOUBLE_EQ(3.0, arr(98, 99, 99));
+	}
+	EXPECT_EQ(numberOfFreshBlocks + 1, ArrayMemoryPool::GetNumberOfFreshBlocks());
+	EXPECT_EQ(numberOfRecycledBlocks + 1, ArrayMemoryPool::GetNumberOfRecycledBlocks());
+
+	ArrayMemoryPool::SetIsPooling(false);
+	EXPECT_EQ(0u, ArrayMemoryPool::GetPooledBytes());
+	{
+		Array3<double> arr(100, 100, 100, 4.0);
+	}
+	EXPECT_EQ(0u, ArrayMemoryPool::GetPooledBytes());
+
+	ArrayMemoryPool::SetIsPooling(oldIsPooling);
+}
+
+TEST(ArrayAllocator, ValueInitialization)
+{
+	// Recycled blocks still hold the values of their previous user, so
+	// they show whether an element is left unwritten.
+	const bool oldIsPooling = ArrayMemoryPool::GetIsPooling();
+	ArrayMemoryPool::SetIsPooling(true);
+
+	const size_t n = 1 << 18;
+	{
+		Array1<double> arr1(n, 5.0);
+		Array3<double> arr3(64, 64, 64, 5.0);
+	}
+
+	Array1<double> arr1(n);
+	Array3<double> arr3(64, 64, 64);
+	for (size_t i = 0; i < n; ++i)
+	{
+		EXPECT_EQ(0.0, arr1[i]);
+		EXPECT_EQ(0.0, arr3[i]);
+	}
+
+	arr1.Resize(2 * n);
+	arr3.Resize(128, 64, 64);
+	for (size_t i = 0; i < 2 * n; ++i)
+	{
+		EXPECT_EQ(0.0, arr1[i]);
+		EXPECT_EQ(0.0, arr3[i]);
+	}
+
+	ArrayMemoryPool::SetIsPooling(oldIsPooling);
+}
@@ -358,6 +358,29 @@ TEST(CellCenteredScalarGrid3, LaplacianAtAtDataPoint)
 	}
 }
 
+TEST(CellCenteredScalarGrid3, SampleMultiple)
+{
+	CellCenteredScalarGrid3 grid0(5, 8, 6, 2.0, 3.0, 1.5);
+	CellCenteredScalarGrid3 grid1(5, 8, 6, 2.0, 3.0, 1.5);
+	CellCenteredScalarGrid3 grid2(5, 8, 6, 2.0, 3.0, 1.5);
+
+	grid0.Fill([](const Vector3D& x) { return x.x * x.y; });
+	grid1.Fill([](const Vector3D& x) { return std::sin(x.z); });
+	grid2.Fill([](const Vector3D& x) { return x.Sum(); });
+
+	const std::vector<const ScalarGrid3*> grids = { &grid0, &grid1, &grid2 };
+	std::array<double, 3> results;
+
+	for (const Vector3D& pt : { Vector3D(0.2, 0.5, 0.1), Vector3D(3.3, 11.7, 4.2), Vector3D(-1.0, 30.0, 8.5) })
+	{
+		grid0.SampleMultiple(pt, grids, ArrayAccessor1<double>(results.size(), results.data()));
+
+		EXPECT_NEAR(grid0.Sample(pt), results[0], 1e-12);
+		EXPECT_NEAR(grid1.Sample(pt), results[1], 1e-12);
+		EXPECT_NEAR(grid2.Sample(pt), results[2], 1e-12);
+	}
+}
+
 TEST(CellCenteredScalarGrid3, Serialization)
 {
 	CellCenteredScalarGrid3 grid1(5, 4, 3, 1.0, 2.0, 3.0, -5.0, 3.0, 1.0);
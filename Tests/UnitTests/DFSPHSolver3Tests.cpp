@@ -0,0 +1,123 @@
+#include "pch.h"
+
+#include <Core/Collider/RigidBodyCollider3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/Solver/Particle/DFSPH/DFSPHSolver3.h>
+
+using namespace CubbyFlow;
+
+TEST(DFSPHSolver3, UpdateEmpty)
+{
+	// Empty solver test
+	DFSPHSolver3 solver;
+	Frame frame(0, 0.01);
+	solver.Update(frame++);
+	solver.Update(frame);
+}
+
+TEST(DFSPHSolver3, Parameters)
+{
+	DFSPHSolver3 solver;
+
+	solver.SetMaxDensityErrorRatio(5.0);
+	EXPECT_DOUBLE_EQ(5.0, solver.GetMaxDensityErrorRatio());
+
+	solver.SetMaxDensityErrorRatio(-1.0);
+	EXPECT_DOUBLE_EQ(0.0, solver.GetMaxDensityErrorRatio());
+
+	solver.SetMaxDivergenceErrorRatio(0.5);
+	EXPECT_DOUBLE_EQ(0.5, solver.GetMaxDivergenceErrorRatio());
+
+	solver.SetMaxDivergenceErrorRatio(-1.0);
+	EXPECT_DOUBLE_EQ(0.0, solver.GetMaxDivergenceErrorRatio());
+
+	solver.SetMaxNumberOfIterations(10);
+	EXPECT_EQ(10u, solver.GetMaxNumberOfIterations());
+
+	EXPECT_TRUE(solver.GetIsUsingWarmStart());
+	solver.SetIsUsingWarmStart(false);
+	EXPECT_FALSE(solver.GetIsUsingWarmStart());
+}
+
+TEST(DFSPHSolver3, WarmStart)
+{
+	Array1<Vector3D> points;
+	for (size_t k = 0; k < 8; ++k)
+	{
+		for (size_t j = 0; j < 8; ++j)
+		{
+			for (size_t i = 0; i < 8; ++i)
+			{
+				points.Append(Vector3D(0.1 * i + 0.05, 0.1 * j + 0.05, 0.1 * k + 0.05));
+			}
+		}
+	}
+
+	auto box = Box3::Builder()
+		.WithLowerCorner({ 0, 0, 0 })
+		.WithUpperCorner({ 0.8, 2, 0.8 })
+		.WithIsNormalFlipped(true)
+		.MakeShared();
+
+	DFSPHSolver3 cold(1000.0, 0.1, 1.8);
+	cold.GetSPHSystemData()->AddParticles(points);
+	cold.SetCollider(RigidBodyCollider3::Builder().WithSurface(box).MakeShared());
+	cold.SetIsUsingWarmStart(false);
+
+	DFSPHSolver3 warm(1000.0, 0.1, 1.8);
+	warm.GetSPHSystemData()->AddParticles(points);
+	warm.SetCollider(RigidBodyCollider3::Builder().WithSurface(box).MakeShared());
+
+	unsigned int coldIterations = 0;
+	unsigned int warmIterations = 0;
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 30; ++frame)
+	{
+		cold.Update(frame);
+		warm.Update(frame);
+
+		if (frame.index >= 20)
+		{
+			coldIterations += cold.GetLastNumberOfDensityIterations();
+			warmIterations += warm.GetLastNumberOfDensityIterations();
+		}
+	}
+
+	// The column settles, and both keep the density near the target.
+	auto particles = warm.GetSPHSystemData();
+	auto d = particles->GetDensities();
+	auto x = particles->GetPositions();
+
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		EXPECT_LT(d[i], 1.1 * particles->GetTargetDensity());
+		EXPECT_GT(x[i].y, 0.0);
+		EXPECT_LT(x[i].y, 0.9);
+	}
+
+	EXPECT_LE(warmIterations, coldIterations);
+}
+
+TEST(DFSPHSolver3, UnsupportedModes)
+{
+	Array1<Vector3D> points;
+	for (size_t i = 0; i < 4; ++i)
+	{
+		points.Append(Vector3D(0.1 * i + 0.05, 0.05, 0.05));
+	}
+
+	// The cell-tiled mode is ignored without changing the setting.
+	DFSPHSolver3 solver(1000.0, 0.1, 1.8);
+	solver.GetSPHSystemData()->AddParticles(points);
+	solver.SetIsUsingCellTiling(true);
+
+	Frame frame(0, 1.0 / 60.0);
+	solver.Update(frame++);
+	EXPECT_TRUE(solver.GetIsUsingCellTiling());
+	EXPECT_EQ(points.size(), solver.GetSPHSystemData()->GetNeighborLists().size());
+
+	// The adaptive kernel is rejected, and the shared data is left as is.
+	solver.GetSPHSystemData()->SetIsUsingAdaptiveKernel(true);
+	EXPECT_THROW(solver.Update(frame), std::invalid_argument);
+	EXPECT_TRUE(solver.GetSPHSystemData()->GetIsUsingAdaptiveKernel());
+}
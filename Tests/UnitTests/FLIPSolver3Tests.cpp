@@ -1,7 +1,12 @@
 #include "pch.h"
 
+#include <Core/Emitter/VolumeParticleEmitter3.h>
+#include <Core/Geometry/Plane3.h>
+#include <Core/PointGenerator/GridPointGenerator3.h>
 #include <Core/Solver/Hybrid/FLIP/FLIPSolver3.h>
 
+#include <algorithm>
+
 using namespace CubbyFlow;
 
 TEST(FLIPSolver3, Empty)
@@ -26,4 +31,100 @@ TEST(FLIPSolver3, PICBlendingFactor)
 
 	solver.SetPICBlendingFactor(-0.9);
 	EXPECT_EQ(0.0, solver.GetPICBlendingFactor());
-}
\ No newline at end of file
+}
+
+namespace
+{
+	bool IsInCell(const Vector3D& x, const Point3I& cell, double dx)
+	{
+		return static_cast<int>(std::floor(x.x / dx)) == cell.x &&
+			static_cast<int>(std::floor(x.y / dx)) == cell.y &&
+			static_cast<int>(std::floor(x.z / dx)) == cell.z;
+	}
+
+	size_t CountParticlesInCell(ConstArrayAccessor1<Vector3D> positions, const Point3I& cell, double dx)
+	{
+		return static_cast<size_t>(std::count_if(positions.begin(), positions.end(), [&](const Vector3D& x)
+		{
+			return IsInCell(x, cell, dx);
+		}));
+	}
+}
+
+TEST(FLIPSolver3, NarrowBand)
+{
+	const double dx = 1.0 / 16.0;
+	FLIPSolver3 solver({ 16, 16, 16 }, { dx, dx, dx }, { 0, 0, 0 });
+
+	// Without gravity the liquid stays at rest, so the particles are where
+	// the narrow band update left them.
+	solver.SetGravity(Vector3D());
+
+	EXPECT_FALSE(solver.GetIsUsingNarrowBand());
+	EXPECT_EQ(nullptr, solver.GetLevelSet());
+
+	solver.SetIsUsingNarrowBand(true);
+	solver.SetNarrowBandWidth(0.5);
+	EXPECT_TRUE(solver.GetIsUsingNarrowBand());
+	EXPECT_DOUBLE_EQ(1.0, solver.GetNarrowBandWidth());
+	solver.SetNarrowBandWidth(3.0);
+	EXPECT_NE(nullptr, solver.GetLevelSet());
+
+	// Liquid below y = 0.7 with 8 particles per cell.
+	auto plane = Plane3::Builder()
+		.WithNormal({ 0, 1, 0 })
+		.WithPoint({ 0, 0.7, 0 })
+		.MakeShared();
+
+	auto emitter = VolumeParticleEmitter3::Builder()
+		.WithSurface(plane)
+		.WithSpacing(0.5 * dx)
+		.WithMaxRegion(solver.GetGridSystemData()->GetBoundingBox())
+		.WithIsOneShot(true)
+		.MakeShared();
+	emitter->SetPointGenerator(std::make_shared<GridPointGenerator3>());
+	solver.SetParticleEmitter(emitter);
+
+	Frame frame(0, 1.0 / 60.0);
+	solver.Update(frame);
+
+	const double bandWidth = 3.0 * dx;
+	auto levelSet = solver.GetLevelSet();
+	auto particles = solver.GetParticleSystemData();
+	const auto positions = particles->GetPositions();
+
+	// The particles deeper than the band are removed, and the seeded ones
+	// lie in the cells whose center is within the band.
+	EXPECT_GT(positions.size(), 0u);
+	for (const Vector3D& x : positions)
+	{
+		EXPECT_GE(levelSet->Sample(x), -bandWidth - dx);
+	}
+	EXPECT_EQ(0u, CountParticlesInCell(positions, Point3I(8, 2, 8), dx));
+
+	// Empty a band cell two cells below the surface, which is seeded again
+	// with 8 particles in the next step.
+	const Point3I bandCell(8, 9, 8);
+	EXPECT_EQ(8u, CountParticlesInCell(positions, bandCell, dx));
+	Array1<char> isRemoved(particles->GetNumberOfParticles(), 0);
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		isRemoved[i] = IsInCell(positions[i], bandCell, dx) ? 1 : 0;
+	}
+	particles->RemoveParticles(isRemoved.ConstAccessor());
+
+	++frame;
+	solver.Update(frame);
+	EXPECT_EQ(8u, CountParticlesInCell(particles->GetPositions(), bandCell, dx));
+
+	// The level set and the fluid SDF stay negative in the deep liquid
+	// without particles, and positive above the surface.
+	const auto sdf = solver.GetSignedDistanceField();
+	for (const Vector3D& x : { Vector3D(0.5, 0.15, 0.5), Vector3D(0.3, 0.3, 0.7) })
+	{
+		EXPECT_LT(levelSet->Sample(x), -bandWidth);
+		EXPECT_LT(sdf->Sample(x), 0.0);
+	}
+	EXPECT_GT(levelSet->Sample(Vector3D(0.5, 0.9, 0.5)), 0.0);
+	EXPECT_GT(sdf->Sample(Vector3D(0.5, 0.9, 0.5)), 0.0);
+}
@@ -0,0 +1,48 @@
+#include "pch.h"
+
+#include <Core/Array/Array3.h>
+#include <Core/Math/FixedPoint.h>
+
+using namespace CubbyFlow;
+
+TEST(FixedPoint, Constructors)
+{
+	FixedPoint16 zero;
+	EXPECT_EQ(0u, zero.GetRawValue());
+	EXPECT_EQ(0.0f, static_cast<float>(zero));
+
+	FixedPoint16 one(1.0f);
+	EXPECT_EQ(65535u, one.GetRawValue());
+	EXPECT_EQ(1.0f, static_cast<float>(one));
+
+	// Out-of-range values are clamped.
+	EXPECT_EQ(0.0f, static_cast<float>(FixedPoint16(-0.5f)));
+	EXPECT_EQ(1.0f, static_cast<float>(FixedPoint8(1.5f)));
+}
+
+TEST(FixedPoint, Precision)
+{
+	for (int i = 0; i <= 100; ++i)
+	{
+		const float value = 0.01f * static_cast<float>(i);
+
+		EXPECT_NEAR(value, static_cast<float>(FixedPoint8(value)), 0.5f * FixedPoint8::Epsilon() + 1e-6f);
+		EXPECT_NEAR(value, static_cast<float>(FixedPoint16(value)), 0.5f * FixedPoint16::Epsilon() + 1e-6f);
+	}
+
+	EXPECT_EQ(1u, sizeof(FixedPoint8));
+	EXPECT_EQ(2u, sizeof(FixedPoint16));
+}
+
+TEST(FixedPoint, Array)
+{
+	Array3<FixedPoint16> weights(4, 3, 2);
+	weights.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_EQ(0.0f, static_cast<float>(weights(i, j, k)));
+	});
+
+	weights(1, 2, 1) = 0.25f;
+	EXPECT_NEAR(0.25f, weights(1, 2, 1), FixedPoint16::Epsilon());
+	EXPECT_NEAR(0.75, 1.0 - weights(1, 2, 1), FixedPoint16::Epsilon());
+}
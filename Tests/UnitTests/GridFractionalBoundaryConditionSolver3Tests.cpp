@@ -1,6 +1,10 @@
 #include "pch.h"
 
+#include <Core/Collider/RigidBodyCollider3.h>
+#include <Core/Geometry/Sphere3.h>
+#include <Core/LevelSet/LevelSetUtils.h>
 #include <Core/Solver/Grid/GridFractionalBoundaryConditionSolver3.h>
+#include <Core/Surface/SurfaceToImplicit3.h>
 
 using namespace CubbyFlow;
 
@@ -106,4 +110,102 @@ TEST(GridFractionalBoundaryConditionSolver3, OpenDomain)
 			EXPECT_DOUBLE_EQ(1.0, velocity.GetW(i, j, k));
 		}
 	});
-}
\ No newline at end of file
+}
+
+TEST(GridFractionalBoundaryConditionSolver3, MovingCollider)
+{
+	GridFractionalBoundaryConditionSolver3 bndSolver;
+	bndSolver.SetIsCachingColliderSDF(true);
+	Size3 gridSize(32, 32, 32);
+	Vector3D gridSpacing(1.0 / 32.0, 1.0 / 32.0, 1.0 / 32.0);
+	Vector3D gridOrigin;
+
+	auto sphere = Sphere3::Builder()
+		.WithCenter({ 0.0, 0.0, 0.0 })
+		.WithRadius(0.15)
+		.WithTranslation({ 0.3, 0.5, 0.5 })
+		.MakeShared();
+	auto collider = RigidBodyCollider3::Builder().WithSurface(sphere).MakeShared();
+	SurfaceToImplicit3 implicitSphere(sphere);
+
+	bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+	auto sdf = std::dynamic_pointer_cast<CellCenteredScalarGrid3>(bndSolver.GetColliderSDF());
+	ASSERT_NE(nullptr, sdf);
+
+	// Static collider keeps the exact distances.
+	bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+	sdf->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		Vector3D pt = sdf->GetDataPosition()(i, j, k);
+		EXPECT_NEAR(implicitSphere.SignedDistance(pt), (*sdf)(i, j, k), 1e-12);
+	});
+
+	// Moving collider is resampled from the cache around the sphere, and the
+	// distances elsewhere are off by no more than the distance moved.
+	for (int step = 1; step <= 10; ++step)
+	{
+		sphere->transform.SetTranslation({ 0.3 + 0.01 * step, 0.5, 0.5 });
+		sphere->transform.SetOrientation(QuaternionD({ 0, 0, 1 }, 0.1 * step));
+		bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+
+		sdf->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+		{
+			Vector3D pt = sdf->GetDataPosition()(i, j, k);
+			double expected = implicitSphere.SignedDistance(pt);
+
+			if (std::fabs(expected) < 0.1)
+			{
+				EXPECT_NEAR(expected, (*sdf)(i, j, k), 0.01);
+
+				// Interpolation may flip the sign only right at the surface.
+				if (std::fabs(expected) > 0.005)
+				{
+					EXPECT_EQ(IsInsideSDF(expected), IsInsideSDF((*sdf)(i, j, k)));
+				}
+			}
+			else
+			{
+				EXPECT_NEAR(expected, (*sdf)(i, j, k), 0.01 * step + 0.01);
+			}
+		});
+	}
+
+	// Changing the shape in place requires an explicit invalidation.
+	sphere->radius = 0.2;
+	bndSolver.InvalidateColliderSDF();
+	bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+	sdf->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		Vector3D pt = sdf->GetDataPosition()(i, j, k);
+		EXPECT_NEAR(implicitSphere.SignedDistance(pt), (*sdf)(i, j, k), 1e-12);
+	});
+}
+
+TEST(GridFractionalBoundaryConditionSolver3, ColliderEditedInPlace)
+{
+	GridFractionalBoundaryConditionSolver3 bndSolver;
+	Size3 gridSize(16, 16, 16);
+	Vector3D gridSpacing(1.0 / 16.0, 1.0 / 16.0, 1.0 / 16.0);
+	Vector3D gridOrigin;
+
+	auto sphere = Sphere3::Builder()
+		.WithCenter({ 0.5, 0.5, 0.5 })
+		.WithRadius(0.15)
+		.MakeShared();
+	auto collider = RigidBodyCollider3::Builder().WithSurface(sphere).MakeShared();
+	SurfaceToImplicit3 implicitSphere(sphere);
+
+	bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+	auto sdf = std::dynamic_pointer_cast<CellCenteredScalarGrid3>(bndSolver.GetColliderSDF());
+	ASSERT_NE(nullptr, sdf);
+
+	// Without caching, a shape changed in place is picked up by the next update.
+	EXPECT_FALSE(bndSolver.GetIsCachingColliderSDF());
+	sphere->radius = 0.2;
+	bndSolver.UpdateCollider(collider, gridSize, gridSpacing, gridOrigin);
+	sdf->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		Vector3D pt = sdf->GetDataPosition()(i, j, k);
+		EXPECT_NEAR(implicitSphere.SignedDistance(pt), (*sdf)(i, j, k), 1e-12);
+	});
+}
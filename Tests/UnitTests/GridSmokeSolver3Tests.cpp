@@ -0,0 +1,147 @@
+#include "pch.h"
+
+#include <Core/Emitter/VolumeGridEmitter3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/Geometry/Sphere3.h>
+#include <Core/Solver/Grid/GridSmokeSolver3.h>
+
+using namespace CubbyFlow;
+
+namespace
+{
+	GridSmokeSolver3Ptr MakeRisingSmokeSolver()
+	{
+		auto solver = GridSmokeSolver3::Builder()
+			.WithResolution({ 24, 24, 24 })
+			.WithGridSpacing(1.0 / 24.0)
+			.MakeShared();
+		solver->SetUseCompressedLinearSystem(true);
+
+		auto box = Box3::Builder()
+			.WithLowerCorner({ 0.45, 0.0, 0.45 })
+			.WithUpperCorner({ 0.55, 0.1, 0.55 })
+			.MakeShared();
+
+		auto emitter = VolumeGridEmitter3::Builder()
+			.WithSourceRegion(box)
+			.WithIsOneShot(false)
+			.MakeShared();
+		emitter->AddStepFunctionTarget(solver->GetSmokeDensity(), 0.0, 1.0);
+		emitter->AddStepFunctionTarget(solver->GetTemperature(), 0.0, 1.0);
+		solver->SetEmitter(emitter);
+
+		return solver;
+	}
+}
+
+TEST(GridSmokeSolver3, ActiveRegion)
+{
+	auto fullSolver = MakeRisingSmokeSolver();
+	auto activeSolver = MakeRisingSmokeSolver();
+	activeSolver->SetIsUsingActiveRegion(true);
+	activeSolver->SetActiveRegionBrickSize(4);
+
+	EXPECT_TRUE(activeSolver->GetIsUsingActiveRegion());
+	EXPECT_EQ(4u, activeSolver->GetActiveRegionBrickSize());
+	EXPECT_DOUBLE_EQ(0.001, activeSolver->GetActiveRegionThreshold());
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 10; ++frame)
+	{
+		fullSolver->Update(frame);
+		activeSolver->Update(frame);
+	}
+
+	// The smoke rises from the source, so most of the domain stays inactive.
+	EXPECT_EQ(24u * 24u * 24u, fullSolver->GetNumberOfActiveCells());
+	EXPECT_LT(activeSolver->GetNumberOfActiveCells(), 24u * 24u * 24u / 2);
+	EXPECT_GT(activeSolver->GetNumberOfActiveCells(), 0u);
+
+	auto fullDensity = fullSolver->GetSmokeDensity();
+	auto activeDensity = activeSolver->GetSmokeDensity();
+
+	double fullMass = 0.0;
+	double activeMass = 0.0;
+	fullDensity->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		fullMass += (*fullDensity)(i, j, k);
+		activeMass += (*activeDensity)(i, j, k);
+	});
+
+	EXPECT_GT(fullMass, 0.0);
+	EXPECT_NEAR(fullMass, activeMass, 0.05 * fullMass);
+
+	// The smoke has risen in both simulations.
+	auto fullVelocity = fullSolver->GetVelocity();
+	auto activeVelocity = activeSolver->GetVelocity();
+	const Vector3D pt(0.5, 0.3, 0.5);
+	EXPECT_GT(fullVelocity->Sample(pt).y, 0.0);
+	EXPECT_NEAR(fullVelocity->Sample(pt).y, activeVelocity->Sample(pt).y, 0.2 * fullVelocity->Sample(pt).y);
+}
+
+TEST(GridSmokeSolver3, AutoResize)
+{
+	auto solver = GridSmokeSolver3::Builder()
+		.WithResolution({ 16, 16, 16 })
+		.WithGridSpacing(1.0 / 16.0)
+		.MakeShared();
+	solver->SetIsUsingAutoResize(true);
+	solver->SetDomainBrickSize(4);
+	solver->SetMaxResolution({ 16, 18, 16 });
+
+	auto box = Box3::Builder()
+		.WithLowerCorner({ 0.45, 0.7, 0.45 })
+		.WithUpperCorner({ 0.55, 0.8, 0.55 })
+		.MakeShared();
+
+	auto emitter = VolumeGridEmitter3::Builder()
+		.WithSourceRegion(box)
+		.WithIsOneShot(false)
+		.MakeShared();
+	emitter->AddStepFunctionTarget(solver->GetSmokeDensity(), 0.0, 1.0);
+	solver->SetEmitter(emitter);
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 5; ++frame)
+	{
+		solver->Update(frame);
+	}
+
+	// The domain grows upward only, up to the max resolution.
+	EXPECT_EQ(Size3(16, 18, 16), solver->GetResolution());
+	EXPECT_EQ(Vector3D(0.0, 0.0, 0.0), solver->GetGridOrigin());
+	EXPECT_EQ(Size3(16, 18, 16), solver->GetSmokeDensity()->Resolution());
+
+	double mass = 0.0;
+	auto density = solver->GetSmokeDensity();
+	density->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		mass += (*density)(i, j, k);
+	});
+	EXPECT_GT(mass, 0.0);
+}
+
+TEST(GridSmokeSolver3, MovingWindow)
+{
+	auto solver = GridSmokeSolver3::Builder()
+		.WithResolution({ 16, 16, 16 })
+		.WithGridSpacing(1.0 / 16.0)
+		.MakeShared();
+	solver->SetDomainBrickSize(4);
+
+	auto target = Sphere3::Builder()
+		.WithCenter({ 2.0, 0.5, 0.5 })
+		.WithRadius(0.1)
+		.MakeShared();
+	solver->SetMovingWindowTarget(target);
+
+	solver->Update(Frame(0, 1.0 / 60.0));
+
+	// 1.5 units toward the target are 24 cells, which are 6 bricks.
+	EXPECT_EQ(Size3(16, 16, 16), solver->GetResolution());
+	EXPECT_EQ(Vector3D(1.5, 0.0, 0.0), solver->GetGridOrigin());
+	EXPECT_EQ(Vector3D(1.5, 0.0, 0.0), solver->GetSmokeDensity()->Origin());
+
+	// Stays within a brick of the target.
+	target->center = Vector3D(2.1, 0.5, 0.5);
+	solver->Update(Frame(1, 1.0 / 60.0));
+	EXPECT_EQ(Vector3D(1.5, 0.0, 0.0), solver->GetGridOrigin());
+}
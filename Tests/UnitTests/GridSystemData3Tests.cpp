@@ -178,4 +178,73 @@ TEST(GridSystemData3, Serialize)
 	{
 		EXPECT_EQ(velocity->GetW(i, j, k), velocity2->GetW(i, j, k));
 	});
-}
\ No newline at end of file
+}
+
+TEST(GridSystemData3, ResizeAndShift)
+{
+	GridSystemData3 grids({ 8, 6, 4 }, { 0.5, 0.5, 0.5 }, { 1.0, 2.0, 3.0 });
+
+	size_t scalarIdx = grids.AddAdvectableScalarData(std::make_shared<CellCenteredScalarGrid3::Builder>());
+	size_t vectorIdx = grids.AddVectorData(std::make_shared<VertexCenteredVectorGrid3::Builder>());
+
+	auto scalar = grids.GetAdvectableScalarDataAt(scalarIdx);
+	auto vector = std::dynamic_pointer_cast<VertexCenteredVectorGrid3>(grids.GetVectorDataAt(vectorIdx));
+	auto velocity = grids.GetVelocity();
+
+	const auto scalarFunc = [](const Vector3D& pt)
+	{
+		return pt.x + 10.0 * pt.y + 100.0 * pt.z;
+	};
+	const auto vectorFunc = [](const Vector3D& pt)
+	{
+		return Vector3D(pt.z, pt.x, pt.y);
+	};
+
+	scalar->Fill(scalarFunc);
+	vector->Fill(vectorFunc);
+	velocity->Fill(vectorFunc);
+
+	grids.ResizeAndShift({ 12, 6, 5 }, { -2, 1, 0 });
+
+	EXPECT_EQ(Size3(12, 6, 5), grids.GetResolution());
+	EXPECT_EQ(Vector3D(0.0, 2.5, 3.0), grids.GetOrigin());
+	EXPECT_EQ(Vector3D(0.5, 0.5, 0.5), grids.GetGridSpacing());
+	EXPECT_EQ(Size3(12, 6, 5), scalar->Resolution());
+	EXPECT_EQ(Vector3D(0.0, 2.5, 3.0), velocity->Origin());
+
+	// The data in the overlapping region stay at the same positions.
+	const BoundingBox3D oldDomain(Vector3D(1.0, 2.0, 3.0), Vector3D(5.0, 5.0, 5.0));
+	auto scalarPos = scalar->GetDataPosition();
+	scalar->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		const Vector3D pt = scalarPos(i, j, k);
+		if (oldDomain.Contains(pt))
+		{
+			EXPECT_DOUBLE_EQ(scalarFunc(pt), (*scalar)(i, j, k));
+		}
+		else
+		{
+			EXPECT_EQ(0.0, (*scalar)(i, j, k));
+		}
+	});
+
+	auto vectorPos = vector->GetDataPosition();
+	vector->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		const Vector3D pt = vectorPos(i, j, k);
+		if (oldDomain.Contains(pt))
+		{
+			EXPECT_EQ(vectorFunc(pt), (*vector)(i, j, k));
+		}
+	});
+
+	auto uPos = velocity->GetUPosition();
+	velocity->ForEachUIndex([&](size_t i, size_t j, size_t k)
+	{
+		const Vector3D pt = uPos(i, j, k);
+		if (oldDomain.Contains(pt))
+		{
+			EXPECT_DOUBLE_EQ(pt.z, velocity->GetU(i, j, k));
+		}
+	});
+}
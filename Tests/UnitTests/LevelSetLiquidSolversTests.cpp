@@ -1,6 +1,7 @@
 #include "pch.h"
 
 #include <Core/Geometry/Sphere2.h>
+#include <Core/Animation/Frame.h>
 #include <Core/Geometry/Sphere3.h>
 #include <Core/Size/Size2.h>
 #include <Core/Size/Size3.h>
@@ -67,4 +68,35 @@ TEST(LevelSetLiquidSolver3, ComputeVolume)
 	const double ans = 4.0 / 3.0 * Cubic(radius) * PI_DOUBLE;
 
 	EXPECT_NEAR(ans, volume, 0.001);
+}
+
+TEST(LevelSetLiquidSolver3, AutoResize)
+{
+	LevelSetLiquidSolver3 solver;
+	solver.SetGravity(Vector3D());
+	solver.SetIsUsingAutoResize(true);
+	solver.SetDomainBrickSize(4);
+	solver.SetMaxResolution(Size3(32, 32, 32));
+
+	auto data = solver.GetGridSystemData();
+	double dx = 1.0 / 16.0;
+	data->Resize(Size3(16, 16, 16), Vector3D(dx, dx, dx), Vector3D());
+
+	// Liquid away from the boundary, while its SDF is non-zero everywhere.
+	ImplicitSurfaceSet3 surfaceSet;
+	surfaceSet.AddExplicitSurface(std::make_shared<Sphere3>(data->GetBoundingBox().MidPoint(), 0.15));
+
+	auto sdf = solver.GetSignedDistanceField();
+	sdf->Fill([&](const Vector3D& x)
+	{
+		return surfaceSet.SignedDistance(x);
+	});
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 2; ++frame)
+	{
+		solver.Update(frame);
+	}
+
+	EXPECT_EQ(Size3(16, 16, 16), solver.GetResolution());
+	EXPECT_EQ(Vector3D(), solver.GetGridOrigin());
 }
\ No newline at end of file
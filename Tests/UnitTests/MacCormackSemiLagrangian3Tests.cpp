@@ -0,0 +1,77 @@
+#include "pch.h"
+
+#include <Core/Field/ConstantVectorField3.h>
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/Grid/FaceCenteredGrid3.h>
+#include <Core/SemiLagrangian/MacCormackSemiLagrangian3.h>
+
+using namespace CubbyFlow;
+
+namespace
+{
+	double Blob(const Vector3D& pt, const Vector3D& center)
+	{
+		return std::exp(-pt.DistanceSquaredTo(center) / Square(0.1));
+	}
+
+	double AdvectBlob(AdvectionSolver3* solver)
+	{
+		CellCenteredScalarGrid3 grid(32, 32, 32, 1.0 / 32.0, 1.0 / 32.0, 1.0 / 32.0);
+		grid.Fill([](const Vector3D& pt) { return Blob(pt, Vector3D(0.3, 0.5, 0.5)); });
+
+		ConstantVectorField3 flow(Vector3D(1.0, 0.0, 0.0));
+		for (int n = 0; n < 10; ++n)
+		{
+			auto grid0 = grid.Clone();
+			solver->Advect(*grid0, flow, 0.02, &grid);
+		}
+
+		// The solution stays within the range of the initial values.
+		double error = 0.0;
+		auto pos = grid.GetDataPosition();
+		grid.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+		{
+			EXPECT_GE(grid(i, j, k), 0.0);
+			EXPECT_LE(grid(i, j, k), 1.0);
+			error += std::fabs(grid(i, j, k) - Blob(pos(i, j, k), Vector3D(0.5, 0.5, 0.5)));
+		});
+
+		return error;
+	}
+}
+
+TEST(MacCormackSemiLagrangian3, AdvectScalar)
+{
+	SemiLagrangian3 semiLagrangian;
+	MacCormackSemiLagrangian3 macCormack;
+
+	const double semiLagrangianError = AdvectBlob(&semiLagrangian);
+	const double macCormackError = AdvectBlob(&macCormack);
+
+	EXPECT_LT(macCormackError, 0.5 * semiLagrangianError);
+}
+
+TEST(MacCormackSemiLagrangian3, AdvectFaceCentered)
+{
+	FaceCenteredGrid3 input(16, 16, 16, 1.0 / 16.0, 1.0 / 16.0, 1.0 / 16.0);
+	input.Fill([](const Vector3D& pt) { return Vector3D(pt.y, 0.5, 0.0); });
+	FaceCenteredGrid3 output(input);
+
+	ConstantVectorField3 flow(Vector3D(0.0, 0.0, 1.0));
+	MacCormackSemiLagrangian3 solver;
+	solver.Advect(input, flow, 0.05, &output);
+
+	// The fields are constant along the flow, so they are advected exactly.
+	input.ForEachUIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_NEAR(input.GetU(i, j, k), output.GetU(i, j, k), 1e-12);
+	});
+	input.ForEachVIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_NEAR(0.5, output.GetV(i, j, k), 1e-12);
+	});
+	input.ForEachWIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_NEAR(0.0, output.GetW(i, j, k), 1e-12);
+	});
+}
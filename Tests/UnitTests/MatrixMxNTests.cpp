@@ -487,4 +487,58 @@ TEST(MatrixMxN, Builders)
 			EXPECT_EQ(0.0, mat[i]);
 		}
 	}
-}
\ No newline at end of file
+}
+
+TEST(MatrixMxN, BlockedProducts)
+{
+	// Sizes past the lazy-evaluation threshold with partial register blocks
+	const size_t m = 70, k = 300, n = 45;
+	MatrixMxND matA(m, k), matB(k, n);
+	matA.ForEachIndex([&](size_t i, size_t j) { matA(i, j) = static_cast<double>((i * 7 + j * 3) % 11) - 5.0; });
+	matB.ForEachIndex([&](size_t i, size_t j) { matB(i, j) = static_cast<double>((i * 5 + j * 13) % 9) - 4.0; });
+
+	MatrixMxND matC = matA * matB;
+	EXPECT_EQ(m, matC.Rows());
+	EXPECT_EQ(n, matC.Cols());
+
+	MatrixMxND matD = (2.0 * matA) * matB;
+
+	for (size_t i = 0; i < m; ++i)
+	{
+		for (size_t j = 0; j < n; ++j)
+		{
+			double ans = 0.0;
+			for (size_t p = 0; p < k; ++p)
+			{
+				ans += matA(i, p) * matB(p, j);
+			}
+
+			EXPECT_EQ(ans, matC(i, j));
+			EXPECT_EQ(2.0 * ans, matD(i, j));
+		}
+	}
+
+	// The operand may be the destination
+	MatrixMxND matE = matA.Transposed() * matA;
+	MatrixMxND matF = matA.Transposed();
+	matF = matF * matA;
+	EXPECT_TRUE(matE.IsEqual(matF));
+
+	// Non-square matrix-vector product
+	VectorND x(k);
+	x.ForEachIndex([&](size_t i) { x[i] = static_cast<double>(i % 7) - 3.0; });
+
+	VectorND y = matA * x;
+	EXPECT_EQ(m, y.size());
+
+	for (size_t i = 0; i < m; ++i)
+	{
+		double ans = 0.0;
+		for (size_t p = 0; p < k; ++p)
+		{
+			ans += matA(i, p) * x[p];
+		}
+
+		EXPECT_EQ(ans, y[i]);
+	}
+}
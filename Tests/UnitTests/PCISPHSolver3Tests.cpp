@@ -25,4 +25,42 @@ TEST(PCISPHSolver3, Parameters)
 
 	solver.SetMaxNumberOfIterations(10);
 	EXPECT_DOUBLE_EQ(10, solver.GetMaxNumberOfIterations());
-}
\ No newline at end of file
+}
+
+TEST(PCISPHSolver3, CellTiling)
+{
+	Array1<Vector3D> points;
+	for (size_t k = 0; k < 6; ++k)
+	{
+		for (size_t j = 0; j < 6; ++j)
+		{
+			for (size_t i = 0; i < 6; ++i)
+			{
+				points.Append(Vector3D(0.05 * i + 0.005 * (j % 3), 0.05 * j, 0.05 * k + 0.005 * (i % 2)));
+			}
+		}
+	}
+
+	PCISPHSolver3 reference(1000.0, 0.05, 1.8);
+	reference.GetSPHSystemData()->AddParticles(points);
+
+	PCISPHSolver3 solver(1000.0, 0.05, 1.8);
+	solver.GetSPHSystemData()->AddParticles(points);
+	solver.SetIsUsingCellTiling(true);
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 3; ++frame)
+	{
+		reference.Update(frame);
+		solver.Update(frame);
+	}
+
+	auto x0 = reference.GetSPHSystemData()->GetPositions();
+	auto x1 = solver.GetSPHSystemData()->GetPositions();
+
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		EXPECT_NEAR(x0[i].x, x1[i].x, 1e-8);
+		EXPECT_NEAR(x0[i].y, x1[i].y, 1e-8);
+		EXPECT_NEAR(x0[i].z, x1[i].z, 1e-8);
+	}
+}
@@ -1,6 +1,14 @@
 #include "pch.h"
 
+#include <Core/Emitter/VolumeParticleEmitter3.h>
+#include <Core/Geometry/Box3.h>
+#include <Core/PointGenerator/GridPointGenerator3.h>
+#include <Core/Solver/Hybrid/APIC/APICSolver3.h>
+#include <Core/Solver/Hybrid/FLIP/FLIPSolver3.h>
 #include <Core/Solver/Hybrid/PIC/PICSolver3.h>
+#include <Core/Utils/Parallel.h>
+
+#include <vector>
 
 using namespace CubbyFlow;
 
@@ -12,4 +20,263 @@ TEST(PICSolver3, UpdateEmpty)
 	{
 		solver.Update(frame);
 	}
-}
\ No newline at end of file
+}
+
+TEST(PICSolver3, Reseeding)
+{
+	auto solver = PICSolver3::Builder()
+		.WithResolution({ 8, 8, 8 })
+		.WithDomainSizeX(1.0)
+		.MakeShared();
+
+	EXPECT_FALSE(solver->GetIsUsingReseeding());
+	EXPECT_EQ(4u, solver->GetMinParticlesPerCell());
+	EXPECT_EQ(16u, solver->GetMaxParticlesPerCell());
+
+	solver->SetIsUsingReseeding(true);
+	solver->SetMaxParticlesPerCell(2);
+	EXPECT_EQ(4u, solver->GetMaxParticlesPerCell());
+	solver->SetMinParticlesPerCell(8);
+	EXPECT_EQ(8u, solver->GetMaxParticlesPerCell());
+	solver->SetMaxParticlesPerCell(10);
+	EXPECT_EQ(10u, solver->GetMaxParticlesPerCell());
+	solver->SetMinParticlesPerCell(1);
+	EXPECT_EQ(1u, solver->GetMinParticlesPerCell());
+	EXPECT_EQ(10u, solver->GetMaxParticlesPerCell());
+}
+
+namespace
+{
+	// Block of 4 x 4 x 4 cells with 8 particles each, and 40 more particles
+	// crowding one of its cells. Without gravity the particles stay at rest,
+	// so they are where the reseeding left them.
+	std::vector<Vector3D> ReseedFirstStep(size_t minParticlesPerCell, size_t maxParticlesPerCell)
+	{
+		const double dx = 1.0 / 8.0;
+		PICSolver3 solver({ 8, 8, 8 }, { dx, dx, dx }, { 0, 0, 0 });
+		solver.SetGravity(Vector3D());
+		solver.SetIsUsingReseeding(true);
+		solver.SetMaxParticlesPerCell(maxParticlesPerCell);
+		solver.SetMinParticlesPerCell(minParticlesPerCell);
+
+		Array1<Vector3D> positions;
+		for (size_t k = 4; k < 12; ++k)
+		{
+			for (size_t j = 4; j < 12; ++j)
+			{
+				for (size_t i = 4; i < 12; ++i)
+				{
+					positions.Append(0.5 * dx * Vector3D(i + 0.5, j + 0.5, k + 0.5));
+				}
+			}
+		}
+		for (size_t n = 0; n < 40; ++n)
+		{
+			const double t = (static_cast<double>(n) + 0.5) / 40.0;
+			positions.Append(Vector3D(3.0 + t, 3.5 + 0.5 * t, 3.5 - 0.5 * t) * dx);
+		}
+		solver.GetParticleSystemData()->AddParticles(positions.ConstAccessor());
+
+		solver.Update(Frame(0, 1.0 / 60.0));
+
+		const auto result = solver.GetParticleSystemData()->GetPositions();
+		return std::vector<Vector3D>(result.begin(), result.end());
+	}
+}
+
+TEST(PICSolver3, ReseedingBounds)
+{
+	const double dx = 1.0 / 8.0;
+	const std::vector<Vector3D> positions = ReseedFirstStep(12, 16);
+
+	Array3<size_t> counts(8, 8, 8, 0);
+	for (const Vector3D& x : positions)
+	{
+		++counts(static_cast<size_t>(x.x / dx), static_cast<size_t>(x.y / dx), static_cast<size_t>(x.z / dx));
+	}
+
+	// The crowded cell is trimmed to the max, and the cells inside of the
+	// liquid are filled up to the min.
+	EXPECT_EQ(16u, counts(3, 3, 3));
+	counts.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_LE(counts(i, j, k), 16u) << i << ", " << j << ", " << k;
+
+		if (i >= 3 && i < 5 && j >= 3 && j < 5 && k >= 3 && k < 5)
+		{
+			EXPECT_GE(counts(i, j, k), 12u) << i << ", " << j << ", " << k;
+		}
+	});
+
+	// The same step seeds the same particles with any number of threads.
+	const unsigned int numThreads = GetMaxNumberOfThreads();
+	SetMaxNumberOfThreads(1);
+	const std::vector<Vector3D> serialPositions = ReseedFirstStep(12, 16);
+	SetMaxNumberOfThreads(numThreads);
+
+	EXPECT_EQ(positions, serialPositions);
+	EXPECT_EQ(positions, ReseedFirstStep(12, 16));
+}
+
+TEST(PICSolver3, ReseedingWithNarrowBand)
+{
+	const double dx = 1.0 / 16.0;
+	PICSolver3 solver({ 16, 16, 16 }, { dx, dx, dx }, { 0, 0, 0 });
+	solver.SetGravity(Vector3D());
+	solver.SetIsUsingNarrowBand(true);
+	solver.SetNarrowBandWidth(3.0);
+	solver.SetIsUsingReseeding(true);
+	solver.SetMaxParticlesPerCell(16);
+	solver.SetMinParticlesPerCell(12);
+
+	// Liquid below y = 0.7 with 8 particles per cell.
+	auto box = Box3::Builder()
+		.WithLowerCorner({ 0, 0, 0 })
+		.WithUpperCorner({ 1, 0.7, 1 })
+		.MakeShared();
+
+	auto emitter = VolumeParticleEmitter3::Builder()
+		.WithSurface(box)
+		.WithSpacing(0.5 * dx)
+		.WithMaxRegion(solver.GetGridSystemData()->GetBoundingBox())
+		.WithIsOneShot(true)
+		.MakeShared();
+	emitter->SetPointGenerator(std::make_shared<GridPointGenerator3>());
+	solver.SetParticleEmitter(emitter);
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 2; ++frame)
+	{
+		solver.Update(frame);
+	}
+
+	// The interior emptied by the band is not filled again, while the cells
+	// within the band are. The band cells are seeded at their centers, so
+	// their particles may lie up to a cell deeper.
+	const double bandWidth = 3.0 * dx;
+	auto levelSet = solver.GetLevelSet();
+	const auto positions = solver.GetParticleSystemData()->GetPositions();
+	EXPECT_GT(positions.size(), 0u);
+
+	const auto toCell = [&](double x)
+	{
+		return std::min(static_cast<size_t>(x / dx), static_cast<size_t>(15));
+	};
+
+	Array3<size_t> counts(16, 16, 16, 0);
+	for (const Vector3D& x : positions)
+	{
+		EXPECT_GE(levelSet->Sample(x), -bandWidth - dx);
+		++counts(toCell(x.x), toCell(x.y), toCell(x.z));
+	}
+	EXPECT_EQ(0u, counts(8, 2, 8));
+	EXPECT_GT(counts(8, 9, 8), 8u);
+}
+
+TEST(PICSolver3, SignedDistanceField)
+{
+	auto solver = PICSolver3::Builder()
+		.WithResolution({ 12, 12, 12 })
+		.WithDomainSizeX(1.0)
+		.MakeShared();
+
+	auto particles = solver->GetParticleSystemData();
+	Array1<Vector3D> positions({
+		Vector3D(0.3, 0.5, 0.5), Vector3D(0.52, 0.47, 0.61),
+		Vector3D(0.71, 0.6, 0.33), Vector3D(0.5, 0.8, 0.5) });
+	particles->AddParticles(positions.ConstAccessor());
+
+	solver->Update(Frame(0, 1.0 / 60.0));
+
+	// The field is built from the positions at the beginning of the step.
+	auto sdf = solver->GetSignedDistanceField();
+	const double maxH = sdf->GridSpacing().x;
+	const double radius = 1.2 * maxH / std::sqrt(2.0);
+	const double sdfBandRadius = 2.0 * radius;
+	auto sdfPos = sdf->GetDataPosition();
+
+	sdf->ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		double minDist = sdfBandRadius;
+		for (size_t n = 0; n < positions.size(); ++n)
+		{
+			minDist = std::min(minDist, sdfPos(i, j, k).DistanceTo(positions[n]));
+		}
+
+		EXPECT_NEAR(minDist - radius, (*sdf)(i, j, k), 1e-9);
+	});
+}
+
+namespace
+{
+	// Runs a small dam breaking and returns the grid velocities followed by
+	// the particle positions and velocities.
+	template <typename Solver>
+	std::vector<double> SimulateDamBreaking(unsigned int numberOfThreads)
+	{
+		const unsigned int numThreads = GetMaxNumberOfThreads();
+		SetMaxNumberOfThreads(numberOfThreads);
+
+		const double dx = 1.0 / 16.0;
+		Solver solver({ 16, 16, 16 }, { dx, dx, dx }, { 0, 0, 0 });
+
+		auto box = Box3::Builder()
+			.WithLowerCorner({ 0, 0, 0 })
+			.WithUpperCorner({ 0.3, 0.6, 1.0 })
+			.MakeShared();
+
+		auto emitter = VolumeParticleEmitter3::Builder()
+			.WithSurface(box)
+			.WithSpacing(0.5 * dx)
+			.WithMaxRegion(solver.GetGridSystemData()->GetBoundingBox())
+			.WithIsOneShot(true)
+			.MakeShared();
+		emitter->SetPointGenerator(std::make_shared<GridPointGenerator3>());
+		solver.SetParticleEmitter(emitter);
+
+		for (Frame frame(0, 1.0 / 60.0); frame.index < 3; ++frame)
+		{
+			solver.Update(frame);
+		}
+
+		std::vector<double> state;
+		auto flow = solver.GetGridSystemData()->GetVelocity();
+		for (const auto& data : { flow->GetUConstAccessor(), flow->GetVConstAccessor(), flow->GetWConstAccessor() })
+		{
+			state.insert(state.end(), data.data(), data.data() + data.size().x * data.size().y * data.size().z);
+		}
+
+		auto particles = solver.GetParticleSystemData();
+		for (const auto& data : { particles->GetPositions(), particles->GetVelocities() })
+		{
+			for (const Vector3D& value : data)
+			{
+				state.insert(state.end(), { value.x, value.y, value.z });
+			}
+		}
+
+		SetMaxNumberOfThreads(numThreads);
+
+		return state;
+	}
+}
+
+TEST(PICSolver3, NumberOfThreads)
+{
+	// The slab-ordered transfers and the deterministic reductions give the
+	// same bits with any number of threads.
+	SetIsDeterministic(true);
+
+	const std::vector<double> pic = SimulateDamBreaking<PICSolver3>(1);
+	const std::vector<double> flip = SimulateDamBreaking<FLIPSolver3>(1);
+	const std::vector<double> apic = SimulateDamBreaking<APICSolver3>(1);
+	EXPECT_FALSE(pic.empty());
+
+	for (unsigned int n : { 2u, 4u })
+	{
+		EXPECT_EQ(pic, SimulateDamBreaking<PICSolver3>(n));
+		EXPECT_EQ(flip, SimulateDamBreaking<FLIPSolver3>(n));
+		EXPECT_EQ(apic, SimulateDamBreaking<APICSolver3>(n));
+	}
+
+	SetIsDeterministic(false);
+}
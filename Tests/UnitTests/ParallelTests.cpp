@@ -4,6 +4,7 @@
 #include <Core/Array/Array3.h>
 #include <Core/Utils/Parallel.h>
 
+#include <mutex>
 #include <numeric>
 #include <random>
 
@@ -262,4 +263,118 @@ TEST(Parallel, Reduce)
 
 	int expected = std::accumulate(a.begin(), a.end(), 0);
 	EXPECT_EQ(expected, sum);
-}
\ No newline at end of file
+}
+
+TEST(Parallel, DeterministicReduce)
+{
+	const size_t N = 10 * DETERMINISTIC_REDUCE_CHUNK_SIZE + 17;
+	std::vector<double> a(N);
+
+	std::mt19937 rng;
+	std::uniform_real_distribution<> d(-1.0, 1.0);
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		a[i] = d(rng) * std::pow(10.0, static_cast<double>(i % 9));
+	}
+
+	const auto sum = [&]()
+	{
+		return ParallelReduce(ZERO_SIZE, a.size(), 0.0,
+			[&](size_t start, size_t end, double init)
+		{
+			double result = init;
+
+			for (size_t i = start; i < end; ++i)
+			{
+				result += a[i];
+			}
+
+			return result;
+		}, std::plus<double>());
+	};
+
+	// Partial sums of the fixed partitions, combined in index order.
+	double expected = 0.0;
+	for (size_t i = 0; i < N; i += DETERMINISTIC_REDUCE_CHUNK_SIZE)
+	{
+		double partial = 0.0;
+		for (size_t j = i; j < std::min(i + DETERMINISTIC_REDUCE_CHUNK_SIZE, N); ++j)
+		{
+			partial += a[j];
+		}
+
+		expected += partial;
+	}
+
+	const unsigned int numThreads = GetMaxNumberOfThreads();
+
+	EXPECT_FALSE(GetIsDeterministic());
+	SetIsDeterministic(true);
+	EXPECT_TRUE(GetIsDeterministic());
+
+	for (unsigned int n : { 1u, 3u, 8u })
+	{
+		SetMaxNumberOfThreads(n);
+		EXPECT_EQ(expected, sum());
+	}
+
+	SetMaxNumberOfThreads(numThreads);
+	SetIsDeterministic(false);
+}
+
+#if !defined(CUBBYFLOW_TASKING_TBB)
+TEST(Parallel, StaticPartition)
+{
+	const bool oldIsUsingThreadAffinity = GetIsUsingThreadAffinity();
+
+	for (bool isUsingThreadAffinity : { false, true })
+	{
+		SetIsUsingThreadAffinity(isUsingThreadAffinity);
+		EXPECT_EQ(isUsingThreadAffinity, GetIsUsingThreadAffinity());
+
+		for (size_t n : { size_t(1), size_t(7), size_t(1000), size_t(12345) })
+		{
+			std::mutex mutex;
+			std::vector<std::pair<size_t, size_t>> ranges;
+
+			ParallelRangeFor(ZERO_SIZE, n, [&](size_t start, size_t end)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				ranges.emplace_back(start, end);
+			});
+
+			// One contiguous slice per thread, balanced to within one index.
+			std::sort(ranges.begin(), ranges.end());
+			EXPECT_EQ(std::min<size_t>(n, GetMaxNumberOfThreads()), ranges.size());
+
+			size_t minSize = n, maxSize = 0, next = 0;
+			for (const auto& range : ranges)
+			{
+				EXPECT_EQ(next, range.first);
+				minSize = std::min(minSize, range.second - range.first);
+				maxSize = std::max(maxSize, range.second - range.first);
+				next = range.second;
+			}
+
+			EXPECT_EQ(n, next);
+			EXPECT_LE(maxSize - minSize, 1u);
+
+			std::vector<size_t> a(n, 0);
+			ParallelFor(ZERO_SIZE, n, [&](size_t i)
+			{
+				a[i] = i;
+			});
+
+			const size_t sum = ParallelReduce(ZERO_SIZE, n, ZERO_SIZE,
+				[&](size_t start, size_t end, size_t init)
+			{
+				return std::accumulate(a.begin() + start, a.begin() + end, init);
+			}, std::plus<size_t>());
+			EXPECT_EQ(n * (n - 1) / 2, sum);
+		}
+	}
+
+	SetIsUsingThreadAffinity(oldIsUsingThreadAffinity);
+}
+#endif
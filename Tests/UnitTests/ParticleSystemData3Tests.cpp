@@ -120,6 +120,38 @@ TEST(ParticleSystemData3, AddParticles)
 	EXPECT_EQ(Vector3D(2.0, 1.0, 3.0), f[13]);
 }
 
+TEST(ParticleSystemData3, RemoveParticles)
+{
+	ParticleSystemData3 particleSystem;
+	size_t idx = particleSystem.AddScalarData();
+
+	particleSystem.AddParticles(
+		Array1<Vector3D>({ Vector3D(1.0, 0.0, 0.0), Vector3D(2.0, 0.0, 0.0), Vector3D(3.0, 0.0, 0.0), Vector3D(4.0, 0.0, 0.0) }).Accessor(),
+		Array1<Vector3D>({ Vector3D(0.0, 1.0, 0.0), Vector3D(0.0, 2.0, 0.0), Vector3D(0.0, 3.0, 0.0), Vector3D(0.0, 4.0, 0.0) }).Accessor());
+
+	auto data = particleSystem.ScalarDataAt(idx);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		data[i] = static_cast<double>(i);
+	}
+
+	particleSystem.RemoveParticles(Array1<char>({ 1, 0, 1, 0 }).ConstAccessor());
+
+	EXPECT_EQ(2u, particleSystem.GetNumberOfParticles());
+	auto p = particleSystem.GetPositions();
+	auto v = particleSystem.GetVelocities();
+	data = particleSystem.ScalarDataAt(idx);
+
+	EXPECT_EQ(Vector3D(2.0, 0.0, 0.0), p[0]);
+	EXPECT_EQ(Vector3D(4.0, 0.0, 0.0), p[1]);
+	EXPECT_EQ(Vector3D(0.0, 2.0, 0.0), v[0]);
+	EXPECT_EQ(Vector3D(0.0, 4.0, 0.0), v[1]);
+	EXPECT_EQ(1.0, data[0]);
+	EXPECT_EQ(3.0, data[1]);
+
+	EXPECT_THROW(particleSystem.RemoveParticles(Array1<char>(3).ConstAccessor()), std::invalid_argument);
+}
+
 TEST(ParticleSystemData3, AddParticlesException) 
 {
 	ParticleSystemData3 particleSystem;
@@ -0,0 +1,207 @@
+#include "pch.h"
+
+#include <Core/Searcher/PointCompactHashGridSearcher3.h>
+#include <Core/Utils/Factory.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace CubbyFlow;
+
+TEST(PointCompactHashGridSearcher3, ForEachNearByPoint)
+{
+	Array1<Vector3D> points =
+	{
+		Vector3D(1, 1, 1),
+		Vector3D(3, 411, 5),
+		Vector3D(-1, 2, -3)
+	};
+
+	PointCompactHashGridSearcher3 searcher(std::sqrt(10));
+	searcher.Build(points.Accessor());
+
+	int cnt = 0;
+	searcher.ForEachNearbyPoint(
+		Vector3D(0, 0, 0), std::sqrt(15.0),
+		[&](size_t i, const Vector3D& pt)
+	{
+		EXPECT_TRUE(i == 0 || i == 2);
+		EXPECT_EQ(points[i], pt);
+
+		++cnt;
+	});
+
+	EXPECT_EQ(2, cnt);
+}
+
+TEST(PointCompactHashGridSearcher3, HasEachNearByPoint)
+{
+	Array1<Vector3D> points =
+	{
+		Vector3D(1, 142, 1),
+		Vector3D(3, 4123, 13),
+		Vector3D(4, 1, 25)
+	};
+
+	PointCompactHashGridSearcher3 searcher(std::sqrt(10));
+	searcher.Build(points.Accessor());
+
+	EXPECT_FALSE(searcher.HasNearbyPoint(Vector3D(), std::sqrt(15.0)));
+	EXPECT_TRUE(searcher.HasNearbyPoint(Vector3D(0, 140, 0), std::sqrt(15.0)));
+}
+
+TEST(PointCompactHashGridSearcher3, Build)
+{
+	// Points spread over a huge domain only allocate their own buckets.
+	Array1<Vector3D> points =
+	{
+		Vector3D(3, 41, 234),
+		Vector3D(-1e5, 1, 5),
+		Vector3D(-3, 123, 1e5),
+		Vector3D(3.5, 41, 234)
+	};
+
+	PointCompactHashGridSearcher3 searcher(2.0);
+	searcher.Build(points.Accessor());
+
+	EXPECT_EQ(3u, searcher.GetNumberOfOccupiedBuckets());
+	EXPECT_EQ(4u, searcher.SortedIndices().size());
+
+	EXPECT_EQ(0u, PointCompactHashGridSearcher3::GetMortonCode(Point3I(-(1 << 20), -(1 << 20), -(1 << 20))));
+	EXPECT_EQ(
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(0, 0, 0)) + 1,
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(1, 0, 0)));
+	EXPECT_EQ(
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(0, 0, 0)) + 2,
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(0, 1, 0)));
+	EXPECT_EQ(
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(0, 0, 0)) + 4,
+		PointCompactHashGridSearcher3::GetMortonCode(Point3I(0, 0, 1)));
+}
+
+TEST(PointCompactHashGridSearcher3, BuildOutOfRange)
+{
+	const double limit = static_cast<double>(1 << 20);
+
+	Array1<Vector3D> points =
+	{
+		Vector3D(limit - 0.5, 0, 0),
+		Vector3D(-limit, 0, 0)
+	};
+
+	PointCompactHashGridSearcher3 searcher(1.0);
+	searcher.Build(points.Accessor());
+	EXPECT_EQ(2u, searcher.GetNumberOfOccupiedBuckets());
+
+	// Search boxes beyond the range neither wrap onto distant buckets nor
+	// miss the points inside of it.
+	EXPECT_TRUE(searcher.HasNearbyPoint(Vector3D(limit + 2.0, 0, 0), 3.0));
+	EXPECT_FALSE(searcher.HasNearbyPoint(Vector3D(3.0 * limit - 0.5, 0, 0), 1.0));
+	EXPECT_FALSE(searcher.HasNearbyPoint(Vector3D(-limit - 2.0, 0, 0), 1.0));
+
+	// A point whose bucket coordinate would wrap around is rejected.
+	for (const Vector3D& outsidePoint : { Vector3D(limit, 0, 0), Vector3D(0, -limit - 0.5, 0), Vector3D(0, 0, 1e30) })
+	{
+		points.Append(outsidePoint);
+		EXPECT_THROW(searcher.Build(points.Accessor()), std::invalid_argument);
+		EXPECT_EQ(0u, searcher.GetNumberOfOccupiedBuckets());
+		points.Resize(2);
+	}
+}
+
+TEST(PointCompactHashGridSearcher3, BuildNeighborLists)
+{
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<> dist(-1.0, 1.0);
+
+	Array1<Vector3D> points;
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		points.Append(Vector3D(dist(rng), dist(rng), dist(rng)));
+	}
+
+	const double radius = 0.1;
+
+	for (const double gridSpacing : { 2.0 * radius, 0.7 * radius })
+	{
+		PointCompactHashGridSearcher3 searcher(gridSpacing);
+		searcher.Build(points.Accessor());
+
+		std::vector<std::vector<size_t>> neighborLists;
+		searcher.BuildNeighborLists(points.ConstAccessor(), radius, &neighborLists);
+
+		EXPECT_EQ(points.size(), neighborLists.size());
+
+		for (size_t i = 0; i < points.size(); ++i)
+		{
+			std::vector<size_t> expected;
+			for (size_t j = 0; j < points.size(); ++j)
+			{
+				if (i != j && points[i].DistanceTo(points[j]) <= radius)
+				{
+					expected.push_back(j);
+				}
+			}
+
+			std::vector<size_t> actual = neighborLists[i];
+			std::sort(actual.begin(), actual.end());
+
+			EXPECT_EQ(expected, actual);
+
+			std::vector<size_t> nearby;
+			searcher.ForEachNearbyPoint(points[i], radius, [&](size_t j, const Vector3D&)
+			{
+				if (i != j)
+				{
+					nearby.push_back(j);
+				}
+			});
+			std::sort(nearby.begin(), nearby.end());
+
+			EXPECT_EQ(expected, nearby);
+		}
+	}
+}
+
+TEST(PointCompactHashGridSearcher3, Serialization)
+{
+	Array1<Vector3D> points =
+	{
+		Vector3D(0, 1, 3),
+		Vector3D(2, 5, 4),
+		Vector3D(-1, 3, 0)
+	};
+
+	PointCompactHashGridSearcher3 searcher(std::sqrt(10));
+	searcher.Build(points.Accessor());
+
+	std::vector<uint8_t> buffer;
+	searcher.Serialize(&buffer);
+
+	PointCompactHashGridSearcher3 searcher2(1.0);
+	searcher2.Deserialize(buffer);
+
+	EXPECT_EQ(searcher.SortedIndices(), searcher2.SortedIndices());
+	EXPECT_EQ(searcher.GetNumberOfOccupiedBuckets(), searcher2.GetNumberOfOccupiedBuckets());
+
+	int cnt = 0;
+	searcher2.ForEachNearbyPoint(
+		Vector3D(0, 0, 0), std::sqrt(10.0),
+		[&](size_t i, const Vector3D& pt)
+	{
+		EXPECT_TRUE(i == 0 || i == 2);
+		EXPECT_EQ(points[i], pt);
+
+		++cnt;
+	});
+
+	EXPECT_EQ(2, cnt);
+}
+
+TEST(PointCompactHashGridSearcher3, Factory)
+{
+	auto searcher = Factory::BuildPointNeighborSearcher3("PointCompactHashGridSearcher3");
+
+	EXPECT_NE(nullptr, searcher);
+	EXPECT_EQ("PointCompactHashGridSearcher3", searcher->TypeName());
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "pch.h"
+
+#include <Core/Searcher/PointHierarchicalHashGridSearcher3.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace CubbyFlow;
+
+TEST(PointHierarchicalHashGridSearcher3, ForEachNearbyPoint)
+{
+	Array1<Vector3D> points =
+	{
+		Vector3D(0, 0, 0),
+		Vector3D(1.5, 0, 0),
+		Vector3D(0, 3, 0),
+		Vector3D(0, 0, -10)
+	};
+	Array1<double> radii = { 1.0, 2.0, 4.0, 1.0 };
+
+	PointHierarchicalHashGridSearcher3 searcher;
+	searcher.Build(points.ConstAccessor(), radii.ConstAccessor());
+
+	EXPECT_EQ(3u, searcher.GetNumberOfLevels());
+	EXPECT_EQ(2u, searcher.GetNumberOfPointsAt(0));
+	EXPECT_EQ(1u, searcher.GetNumberOfPointsAt(1));
+	EXPECT_EQ(1u, searcher.GetNumberOfPointsAt(2));
+
+	// Point 1 is within (1 + 2) / 2 and point 2 is within (1 + 4) / 2.
+	std::vector<size_t> found;
+	searcher.ForEachNearbyPoint(Vector3D(), 1.0, [&](size_t i, const Vector3D& pt)
+	{
+		EXPECT_EQ(points[i], pt);
+		found.push_back(i);
+	});
+
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(std::vector<size_t>({ 0, 1 }), found);
+
+	EXPECT_TRUE(searcher.HasNearbyPoint(Vector3D(0, 5, 0), 1.0));
+	EXPECT_FALSE(searcher.HasNearbyPoint(Vector3D(0, 5.6, 0), 1.0));
+}
+
+TEST(PointHierarchicalHashGridSearcher3, BuildNeighborLists)
+{
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<> positionDist(0.0, 4.0);
+	std::uniform_real_distribution<> radiusDist(0.1, 1.0);
+
+	const size_t numberOfPoints = 1000;
+	Array1<Vector3D> points(numberOfPoints);
+	Array1<double> radii(numberOfPoints);
+
+	for (size_t i = 0; i < numberOfPoints; ++i)
+	{
+		points[i] = Vector3D(positionDist(rng), positionDist(rng), positionDist(rng));
+		radii[i] = radiusDist(rng);
+	}
+
+	PointHierarchicalHashGridSearcher3 searcher;
+	searcher.Build(points.ConstAccessor(), radii.ConstAccessor());
+	EXPECT_EQ(4u, searcher.GetNumberOfLevels());
+
+	std::vector<std::vector<size_t>> neighborLists;
+	searcher.BuildNeighborLists(&neighborLists);
+	ASSERT_EQ(numberOfPoints, neighborLists.size());
+
+	for (size_t i = 0; i < numberOfPoints; ++i)
+	{
+		std::vector<size_t> expected;
+		for (size_t j = 0; j < numberOfPoints; ++j)
+		{
+			if (i != j && points[i].DistanceSquaredTo(points[j]) <= Square(0.5 * (radii[i] + radii[j])))
+			{
+				expected.push_back(j);
+			}
+		}
+
+		std::vector<size_t> actual = neighborLists[i];
+		std::sort(actual.begin(), actual.end());
+		EXPECT_EQ(expected, actual);
+	}
+}
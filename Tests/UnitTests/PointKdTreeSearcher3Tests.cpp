@@ -2,6 +2,10 @@
 
 #include <Core/Searcher/PointKdTreeSearcher3.h>
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+
 using namespace CubbyFlow;
 
 TEST(PointKdTreeSearcher3, ForEachNearbyPoint)
@@ -46,6 +50,91 @@ TEST(PointKdTreeSearcher3, ForEachNearbyPointEmpty)
 	});
 }
 
+TEST(PointKdTreeSearcher3, ForEachNearbyPointManyPoints)
+{
+	std::mt19937 rng{ 0 };
+	std::uniform_real_distribution<> d{ 0.0, 1.0 };
+
+	Array1<Vector3D> points;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		points.Append(Vector3D(d(rng), d(rng), d(rng)));
+	}
+
+	PointKdTreeSearcher3 searcher;
+	searcher.Build(points.Accessor());
+
+	const Vector3D origin(0.5, 0.4, 0.3);
+	const double radius = 0.2;
+
+	std::vector<size_t> found;
+	searcher.ForEachNearbyPoint(origin, radius, [&](size_t i, const Vector3D& pt)
+	{
+		EXPECT_EQ(points[i], pt);
+		found.push_back(i);
+	});
+
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		if (points[i].DistanceTo(origin) <= radius)
+		{
+			expected.push_back(i);
+		}
+	}
+
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(expected, found);
+	EXPECT_TRUE(searcher.HasNearbyPoint(origin, radius));
+	EXPECT_FALSE(searcher.HasNearbyPoint(Vector3D(3, 3, 3), radius));
+}
+
+TEST(PointKdTreeSearcher3, ForEachKNearestPoints)
+{
+	std::mt19937 rng{ 0 };
+	std::uniform_real_distribution<> d{ 0.0, 1.0 };
+
+	Array1<Vector3D> points;
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		points.Append(Vector3D(d(rng), d(rng), d(rng)));
+	}
+
+	PointKdTreeSearcher3 searcher;
+	searcher.Build(points.Accessor());
+
+	const Vector3D origin(0.5, 0.4, 0.3);
+
+	std::vector<size_t> expected(points.size());
+	std::iota(expected.begin(), expected.end(), 0);
+	std::sort(expected.begin(), expected.end(), [&](size_t a, size_t b)
+	{
+		return points[a].DistanceSquaredTo(origin) < points[b].DistanceSquaredTo(origin);
+	});
+	expected.resize(20);
+
+	std::vector<size_t> found;
+	searcher.ForEachKNearestPoints(origin, 20, [&](size_t i, const Vector3D& pt)
+	{
+		EXPECT_EQ(points[i], pt);
+		found.push_back(i);
+	});
+
+	EXPECT_EQ(expected, found);
+
+	// Less points than requested
+	Array1<Vector3D> fewPoints = { Vector3D(0, 1, 3), Vector3D(2, 5, 4), Vector3D(-1, 3, 0) };
+	searcher.Build(fewPoints.Accessor());
+
+	found.clear();
+	searcher.ForEachKNearestPoints(Vector3D(0, 0, 1), 5, [&](size_t i, const Vector3D&)
+	{
+		found.push_back(i);
+	});
+
+	EXPECT_EQ(std::vector<size_t>({ 0, 2, 1 }), found);
+}
+
 TEST(PointKdTreeSearcher3, CopyConstructor)
 {
 	Array1<Vector3D> points = { Vector3D(0, 1, 3), Vector3D(2, 5, 4), Vector3D(-1, 3, 0) };
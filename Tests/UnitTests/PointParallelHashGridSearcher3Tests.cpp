@@ -2,6 +2,9 @@
 
 #include <Core/Searcher/PointParallelHashGridSearcher3.h>
 
+#include <algorithm>
+#include <random>
+
 using namespace CubbyFlow;
 
 TEST(PointParallelHashGridSearcher3, ForEachNearByPoint)
@@ -126,4 +129,50 @@ TEST(PointParallelHashGridSearcher3, Serialization)
 	});
 
 	EXPECT_EQ(2, cnt);
-}
\ No newline at end of file
+}
+
+TEST(PointParallelHashGridSearcher3, BuildNeighborLists)
+{
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<> dist(-1.0, 1.0);
+
+	Array1<Vector3D> points;
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		points.Append(Vector3D(dist(rng), dist(rng), dist(rng)));
+	}
+
+	const double radius = 0.1;
+
+	// Resolution 4 wraps the domain, so distant buckets share the same key.
+	for (const size_t resolution : { 4, 64 })
+	{
+		for (const double gridSpacing : { 2.0 * radius, radius })
+		{
+			PointParallelHashGridSearcher3 searcher(resolution, resolution, resolution, gridSpacing);
+			searcher.Build(points.Accessor());
+
+			std::vector<std::vector<size_t>> neighborLists;
+			searcher.BuildNeighborLists(points.ConstAccessor(), radius, &neighborLists);
+
+			EXPECT_EQ(points.size(), neighborLists.size());
+
+			for (size_t i = 0; i < points.size(); ++i)
+			{
+				std::vector<size_t> expected;
+				for (size_t j = 0; j < points.size(); ++j)
+				{
+					if (i != j && points[i].DistanceTo(points[j]) <= radius)
+					{
+						expected.push_back(j);
+					}
+				}
+
+				std::vector<size_t> actual = neighborLists[i];
+				std::sort(actual.begin(), actual.end());
+
+				EXPECT_EQ(expected, actual);
+			}
+		}
+	}
+}
@@ -0,0 +1,184 @@
+#include "pch.h"
+
+#include <Core/Array/Array1.h>
+#include <Core/Array/Array3.h>
+#include <Core/PointsToImplicit/PointSplatter3.h>
+
+#include <random>
+
+using namespace CubbyFlow;
+
+namespace
+{
+	// Sum of the point weights within the radius of every data point,
+	// gathered point by point in index order.
+	Array3<double> GatherWeights(const Size3& dataSize, const Vector3D& gridSpacing, const Vector3D& dataOrigin,
+		const Array1<Vector3D>& points, double radius)
+	{
+		Array3<double> result(dataSize, -1.0);
+
+		result.ForEachIndex([&](size_t i, size_t j, size_t k)
+		{
+			const Vector3D x = dataOrigin + gridSpacing * Vector3D(static_cast<double>(i), static_cast<double>(j), static_cast<double>(k));
+
+			for (size_t p = 0; p < points.size(); ++p)
+			{
+				if (x.DistanceSquaredTo(points[p]) <= radius * radius)
+				{
+					result(i, j, k) = std::max(result(i, j, k), 0.0) + static_cast<double>(p + 1);
+				}
+			}
+		});
+
+		return result;
+	}
+
+	// Splats the same weights as GatherWeights. Data points without any point
+	// keep -1 if their tile is occupied; data points of empty tiles keep -2.
+	Array3<double> SplatWeights(const PointSplatter3& splatter, const Size3& dataSize)
+	{
+		Array3<double> result(dataSize, -2.0);
+
+		splatter.Splat(-1.0,
+			[&](double& value, size_t pointIndex, const Vector3D&, double)
+		{
+			value = std::max(value, 0.0) + static_cast<double>(pointIndex + 1);
+		},
+			[&](size_t i, size_t j, size_t k, double value)
+		{
+			result(i, j, k) = value;
+		});
+
+		return result;
+	}
+}
+
+TEST(PointSplatter3, TileBoundaries)
+{
+	const Size3 dataSize(20, 18, 17);
+	const Vector3D gridSpacing(0.5, 0.5, 0.5);
+	const Vector3D dataOrigin(-1.0, 0.25, 0.0);
+	const double radius = 1.1;
+
+	// Points on tile boundaries, on the grid boundaries, and outside of the
+	// grid with and without overlapping data points.
+	const Array1<Vector3D> points =
+	{
+		dataOrigin + gridSpacing * Vector3D(8, 8, 8),
+		dataOrigin + gridSpacing * Vector3D(7.5, 8, 15.5),
+		dataOrigin + gridSpacing * Vector3D(16, 0, 0),
+		dataOrigin + gridSpacing * Vector3D(19, 17, 16),
+		dataOrigin + gridSpacing * Vector3D(-1, 4, 4),
+		dataOrigin + gridSpacing * Vector3D(22, 4, 4),
+		dataOrigin + gridSpacing * Vector3D(8, -3, 8)
+	};
+
+	PointSplatter3 splatter(dataSize, gridSpacing, dataOrigin, 8);
+	splatter.Build(points.ConstAccessor(), radius);
+
+	const Array3<double> expected = GatherWeights(dataSize, gridSpacing, dataOrigin, points, radius);
+	const Array3<double> actual = SplatWeights(splatter, dataSize);
+
+	actual.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		if (actual(i, j, k) != -2.0)
+		{
+			EXPECT_EQ(expected(i, j, k), actual(i, j, k)) << i << ", " << j << ", " << k;
+		}
+		else
+		{
+			EXPECT_EQ(-1.0, expected(i, j, k)) << i << ", " << j << ", " << k;
+		}
+	});
+}
+
+TEST(PointSplatter3, EmptyTiles)
+{
+	const Size3 dataSize(32, 32, 32);
+	const Vector3D gridSpacing(1.0, 1.0, 1.0);
+
+	const Array1<Vector3D> points = { Vector3D(3, 4, 5), Vector3D(4, 4, 4) };
+
+	PointSplatter3 splatter(dataSize, gridSpacing, Vector3D(), 8);
+
+	splatter.Build(Array1<Vector3D>().ConstAccessor(), 2.0);
+	EXPECT_EQ(0u, splatter.GetNumberOfOccupiedTiles());
+
+	size_t numberOfVisits = 0;
+	splatter.Splat(0.0, [](double&, size_t, const Vector3D&, double) {},
+		[&](size_t, size_t, size_t, double) { ++numberOfVisits; });
+	EXPECT_EQ(0u, numberOfVisits);
+
+	splatter.Build(points.ConstAccessor(), 2.0);
+	EXPECT_EQ(1u, splatter.GetNumberOfOccupiedTiles());
+
+	const Array3<double> actual = SplatWeights(splatter, dataSize);
+	actual.ForEachIndex([&](size_t i, size_t j, size_t k)
+	{
+		if (i < 8 && j < 8 && k < 8)
+		{
+			EXPECT_NE(-2.0, actual(i, j, k));
+		}
+		else
+		{
+			EXPECT_EQ(-2.0, actual(i, j, k));
+		}
+	});
+
+	// Points entirely outside of the grid do not occupy any tile.
+	const Array1<Vector3D> outsidePoints = { Vector3D(-5, 4, 4), Vector3D(4, 40, 4) };
+	splatter.Build(outsidePoints.ConstAccessor(), 2.0);
+	EXPECT_EQ(0u, splatter.GetNumberOfOccupiedTiles());
+}
+
+TEST(PointSplatter3, NumberOfThreads)
+{
+	const Size3 dataSize(40, 30, 20);
+	const Vector3D gridSpacing(0.1, 0.1, 0.1);
+
+	std::mt19937 rng;
+	std::uniform_real_distribution<> d(-0.2, 4.2);
+
+	Array1<Vector3D> points(5000);
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		points[i] = Vector3D(d(rng), 0.75 * d(rng), 0.5 * d(rng));
+	}
+
+	// The sum is not associative in floating point, so identical results
+	// require the same visiting order with any number of threads.
+	const auto splat = [&](unsigned int numberOfThreads)
+	{
+		SetMaxNumberOfThreads(numberOfThreads);
+
+		PointSplatter3 splatter(dataSize, gridSpacing, Vector3D(), 6);
+		splatter.Build(points.ConstAccessor(), 0.25);
+
+		Array3<double> result(dataSize, 0.0);
+		splatter.Splat(0.0,
+			[&](double& value, size_t pointIndex, const Vector3D&, double distanceSquared)
+		{
+			value = 0.5 * value + points[pointIndex].x * distanceSquared;
+		},
+			[&](size_t i, size_t j, size_t k, double value)
+		{
+			result(i, j, k) = value;
+		});
+
+		return result;
+	};
+
+	const unsigned int numThreads = GetMaxNumberOfThreads();
+
+	const Array3<double> expected = splat(1);
+	for (unsigned int n : { 2u, 3u, 8u })
+	{
+		const Array3<double> actual = splat(n);
+		expected.ForEachIndex([&](size_t i, size_t j, size_t k)
+		{
+			EXPECT_EQ(expected(i, j, k), actual(i, j, k));
+		});
+	}
+
+	SetMaxNumberOfThreads(numThreads);
+}
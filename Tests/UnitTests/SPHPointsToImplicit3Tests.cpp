@@ -0,0 +1,44 @@
+#include "pch.h"
+
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/PointsToImplicit/SPHPointsToImplicit3.h>
+#include <Core/SPH/SPHSystemData3.h>
+
+#include <random>
+
+using namespace CubbyFlow;
+
+TEST(SPHPointsToImplicit3, GatherEquivalence)
+{
+	const double kernelRadius = 0.1;
+	const double cutOffDensity = 0.5;
+
+	std::mt19937 rng;
+	std::uniform_real_distribution<> d(0.2, 0.8);
+
+	Array1<Vector3D> points(300);
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		points[i] = Vector3D(d(rng), d(rng), d(rng));
+	}
+
+	CellCenteredScalarGrid3 output(Size3(24, 24, 24), Vector3D(1.0 / 24, 1.0 / 24, 1.0 / 24));
+	SPHPointsToImplicit3 converter(kernelRadius, cutOffDensity, false);
+	converter.Convert(points.ConstAccessor(), &output);
+
+	// SPH interpolation of a constant field at every data point.
+	SPHSystemData3 sphParticles;
+	sphParticles.AddParticles(points.ConstAccessor());
+	sphParticles.SetKernelRadius(kernelRadius);
+	sphParticles.BuildNeighborSearcher();
+	sphParticles.UpdateDensities();
+
+	const Array1<double> constData(sphParticles.GetNumberOfParticles(), 1.0);
+	const auto pos = output.GetDataPosition();
+
+	output.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		const double expected = cutOffDensity - sphParticles.Interpolate(pos(i, j, k), constData.ConstAccessor());
+		EXPECT_NEAR(expected, output(i, j, k), 1e-12);
+	});
+}
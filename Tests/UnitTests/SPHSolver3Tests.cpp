@@ -57,4 +57,94 @@ TEST(SPHSolver3, Parameters)
 	EXPECT_DOUBLE_EQ(0.0, solver.GetTimeStepLimitScale());
 
 	EXPECT_TRUE(solver.GetSPHSystemData() != nullptr);
-}
\ No newline at end of file
+}
+
+TEST(SPHSolver3, NeighborListSkin)
+{
+	Array1<Vector3D> points;
+	for (size_t k = 0; k < 8; ++k)
+	{
+		for (size_t j = 0; j < 8; ++j)
+		{
+			for (size_t i = 0; i < 8; ++i)
+			{
+				points.Append(Vector3D(0.1 * i + 0.01 * (j % 3), 0.1 * j, 0.1 * k + 0.01 * (i % 2)));
+			}
+		}
+	}
+
+	SPHSolver3 reference(1000.0, 0.1, 1.8);
+	reference.GetSPHSystemData()->AddParticles(points);
+
+	SPHSolver3 solver(1000.0, 0.1, 1.8);
+	solver.GetSPHSystemData()->AddParticles(points);
+
+	EXPECT_DOUBLE_EQ(0.0, solver.GetNeighborListSkin());
+	solver.SetNeighborListSkin(-1.0);
+	EXPECT_DOUBLE_EQ(0.0, solver.GetNeighborListSkin());
+	solver.SetNeighborListSkin(0.05);
+	EXPECT_DOUBLE_EQ(0.05, solver.GetNeighborListSkin());
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 5; ++frame)
+	{
+		reference.Update(frame);
+		solver.Update(frame);
+	}
+
+	auto x0 = reference.GetSPHSystemData()->GetPositions();
+	auto x1 = solver.GetSPHSystemData()->GetPositions();
+	auto d0 = reference.GetSPHSystemData()->GetDensities();
+	auto d1 = solver.GetSPHSystemData()->GetDensities();
+
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		EXPECT_NEAR(x0[i].x, x1[i].x, 1e-9);
+		EXPECT_NEAR(x0[i].y, x1[i].y, 1e-9);
+		EXPECT_NEAR(x0[i].z, x1[i].z, 1e-9);
+		EXPECT_NEAR(d0[i], d1[i], 1e-6);
+	}
+}
+
+TEST(SPHSolver3, CellTiling)
+{
+	Array1<Vector3D> points;
+	for (size_t k = 0; k < 8; ++k)
+	{
+		for (size_t j = 0; j < 8; ++j)
+		{
+			for (size_t i = 0; i < 8; ++i)
+			{
+				points.Append(Vector3D(0.1 * i + 0.01 * (j % 3), 0.1 * j, 0.1 * k + 0.01 * (i % 2)));
+			}
+		}
+	}
+
+	SPHSolver3 reference(1000.0, 0.1, 1.8);
+	reference.GetSPHSystemData()->AddParticles(points);
+
+	SPHSolver3 solver(1000.0, 0.1, 1.8);
+	solver.GetSPHSystemData()->AddParticles(points);
+
+	EXPECT_FALSE(solver.GetIsUsingCellTiling());
+	solver.SetIsUsingCellTiling(true);
+	EXPECT_TRUE(solver.GetIsUsingCellTiling());
+
+	for (Frame frame(0, 1.0 / 60.0); frame.index < 5; ++frame)
+	{
+		reference.Update(frame);
+		solver.Update(frame);
+	}
+
+	auto x0 = reference.GetSPHSystemData()->GetPositions();
+	auto x1 = solver.GetSPHSystemData()->GetPositions();
+	auto d0 = reference.GetSPHSystemData()->GetDensities();
+	auto d1 = solver.GetSPHSystemData()->GetDensities();
+
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		EXPECT_NEAR(x0[i].x, x1[i].x, 1e-9);
+		EXPECT_NEAR(x0[i].y, x1[i].y, 1e-9);
+		EXPECT_NEAR(x0[i].z, x1[i].z, 1e-9);
+		EXPECT_NEAR(d0[i], d1[i], 1e-6);
+	}
+}
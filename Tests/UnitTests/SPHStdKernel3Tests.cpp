@@ -56,6 +56,31 @@ TEST(SPHStdKernel3, Gradient)
 	EXPECT_EQ(value1, value2);
 }
 
+TEST(SPHStdKernel3, BatchFunctions)
+{
+	SPHStdKernel3 kernel(10.0);
+
+	const double distances[] = { 0.0, 1.0, 4.5, 9.9, 10.0, 12.0, 3.0 };
+	const size_t count = sizeof(distances) / sizeof(distances[0]);
+	double distancesSquared[count], values[count], firstDerivatives[count], secondDerivatives[count];
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		distancesSquared[i] = distances[i] * distances[i];
+	}
+
+	kernel.BatchValuesFromSquared(distancesSquared, values, count);
+	kernel.BatchFirstDerivatives(distances, firstDerivatives, count);
+	kernel.BatchSecondDerivativesFromSquared(distancesSquared, secondDerivatives, count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		EXPECT_NEAR(kernel(distances[i]), values[i], 1e-15);
+		EXPECT_NEAR(kernel.FirstDerivative(distances[i]), firstDerivatives[i], 1e-15);
+		EXPECT_NEAR(kernel.SecondDerivative(distances[i]), secondDerivatives[i], 1e-15);
+	}
+}
+
 TEST(SPHSpikyKernel3, Constructors)
 {
 	SPHSpikyKernel3 kernel;
@@ -116,4 +141,24 @@ TEST(SPHSpikyKernel3, SecondDerivative)
 	double value2 = kernel.SecondDerivative(10.0);
 	EXPECT_LT(value1, value0);
 	EXPECT_LT(value2, value1);
+}
+
+TEST(SPHSpikyKernel3, BatchFunctions)
+{
+	SPHSpikyKernel3 kernel(10.0);
+
+	const double distances[] = { 0.0, 1.0, 4.5, 9.9, 10.0, 12.0, 3.0 };
+	const size_t count = sizeof(distances) / sizeof(distances[0]);
+	double values[count], firstDerivatives[count], secondDerivatives[count];
+
+	kernel.BatchValues(distances, values, count);
+	kernel.BatchFirstDerivatives(distances, firstDerivatives, count);
+	kernel.BatchSecondDerivatives(distances, secondDerivatives, count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		EXPECT_NEAR(kernel(distances[i]), values[i], 1e-15);
+		EXPECT_NEAR(kernel.FirstDerivative(distances[i]), firstDerivatives[i], 1e-15);
+		EXPECT_NEAR(kernel.SecondDerivative(distances[i]), secondDerivatives[i], 1e-15);
+	}
 }
\ No newline at end of file
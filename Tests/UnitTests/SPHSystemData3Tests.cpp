@@ -2,6 +2,8 @@
 
 #include <Core/SPH/SPHSystemData3.h>
 
+#include <algorithm>
+
 using namespace CubbyFlow;
 
 TEST(SPHSystemData3, Parameters)
@@ -56,6 +58,73 @@ TEST(SPHSystemData3, Particles)
 	EXPECT_GT(1.0, midVal);
 }
 
+TEST(SPHSystemData3, AdaptiveKernel)
+{
+	SPHSystemData3 data;
+	data.SetTargetSpacing(0.1);
+
+	Array1<Vector3D> positions;
+	for (size_t k = 0; k < 6; ++k)
+	{
+		for (size_t j = 0; j < 6; ++j)
+		{
+			for (size_t i = 0; i < 6; ++i)
+			{
+				positions.Append(0.1 * Vector3D(static_cast<double>(i), static_cast<double>(j), static_cast<double>(k)));
+			}
+		}
+	}
+
+	data.AddParticles(positions.ConstAccessor());
+	data.BuildNeighborSearcher();
+	data.BuildNeighborLists();
+	data.UpdateDensities();
+
+	std::vector<double> uniformDensities(data.GetDensities().begin(), data.GetDensities().end());
+
+	// Zero smoothing lengths fall back to the kernel radius, which has to
+	// match the uniform kernel.
+	data.SetIsUsingAdaptiveKernel(true);
+	EXPECT_DOUBLE_EQ(data.GetKernelRadius(), data.GetSmoothingLengthAt(0));
+	EXPECT_DOUBLE_EQ(data.GetMass(), data.GetMassAt(0));
+
+	data.BuildNeighborSearcher();
+	data.BuildNeighborLists();
+	data.UpdateDensities();
+
+	for (size_t i = 0; i < data.GetNumberOfParticles(); ++i)
+	{
+		EXPECT_NEAR(uniformDensities[i], data.GetDensities()[i], 1e-9 * uniformDensities[i]);
+	}
+
+	// Halving a smoothing length makes the particle 8x lighter.
+	auto h = data.GetSmoothingLengths();
+	h[0] = 0.5 * data.GetKernelRadius();
+	EXPECT_DOUBLE_EQ(data.GetMass() / 8.0, data.GetMassAt(0));
+
+	data.BuildNeighborSearcher();
+	data.BuildNeighborLists();
+	data.UpdateDensities();
+
+	const auto& neighborLists = data.GetNeighborLists();
+	for (size_t i = 0; i < neighborLists.size(); ++i)
+	{
+		for (size_t j : neighborLists[i])
+		{
+			const auto& neighbors = neighborLists[j];
+			EXPECT_NE(neighbors.end(), std::find(neighbors.begin(), neighbors.end(), i));
+		}
+	}
+
+	std::vector<double> densities(data.GetDensities().begin(), data.GetDensities().end());
+	data.UpdateDensitiesFromNeighborLists();
+
+	for (size_t i = 0; i < data.GetNumberOfParticles(); ++i)
+	{
+		EXPECT_NEAR(densities[i], data.GetDensities()[i], 1e-9 * densities[i]);
+	}
+}
+
 TEST(SPHSystemData3, Serialization)
 {
 	SPHSystemData3 data;
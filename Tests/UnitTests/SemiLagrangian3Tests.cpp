@@ -0,0 +1,78 @@
+#include "pch.h"
+
+#include <Core/Field/CustomScalarField3.h>
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/Grid/FaceCenteredGrid3.h>
+#include <Core/SemiLagrangian/SemiLagrangian3.h>
+
+using namespace CubbyFlow;
+
+TEST(SemiLagrangian3, BackTraceCache)
+{
+	CellCenteredScalarGrid3 density(16, 16, 16, 1.0 / 16.0, 1.0 / 16.0, 1.0 / 16.0);
+	CellCenteredScalarGrid3 temperature(density);
+	FaceCenteredGrid3 vector(16, 16, 16, 1.0 / 16.0, 1.0 / 16.0, 1.0 / 16.0);
+
+	density.Fill([](const Vector3D& pt) { return pt.x * pt.y; });
+	temperature.Fill([](const Vector3D& pt) { return std::sin(4.0 * pt.z); });
+	vector.Fill([](const Vector3D& pt) { return Vector3D(pt.y, pt.z, pt.x); });
+
+	FaceCenteredGrid3 flow(16, 16, 16, 1.0 / 16.0, 1.0 / 16.0, 1.0 / 16.0);
+	flow.Fill([](const Vector3D& pt) { return Vector3D(0.5 - pt.y, pt.x - 0.5, 0.2); });
+
+	CustomScalarField3 boundarySDF([](const Vector3D& pt)
+	{
+		return pt.DistanceTo(Vector3D(0.5, 0.5, 0.5)) - 0.1;
+	});
+
+	SemiLagrangian3 solver;
+	SemiLagrangian3 cachedSolver;
+	cachedSolver.SetIsUsingBackTraceCache(true);
+	EXPECT_TRUE(cachedSolver.GetIsUsingBackTraceCache());
+
+	// The cached solver gives the same results for every field.
+	for (const auto* input : { &density, &temperature })
+	{
+		CellCenteredScalarGrid3 expected(*input);
+		CellCenteredScalarGrid3 actual(*input);
+		solver.Advect(*input, flow, 0.1, &expected, boundarySDF);
+		cachedSolver.Advect(*input, flow, 0.1, &actual, boundarySDF);
+
+		expected.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+		{
+			EXPECT_DOUBLE_EQ(expected(i, j, k), actual(i, j, k));
+		});
+	}
+
+	FaceCenteredGrid3 expected(vector);
+	FaceCenteredGrid3 actual(vector);
+	solver.Advect(vector, flow, 0.1, &expected, boundarySDF);
+	cachedSolver.Advect(vector, flow, 0.1, &actual, boundarySDF);
+
+	expected.ForEachUIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_DOUBLE_EQ(expected.GetU(i, j, k), actual.GetU(i, j, k));
+	});
+	expected.ForEachVIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_DOUBLE_EQ(expected.GetV(i, j, k), actual.GetV(i, j, k));
+	});
+	expected.ForEachWIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_DOUBLE_EQ(expected.GetW(i, j, k), actual.GetW(i, j, k));
+	});
+
+	// The flow changes, so the cache should be cleared.
+	flow.Fill(Vector3D(1.0, 0.0, 0.0));
+	cachedSolver.ClearBackTraceCache();
+
+	CellCenteredScalarGrid3 expectedDensity(density);
+	CellCenteredScalarGrid3 actualDensity(density);
+	solver.Advect(density, flow, 0.1, &expectedDensity, boundarySDF);
+	cachedSolver.Advect(density, flow, 0.1, &actualDensity, boundarySDF);
+
+	expectedDensity.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		EXPECT_DOUBLE_EQ(expectedDensity(i, j, k), actualDensity(i, j, k));
+	});
+}
@@ -0,0 +1,58 @@
+#include "pch.h"
+
+#include <Core/Grid/CellCenteredScalarGrid3.h>
+#include <Core/Particle/ParticleSystemData3.h>
+#include <Core/PointsToImplicit/ZhuBridsonPointsToImplicit3.h>
+
+#include <random>
+
+using namespace CubbyFlow;
+
+TEST(ZhuBridsonPointsToImplicit3, GatherEquivalence)
+{
+	const double kernelRadius = 0.1;
+	const double cutOffThreshold = 0.25;
+
+	std::mt19937 rng;
+	std::uniform_real_distribution<> d(0.2, 0.8);
+
+	Array1<Vector3D> points(300);
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		points[i] = Vector3D(d(rng), d(rng), d(rng));
+	}
+
+	CellCenteredScalarGrid3 output(Size3(24, 24, 24), Vector3D(1.0 / 24, 1.0 / 24, 1.0 / 24));
+	ZhuBridsonPointsToImplicit3 converter(kernelRadius, cutOffThreshold, false);
+	converter.Convert(points.ConstAccessor(), &output);
+
+	// Weighted average of the neighbors of every data point.
+	ParticleSystemData3 particles;
+	particles.AddParticles(points.ConstAccessor());
+	particles.BuildNeighborSearcher(kernelRadius);
+	const auto neighborSearcher = particles.GetNeighborSearcher();
+	const auto pos = output.GetDataPosition();
+
+	output.ForEachDataPointIndex([&](size_t i, size_t j, size_t k)
+	{
+		const Vector3D x = pos(i, j, k);
+
+		Vector3D xAvg;
+		double wSum = 0.0;
+		neighborSearcher->ForEachNearbyPoint(x, kernelRadius, [&](size_t, const Vector3D& xi)
+		{
+			const double wi = std::max(0.0, Cubic(1.0 - Square((x - xi).Length() / kernelRadius)));
+			wSum += wi;
+			xAvg += wi * xi;
+		});
+
+		double expected = output.BoundingBox().DiagonalLength();
+		if (wSum > 0.0)
+		{
+			xAvg /= wSum;
+			expected = (x - xAvg).Length() - cutOffThreshold * kernelRadius;
+		}
+
+		EXPECT_NEAR(expected, output(i, j, k), 1e-12);
+	});
+}